@@ -0,0 +1,128 @@
+# Copyright 2023 ros2_control Development Team
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Runs the N-joint RRBot at a high update rate to benchmark how ros2_control scales, e.g.
+#   ros2 launch ros2_control_demo_example_1 rrbot_n_joints_benchmark.launch.py num_joints:=2000
+# The hardware logs the read/update/write durations every second and writes them per cycle to
+# timing_log_file when it is deactivated or shut down, i.e. when the launch is stopped.
+
+import os
+import tempfile
+
+import yaml
+
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument, OpaqueFunction, RegisterEventHandler
+from launch.event_handlers import OnShutdown
+from launch.substitutions import Command, LaunchConfiguration, PathSubstitution
+
+from launch_ros.actions import Node
+from launch_ros.substitutions import FindPackageShare
+
+
+def spawn_controllers(context):
+    # the joints of forward_position_controller depend on num_joints, so its parameters are
+    # generated instead of read from a static file
+    num_joints = int(LaunchConfiguration("num_joints").perform(context))
+    controllers = {
+        "joint_state_broadcaster": {
+            "ros__parameters": {
+                "type": "joint_state_broadcaster/JointStateBroadcaster",
+                "update_rate": 100,
+            }
+        },
+        "forward_position_controller": {
+            "ros__parameters": {
+                "type": "forward_command_controller/ForwardCommandController",
+                "joints": [f"joint{i}" for i in range(1, num_joints + 1)],
+                "interface_name": "position",
+            }
+        },
+    }
+    with tempfile.NamedTemporaryFile(
+        "w", prefix="rrbot_n_joints_controllers_", suffix=".yaml", delete=False
+    ) as param_file:
+        yaml.safe_dump(controllers, param_file)
+
+    def remove_param_file(event, context):
+        if os.path.exists(param_file.name):
+            os.unlink(param_file.name)
+
+    return [
+        RegisterEventHandler(OnShutdown(on_shutdown=remove_param_file)),
+        Node(
+            package="controller_manager",
+            executable="spawner",
+            arguments=[
+                "joint_state_broadcaster",
+                "forward_position_controller",
+                "--param-file",
+                param_file.name,
+            ],
+        )
+    ]
+
+
+def generate_launch_description():
+    return LaunchDescription(
+        [
+            DeclareLaunchArgument(
+                "num_joints",
+                default_value="100",
+                description="Number of joints, each with a position command and state interface.",
+            ),
+            DeclareLaunchArgument(
+                "update_rate",
+                default_value="1000",
+                description="Update rate of the controller manager in Hz, e.g. 1000 to 4000.",
+            ),
+            DeclareLaunchArgument(
+                "timing_log_file",
+                default_value="/tmp/rrbot_n_joints_timing.csv",
+                description="CSV file the hardware writes the timing of each cycle to, "
+                "empty to only log a summary.",
+            ),
+            # Control node
+            Node(
+                package="controller_manager",
+                executable="ros2_control_node",
+                parameters=[{"update_rate": LaunchConfiguration("update_rate")}],
+                output="both",
+            ),
+            # robot_state_publisher with robot_description from xacro
+            Node(
+                package="robot_state_publisher",
+                executable="robot_state_publisher",
+                output="both",
+                parameters=[
+                    {
+                        "robot_description": Command(
+                            [
+                                "xacro",
+                                " ",
+                                PathSubstitution(FindPackageShare("ros2_control_demo_example_1"))
+                                / "urdf"
+                                / "rrbot_n_joints.urdf.xacro",
+                                " num_joints:=",
+                                LaunchConfiguration("num_joints"),
+                                " timing_log_file:=",
+                                LaunchConfiguration("timing_log_file"),
+                            ]
+                        )
+                    }
+                ],
+            ),
+            OpaqueFunction(function=spawn_controllers),
+        ]
+    )
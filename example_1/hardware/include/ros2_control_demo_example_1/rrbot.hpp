@@ -15,6 +15,7 @@
 #ifndef ROS2_CONTROL_DEMO_EXAMPLE_1__RRBOT_HPP_
 #define ROS2_CONTROL_DEMO_EXAMPLE_1__RRBOT_HPP_
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -26,6 +27,9 @@
 #include "rclcpp/macros.hpp"
 #include "rclcpp_lifecycle/node_interfaces/lifecycle_node_interface.hpp"
 #include "rclcpp_lifecycle/state.hpp"
+#include "ros2_control_demo_utils/interface_handles.hpp"
+#include "ros2_control_demo_utils/realtime_logger.hpp"
+#include "ros2_control_demo_utils/simulated_actuator_bank.hpp"
 
 namespace ros2_control_demo_example_1
 {
@@ -57,6 +61,15 @@ private:
   double hw_start_sec_;
   double hw_stop_sec_;
   double hw_slowdown_;
+
+  // simulated joints and their position interfaces, in the order of the joints
+  ros2_control_demo_utils::SimulatedActuatorBank actuators_;
+  std::vector<ros2_control_demo_utils::StateHandle> position_states_;
+  std::vector<ros2_control_demo_utils::CommandHandle> position_commands_;
+
+  ros2_control_demo_utils::RealtimeLogger rt_logger_;
+  ros2_control_demo_utils::LogThrottle read_log_throttle_{std::chrono::milliseconds(500)};
+  ros2_control_demo_utils::LogThrottle write_log_throttle_{std::chrono::milliseconds(500)};
 };
 
 }  // namespace ros2_control_demo_example_1
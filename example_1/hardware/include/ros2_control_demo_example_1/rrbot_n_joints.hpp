@@ -0,0 +1,109 @@
+// Copyright 2020 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS2_CONTROL_DEMO_EXAMPLE_1__RRBOT_N_JOINTS_HPP_
+#define ROS2_CONTROL_DEMO_EXAMPLE_1__RRBOT_N_JOINTS_HPP_
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "hardware_interface/handle.hpp"
+#include "hardware_interface/hardware_info.hpp"
+#include "hardware_interface/system_interface.hpp"
+#include "hardware_interface/types/hardware_interface_return_values.hpp"
+#include "rclcpp/macros.hpp"
+#include "rclcpp_lifecycle/node_interfaces/lifecycle_node_interface.hpp"
+#include "rclcpp_lifecycle/state.hpp"
+#include "ros2_control_demo_utils/interface_handles.hpp"
+#include "ros2_control_demo_utils/realtime_logger.hpp"
+#include "ros2_control_demo_utils/simulated_actuator_bank.hpp"
+
+namespace ros2_control_demo_example_1
+{
+/**
+ * RRBotSystemPositionOnlyHardware for any number of joints, to benchmark how the resource manager
+ * and the controllers scale.
+ *
+ * It doesn't log the joints and doesn't wait on activation. Instead it measures every control
+ * cycle: how long read() and write() take, and the time between them, which the controller
+ * manager spends updating the controllers. The durations are kept in a buffer allocated in
+ * on_init() and written as CSV to the file given by the "timing_log_file" parameter on
+ * deactivation or shutdown.
+ */
+class RRBotSystemNJointsHardware : public hardware_interface::SystemInterface
+{
+public:
+  RCLCPP_SHARED_PTR_DEFINITIONS(RRBotSystemNJointsHardware)
+
+  hardware_interface::CallbackReturn on_init(
+    const hardware_interface::HardwareComponentInterfaceParams & params) override;
+
+  hardware_interface::CallbackReturn on_configure(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  hardware_interface::CallbackReturn on_activate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  hardware_interface::CallbackReturn on_deactivate(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  hardware_interface::CallbackReturn on_shutdown(
+    const rclcpp_lifecycle::State & previous_state) override;
+
+  hardware_interface::return_type read(
+    const rclcpp::Time & time, const rclcpp::Duration & period) override;
+
+  hardware_interface::return_type write(
+    const rclcpp::Time & time, const rclcpp::Duration & period) override;
+
+private:
+  /// Durations of one control cycle in seconds.
+  struct CycleTiming
+  {
+    double period;
+    double read;
+    double update;
+    double write;
+  };
+
+  /**
+   * Writes the recorded cycles to timing_log_file_, logs a summary and drops them, so they are
+   * only saved once. Not realtime safe.
+   */
+  void save_timings();
+
+  // Parameters for the RRBot simulation
+  double hw_slowdown_;
+
+  // simulated joints and their position interfaces, in the order of the joints
+  ros2_control_demo_utils::SimulatedActuatorBank actuators_;
+  std::vector<ros2_control_demo_utils::StateHandle> position_states_;
+  std::vector<ros2_control_demo_utils::CommandHandle> position_commands_;
+
+  std::string timing_log_file_;
+  std::vector<CycleTiming> timings_;
+  size_t num_timings_ = 0;
+  std::chrono::steady_clock::time_point read_begin_;
+  std::chrono::steady_clock::time_point read_end_;
+  std::chrono::steady_clock::time_point previous_read_begin_;
+
+  ros2_control_demo_utils::RealtimeLogger rt_logger_;
+  ros2_control_demo_utils::LogThrottle timing_log_throttle_{std::chrono::milliseconds(1000)};
+};
+
+}  // namespace ros2_control_demo_example_1
+
+#endif  // ROS2_CONTROL_DEMO_EXAMPLE_1__RRBOT_N_JOINTS_HPP_
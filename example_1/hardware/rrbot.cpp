@@ -16,10 +16,8 @@
 
 #include <chrono>
 #include <cmath>
-#include <iomanip>
 #include <limits>
 #include <memory>
-#include <sstream>
 #include <string>
 #include <vector>
 
@@ -38,6 +36,9 @@ hardware_interface::CallbackReturn RRBotSystemPositionOnlyHardware::on_init(
     return hardware_interface::CallbackReturn::ERROR;
   }
 
+  // log messages of read() and write() are formatted outside of the realtime loop
+  rt_logger_.configure(get_logger());
+
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
   hw_start_sec_ = stod(info_.hardware_parameters["example_param_hw_start_duration_sec"]);
   hw_stop_sec_ = stod(info_.hardware_parameters["example_param_hw_stop_duration_sec"]);
@@ -107,6 +108,28 @@ hardware_interface::CallbackReturn RRBotSystemPositionOnlyHardware::on_configure
   {
     set_command(name, 0.0);
   }
+
+  // the simulation steps all joints at once, on interfaces looked up here
+  ros2_control_demo_utils::HandleResolver resolver;
+  resolver.add_states(joint_states_);
+  resolver.add_commands(joint_commands_);
+  position_states_.resize(info_.joints.size());
+  position_commands_.resize(info_.joints.size());
+  for (size_t i = 0; i < info_.joints.size(); i++)
+  {
+    const auto name = info_.joints[i].name + "/" + hardware_interface::HW_IF_POSITION;
+    if (
+      !resolver.resolve_state(name, position_states_[i]) ||
+      !resolver.resolve_command(name, position_commands_[i]))
+    {
+      RCLCPP_FATAL(
+        get_logger(), "Failed to look up the position interfaces of joint '%s'.",
+        info_.joints[i].name.c_str());
+      return hardware_interface::CallbackReturn::ERROR;
+    }
+  }
+  actuators_.resize(info_.joints.size(), hw_slowdown_);
+
   RCLCPP_INFO(get_logger(), "Successfully configured!");
 
   return hardware_interface::CallbackReturn::SUCCESS;
@@ -155,21 +178,24 @@ hardware_interface::CallbackReturn RRBotSystemPositionOnlyHardware::on_deactivat
 }
 
 hardware_interface::return_type RRBotSystemPositionOnlyHardware::read(
-  const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
+  const rclcpp::Time & /*time*/, const rclcpp::Duration & period)
 {
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
-  std::stringstream ss;
-  ss << "Reading states:";
+  // Simulate RRBot's movement
+  actuators_.read_commands(position_commands_);
+  actuators_.step(period.seconds());
+  actuators_.write_positions(position_states_);
 
-  for (const auto & [name, descr] : joint_state_interfaces_)
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, read_log_throttle_);
+  if (record)
   {
-    // Simulate RRBot's movement
-    auto new_value = get_state(name) + (get_command(name) - get_state(name)) / hw_slowdown_;
-    set_state(name, new_value);
-    ss << std::fixed << std::setprecision(2) << std::endl
-       << "\t" << get_state(name) << " for joint '" << name << "'";
+    record.append("Reading states:");
+    for (size_t i = 0; i < position_states_.size(); i++)
+    {
+      record.append(
+        "\n\t%.2f for joint '%s'", actuators_.positions()[i], position_states_[i].name().c_str());
+    }
   }
-  RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 500, "%s", ss.str().c_str());
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   return hardware_interface::return_type::OK;
@@ -179,16 +205,16 @@ hardware_interface::return_type RRBotSystemPositionOnlyHardware::write(
   const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
 {
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
-  std::stringstream ss;
-  ss << "Writing commands:";
-
-  for (const auto & [name, descr] : joint_command_interfaces_)
+  // Simulate sending commands to the hardware, nothing is looked up while the record is throttled
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, write_log_throttle_);
+  if (record)
   {
-    // Simulate sending commands to the hardware
-    ss << std::fixed << std::setprecision(2) << std::endl
-       << "\t" << get_command(name) << " for joint '" << name << "'";
+    record.append("Writing commands:");
+    for (const auto & command : position_commands_)
+    {
+      record.append("\n\t%.2f for joint '%s'", command.get(), command.name().c_str());
+    }
   }
-  RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 500, "%s", ss.str().c_str());
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   return hardware_interface::return_type::OK;
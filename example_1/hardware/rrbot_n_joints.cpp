@@ -0,0 +1,250 @@
+// Copyright 2020 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ros2_control_demo_example_1/rrbot_n_joints.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "hardware_interface/lexical_casts.hpp"
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+namespace
+{
+double seconds(std::chrono::steady_clock::duration duration)
+{
+  return std::chrono::duration<double>(duration).count();
+}
+}  // namespace
+
+namespace ros2_control_demo_example_1
+{
+hardware_interface::CallbackReturn RRBotSystemNJointsHardware::on_init(
+  const hardware_interface::HardwareComponentInterfaceParams & params)
+{
+  if (
+    hardware_interface::SystemInterface::on_init(params) !=
+    hardware_interface::CallbackReturn::SUCCESS)
+  {
+    return hardware_interface::CallbackReturn::ERROR;
+  }
+
+  // the timing summary of write() is formatted outside of the realtime loop
+  rt_logger_.configure(get_logger());
+
+  hw_slowdown_ = hardware_interface::stod(info_.hardware_parameters["example_param_hw_slowdown"]);
+  // an integer has no locale dependent decimal separator
+  timings_.resize(std::stoul(info_.hardware_parameters["timing_log_cycles"]));
+  timing_log_file_ = info_.hardware_parameters["timing_log_file"];
+  RCLCPP_INFO(
+    get_logger(), "Simulating %zu joints, keeping the timing of %zu cycles", info_.joints.size(),
+    timings_.size());
+
+  for (const hardware_interface::ComponentInfo & joint : info_.joints)
+  {
+    // RRBotSystemNJoints has exactly one state and command interface on each joint
+    if (
+      joint.command_interfaces.size() != 1 ||
+      joint.command_interfaces[0].name != hardware_interface::HW_IF_POSITION ||
+      joint.state_interfaces.size() != 1 ||
+      joint.state_interfaces[0].name != hardware_interface::HW_IF_POSITION)
+    {
+      RCLCPP_FATAL(
+        get_logger(), "Joint '%s' needs exactly one '%s' command and state interface.",
+        joint.name.c_str(), hardware_interface::HW_IF_POSITION);
+      return hardware_interface::CallbackReturn::ERROR;
+    }
+  }
+
+  return hardware_interface::CallbackReturn::SUCCESS;
+}
+
+hardware_interface::CallbackReturn RRBotSystemNJointsHardware::on_configure(
+  const rclcpp_lifecycle::State & /*previous_state*/)
+{
+  // reset values always when configuring hardware
+  for (const auto & [name, descr] : joint_state_interfaces_)
+  {
+    set_state(name, 0.0);
+  }
+  for (const auto & [name, descr] : joint_command_interfaces_)
+  {
+    set_command(name, 0.0);
+  }
+
+  // the simulation steps all joints at once, on interfaces looked up here
+  ros2_control_demo_utils::HandleResolver resolver;
+  resolver.add_states(joint_states_);
+  resolver.add_commands(joint_commands_);
+  position_states_.resize(info_.joints.size());
+  position_commands_.resize(info_.joints.size());
+  for (size_t i = 0; i < info_.joints.size(); i++)
+  {
+    const auto name = info_.joints[i].name + "/" + hardware_interface::HW_IF_POSITION;
+    if (
+      !resolver.resolve_state(name, position_states_[i]) ||
+      !resolver.resolve_command(name, position_commands_[i]))
+    {
+      RCLCPP_FATAL(
+        get_logger(), "Failed to look up the position interfaces of joint '%s'.",
+        info_.joints[i].name.c_str());
+      return hardware_interface::CallbackReturn::ERROR;
+    }
+  }
+  actuators_.resize(info_.joints.size(), hw_slowdown_);
+
+  RCLCPP_INFO(get_logger(), "Successfully configured!");
+
+  return hardware_interface::CallbackReturn::SUCCESS;
+}
+
+hardware_interface::CallbackReturn RRBotSystemNJointsHardware::on_activate(
+  const rclcpp_lifecycle::State & /*previous_state*/)
+{
+  // command and state should be equal when starting
+  for (size_t i = 0; i < position_commands_.size(); i++)
+  {
+    position_commands_[i].set(actuators_.positions()[i]);
+  }
+
+  num_timings_ = 0;
+  read_begin_ = {};
+  RCLCPP_INFO(get_logger(), "Successfully activated!");
+
+  return hardware_interface::CallbackReturn::SUCCESS;
+}
+
+hardware_interface::CallbackReturn RRBotSystemNJointsHardware::on_deactivate(
+  const rclcpp_lifecycle::State & /*previous_state*/)
+{
+  save_timings();
+  RCLCPP_INFO(get_logger(), "Successfully deactivated!");
+
+  return hardware_interface::CallbackReturn::SUCCESS;
+}
+
+hardware_interface::CallbackReturn RRBotSystemNJointsHardware::on_shutdown(
+  const rclcpp_lifecycle::State & /*previous_state*/)
+{
+  // an active component is shut down without being deactivated when the controller manager stops
+  save_timings();
+
+  return hardware_interface::CallbackReturn::SUCCESS;
+}
+
+hardware_interface::return_type RRBotSystemNJointsHardware::read(
+  const rclcpp::Time & /*time*/, const rclcpp::Duration & period)
+{
+  previous_read_begin_ = read_begin_;
+  read_begin_ = std::chrono::steady_clock::now();
+
+  // Simulate RRBot's movement towards the commands taken in the last write()
+  actuators_.step(period.seconds());
+  actuators_.write_positions(position_states_);
+
+  read_end_ = std::chrono::steady_clock::now();
+  return hardware_interface::return_type::OK;
+}
+
+hardware_interface::return_type RRBotSystemNJointsHardware::write(
+  const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
+{
+  const auto write_begin = std::chrono::steady_clock::now();
+  // Simulate sending commands to the hardware
+  actuators_.read_commands(position_commands_);
+  const auto write_end = std::chrono::steady_clock::now();
+
+  CycleTiming timing;
+  timing.period = previous_read_begin_ == std::chrono::steady_clock::time_point{}
+                    ? 0.0
+                    : seconds(read_begin_ - previous_read_begin_);
+  timing.read = seconds(read_end_ - read_begin_);
+  timing.update = seconds(write_begin - read_end_);
+  timing.write = seconds(write_end - write_begin);
+  if (num_timings_ < timings_.size())
+  {
+    timings_[num_timings_++] = timing;
+  }
+
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, timing_log_throttle_);
+  record.append(
+    "Cycle of %zu joints: period %.1f us, read %.1f us", position_states_.size(),
+    timing.period * 1e6, timing.read * 1e6);
+  record.append(", update %.1f us, write %.1f us", timing.update * 1e6, timing.write * 1e6);
+
+  return hardware_interface::return_type::OK;
+}
+
+void RRBotSystemNJointsHardware::save_timings()
+{
+  if (num_timings_ == 0)
+  {
+    return;
+  }
+  const size_t cycles = num_timings_;
+  num_timings_ = 0;
+
+  CycleTiming mean{0.0, 0.0, 0.0, 0.0};
+  CycleTiming max{0.0, 0.0, 0.0, 0.0};
+  for (size_t i = 0; i < cycles; i++)
+  {
+    const auto & timing = timings_[i];
+    mean.period += timing.period / static_cast<double>(cycles);
+    mean.read += timing.read / static_cast<double>(cycles);
+    mean.update += timing.update / static_cast<double>(cycles);
+    mean.write += timing.write / static_cast<double>(cycles);
+    max.period = std::max(max.period, timing.period);
+    max.read = std::max(max.read, timing.read);
+    max.update = std::max(max.update, timing.update);
+    max.write = std::max(max.write, timing.write);
+  }
+  RCLCPP_INFO(
+    get_logger(),
+    "%zu cycles of %zu joints [us, mean/max]: period %.1f/%.1f, read %.1f/%.1f, "
+    "update %.1f/%.1f, write %.1f/%.1f",
+    cycles, position_states_.size(), mean.period * 1e6, max.period * 1e6, mean.read * 1e6,
+    max.read * 1e6, mean.update * 1e6, max.update * 1e6, mean.write * 1e6, max.write * 1e6);
+
+  if (timing_log_file_.empty())
+  {
+    return;
+  }
+  std::ofstream file(timing_log_file_);
+  if (!file)
+  {
+    RCLCPP_ERROR(get_logger(), "Can't write the cycle timing to '%s'.", timing_log_file_.c_str());
+    return;
+  }
+  file << "cycle,period_us,read_us,update_us,write_us\n";
+  for (size_t i = 0; i < cycles; i++)
+  {
+    const auto & timing = timings_[i];
+    file << i << ',' << timing.period * 1e6 << ',' << timing.read * 1e6 << ','
+         << timing.update * 1e6 << ',' << timing.write * 1e6 << '\n';
+  }
+  RCLCPP_INFO(
+    get_logger(), "Wrote the timing of %zu cycles to '%s'.", cycles, timing_log_file_.c_str());
+}
+
+}  // namespace ros2_control_demo_example_1
+
+#include "pluginlib/class_list_macros.hpp"
+
+PLUGINLIB_EXPORT_CLASS(
+  ros2_control_demo_example_1::RRBotSystemNJointsHardware, hardware_interface::SystemInterface)
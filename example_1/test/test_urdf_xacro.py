@@ -73,5 +73,42 @@ def test_urdf_xacro():
         os.remove(tmp_urdf_output_file)
 
 
+def test_rrbot_n_joints_urdf_xacro():
+    # enough joints to exceed the recursion limit of xacro if the segments were nested one by one
+    description_file_path = os.path.join(
+        get_package_share_directory("ros2_control_demo_example_1"),
+        "urdf",
+        "rrbot_n_joints.urdf.xacro",
+    )
+
+    _, tmp_urdf_output_file = tempfile.mkstemp(suffix=".urdf")
+
+    xacro_command = (
+        f"{shutil.which('xacro')}"
+        f" {description_file_path} num_joints:=2000"
+        f" > {tmp_urdf_output_file}"
+    )
+    check_urdf_command = f"{shutil.which('check_urdf')} {tmp_urdf_output_file}"
+
+    try:
+        xacro_process = subprocess.run(
+            xacro_command, stdout=subprocess.PIPE, stderr=subprocess.PIPE, shell=True
+        )
+
+        assert xacro_process.returncode == 0, " --- XACRO command failed ---"
+
+        check_urdf_process = subprocess.run(
+            check_urdf_command, stdout=subprocess.PIPE, stderr=subprocess.PIPE, shell=True
+        )
+
+        assert check_urdf_process.returncode == 0, "\n --- URDF check failed! ---"
+        with open(tmp_urdf_output_file) as urdf_file:
+            assert 'name="joint2000"' in urdf_file.read()
+
+    finally:
+        os.remove(tmp_urdf_output_file)
+
+
 if __name__ == "__main__":
     test_urdf_xacro()
+    test_rrbot_n_joints_urdf_xacro()
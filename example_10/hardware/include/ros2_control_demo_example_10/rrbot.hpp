@@ -15,6 +15,7 @@
 #ifndef ROS2_CONTROL_DEMO_EXAMPLE_10__RRBOT_HPP_
 #define ROS2_CONTROL_DEMO_EXAMPLE_10__RRBOT_HPP_
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -26,6 +27,10 @@
 #include "rclcpp/macros.hpp"
 #include "rclcpp_lifecycle/node_interfaces/lifecycle_node_interface.hpp"
 #include "rclcpp_lifecycle/state.hpp"
+#include "ros2_control_demo_utils/interface_handles.hpp"
+#include "ros2_control_demo_utils/realtime_logger.hpp"
+#include "ros2_control_demo_utils/sensor_noise.hpp"
+#include "ros2_control_demo_utils/simulated_actuator_bank.hpp"
 
 namespace ros2_control_demo_example_10
 {
@@ -55,6 +60,21 @@ public:
 private:
   // Parameters for the RRBot simulation
   double hw_slowdown_;
+  uint64_t hw_sensor_noise_seed_;
+
+  // simulated joints and their position interfaces, in the order of the joints
+  ros2_control_demo_utils::SimulatedActuatorBank actuators_;
+  std::vector<ros2_control_demo_utils::StateHandle> position_states_;
+  std::vector<ros2_control_demo_utils::CommandHandle> position_commands_;
+
+  // noisy analog inputs analog_input1 and analog_input2
+  ros2_control_demo_utils::SensorNoise analog_input_noise_;
+  double analog_input_values_[2];
+  std::vector<ros2_control_demo_utils::StateHandle> analog_input_states_;
+
+  ros2_control_demo_utils::RealtimeLogger rt_logger_;
+  ros2_control_demo_utils::LogThrottle read_log_throttle_{std::chrono::milliseconds(500)};
+  ros2_control_demo_utils::LogThrottle write_log_throttle_{std::chrono::milliseconds(500)};
 };
 
 }  // namespace ros2_control_demo_example_10
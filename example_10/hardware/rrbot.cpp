@@ -16,11 +16,8 @@
 
 #include <chrono>
 #include <cmath>
-#include <iomanip>
 #include <limits>
 #include <memory>
-#include <random>
-#include <sstream>
 #include <vector>
 
 #include "hardware_interface/types/hardware_interface_type_values.hpp"
@@ -38,6 +35,14 @@ hardware_interface::CallbackReturn RRBotSystemWithGPIOHardware::on_init(
     return hardware_interface::CallbackReturn::ERROR;
   }
 
+  // log messages of read() and write() are formatted outside of the realtime loop
+  rt_logger_.configure(get_logger());
+
+  // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
+  hw_slowdown_ = stod(info_.hardware_parameters["example_param_hw_slowdown"]);
+  hw_sensor_noise_seed_ = stoull(info_.hardware_parameters["example_param_sensor_noise_seed"]);
+  // END: This part here is for exemplary purposes - Please do not copy to your production code
+
   for (const hardware_interface::ComponentInfo & joint : info_.joints)
   {
     // RRBotSystemPositionOnly has exactly one state and command interface on each joint
@@ -137,6 +142,46 @@ hardware_interface::CallbackReturn RRBotSystemWithGPIOHardware::on_configure(
   {
     set_command(name, 0.0);
   }
+
+  // the simulation steps all joints at once, on interfaces looked up here
+  ros2_control_demo_utils::HandleResolver resolver;
+  resolver.add_states(joint_states_);
+  resolver.add_commands(joint_commands_);
+  position_states_.resize(info_.joints.size());
+  position_commands_.resize(info_.joints.size());
+  for (size_t i = 0; i < info_.joints.size(); i++)
+  {
+    const auto name = info_.joints[i].name + "/" + hardware_interface::HW_IF_POSITION;
+    if (
+      !resolver.resolve_state(name, position_states_[i]) ||
+      !resolver.resolve_command(name, position_commands_[i]))
+    {
+      RCLCPP_FATAL(
+        get_logger(), "Failed to look up the position interfaces of joint '%s'.",
+        info_.joints[i].name.c_str());
+      return hardware_interface::CallbackReturn::ERROR;
+    }
+  }
+  actuators_.resize(info_.joints.size(), hw_slowdown_);
+
+  // the analog inputs read 5 V with noise through a 12 bit converter for 0 to 10 V
+  resolver.add_states(gpio_states_);
+  analog_input_states_.resize(2);
+  for (size_t i = 0; i < analog_input_states_.size(); i++)
+  {
+    const auto name = info_.gpios[0].name + "/" + info_.gpios[0].state_interfaces[i + 1].name;
+    if (!resolver.resolve_state(name, analog_input_states_[i]))
+    {
+      RCLCPP_FATAL(get_logger(), "Failed to look up the analog input '%s'.", name.c_str());
+      return hardware_interface::CallbackReturn::ERROR;
+    }
+  }
+  analog_input_noise_.configure(analog_input_states_.size(), hw_sensor_noise_seed_);
+  for (size_t i = 0; i < analog_input_states_.size(); i++)
+  {
+    analog_input_noise_.set_model(i, {0.5, 0.01, 10.0 / 4096.0});
+  }
+
   RCLCPP_INFO(get_logger(), "Successfully configured!");
 
   return hardware_interface::CallbackReturn::SUCCESS;
@@ -175,18 +220,13 @@ hardware_interface::CallbackReturn RRBotSystemWithGPIOHardware::on_deactivate(
 }
 
 hardware_interface::return_type RRBotSystemWithGPIOHardware::read(
-  const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
+  const rclcpp::Time & /*time*/, const rclcpp::Duration & period)
 {
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
-  std::stringstream ss;
-  ss << "Reading states:";
-
-  for (const auto & [name, descr] : joint_state_interfaces_)
-  {
-    // Simulate RRBot's movement
-    auto new_value = get_state(name) + (get_command(name) - get_state(name)) / hw_slowdown_;
-    set_state(name, new_value);
-  }
+  // Simulate RRBot's movement
+  actuators_.read_commands(position_commands_);
+  actuators_.step(period.seconds());
+  actuators_.write_positions(position_states_);
 
   for (const auto & [name, descr] : gpio_command_interfaces_)
   {
@@ -194,24 +234,25 @@ hardware_interface::return_type RRBotSystemWithGPIOHardware::read(
     set_state(name, get_command(name));
   }
 
-  // random inputs analog_input1 and analog_input2
-  unsigned int seed = static_cast<unsigned int>(time(NULL)) + 1;
-  std::minstd_rand random_generator_1(seed);
-  set_state(
-    info_.gpios[0].name + "/" + info_.gpios[0].state_interfaces[1].name,
-    static_cast<double>(random_generator_1()));
-  seed = static_cast<unsigned int>(time(NULL)) + 2;
-  std::minstd_rand random_generator_2(seed);
-  set_state(
-    info_.gpios[0].name + "/" + info_.gpios[0].state_interfaces[2].name,
-    static_cast<double>(random_generator_2()));
+  // noisy inputs analog_input1 and analog_input2
+  analog_input_values_[0] = 5.0;
+  analog_input_values_[1] = 5.0;
+  analog_input_noise_.apply(analog_input_values_, period.seconds());
+  for (size_t i = 0; i < analog_input_states_.size(); i++)
+  {
+    analog_input_states_[i].set(analog_input_values_[i]);
+  }
 
-  for (const auto & [name, descr] : gpio_state_interfaces_)
+  // the states are only looked up if the record is not throttled
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, read_log_throttle_);
+  if (record)
   {
-    ss << std::fixed << std::setprecision(2) << std::endl
-       << "\t" << get_state(name) << " from GPIO input '" << name << "'";
+    record.append("Reading states:");
+    for (const auto & [name, descr] : gpio_state_interfaces_)
+    {
+      record.append("\n\t%.2f from GPIO input '%s'", get_state(name), name.c_str());
+    }
   }
-  RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 500, "%s", ss.str().c_str());
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   return hardware_interface::return_type::OK;
@@ -221,16 +262,16 @@ hardware_interface::return_type RRBotSystemWithGPIOHardware::write(
   const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
 {
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
-  std::stringstream ss;
-  ss << "Writing commands:";
-
-  for (const auto & [name, descr] : gpio_command_interfaces_)
+  // Simulate sending commands to the hardware, nothing is looked up while the record is throttled
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, write_log_throttle_);
+  if (record)
   {
-    // Simulate sending commands to the hardware
-    ss << std::fixed << std::setprecision(2) << std::endl
-       << "\t" << get_command(name) << " for GPIO output '" << name << "'";
+    record.append("Writing commands:");
+    for (const auto & [name, descr] : gpio_command_interfaces_)
+    {
+      record.append("\n\t%.2f for GPIO output '%s'", get_command(name), name.c_str());
+    }
   }
-  RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 500, "%s", ss.str().c_str());
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   return hardware_interface::return_type::OK;
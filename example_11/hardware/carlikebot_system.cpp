@@ -17,10 +17,8 @@
 #include <chrono>
 #include <cmath>
 #include <cstddef>
-#include <iomanip>
 #include <limits>
 #include <memory>
-#include <sstream>
 #include <vector>
 
 #include "hardware_interface/types/hardware_interface_type_values.hpp"
@@ -38,6 +36,9 @@ hardware_interface::CallbackReturn CarlikeBotSystemHardware::on_init(
     return hardware_interface::CallbackReturn::ERROR;
   }
 
+  // log messages of read() and write() are formatted outside of the realtime loop
+  rt_logger_.configure(get_logger());
+
   // Check if the number of joints is correct based on the mode of operation
   if (info_.joints.size() != 2)
   {
@@ -169,6 +170,24 @@ hardware_interface::CallbackReturn CarlikeBotSystemHardware::on_configure(
     set_command(name, 0.0);
   }
 
+  // look up the interfaces once instead of by name in every read() and write()
+  ros2_control_demo_utils::HandleResolver resolver;
+  resolver.add_states(joint_states_);
+  resolver.add_commands(joint_commands_);
+  const auto steering_position = steering_joint_ + "/" + hardware_interface::HW_IF_POSITION;
+  const auto traction_position = traction_joint_ + "/" + hardware_interface::HW_IF_POSITION;
+  const auto traction_velocity = traction_joint_ + "/" + hardware_interface::HW_IF_VELOCITY;
+  if (
+    !resolver.resolve_state(steering_position, steering_position_state_) ||
+    !resolver.resolve_state(traction_position, traction_position_state_) ||
+    !resolver.resolve_state(traction_velocity, traction_velocity_state_) ||
+    !resolver.resolve_command(steering_position, steering_position_command_) ||
+    !resolver.resolve_command(traction_velocity, traction_velocity_command_))
+  {
+    RCLCPP_FATAL(get_logger(), "Failed to look up the interfaces of the joints.");
+    return hardware_interface::CallbackReturn::ERROR;
+  }
+
   RCLCPP_INFO(get_logger(), "Successfully configured!");
 
   return hardware_interface::CallbackReturn::SUCCESS;
@@ -218,33 +237,20 @@ hardware_interface::return_type CarlikeBotSystemHardware::read(
 {
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
   // update states from commands and integrate velocity to position
-  set_state(
-    steering_joint_ + "/" + hardware_interface::HW_IF_POSITION,
-    get_command(steering_joint_ + "/" + hardware_interface::HW_IF_POSITION));
-
-  set_state(
-    traction_joint_ + "/" + hardware_interface::HW_IF_VELOCITY,
-    get_command(traction_joint_ + "/" + hardware_interface::HW_IF_VELOCITY));
-  set_state(
-    traction_joint_ + "/" + hardware_interface::HW_IF_POSITION,
-    get_state(traction_joint_ + "/" + hardware_interface::HW_IF_POSITION) +
-      get_command(traction_joint_ + "/" + hardware_interface::HW_IF_VELOCITY) * period.seconds());
-
-  std::stringstream ss;
-  ss << "Reading states:";
-
-  ss << std::fixed << std::setprecision(2) << std::endl
-     << "\t"
-     << "position: " << get_state(steering_joint_ + "/" + hardware_interface::HW_IF_POSITION)
-     << " for joint '" << steering_joint_ << "'" << std::endl
-     << "\t"
-     << "position: " << get_state(traction_joint_ + "/" + hardware_interface::HW_IF_POSITION)
-     << " for joint '" << traction_joint_ << "'" << std::endl
-     << "\t"
-     << "velocity: " << get_state(traction_joint_ + "/" + hardware_interface::HW_IF_VELOCITY)
-     << " for joint '" << traction_joint_ << "'";
-
-  RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 500, "%s", ss.str().c_str());
+  steering_position_state_.set(steering_position_command_.get());
+
+  traction_velocity_state_.set(traction_velocity_command_.get());
+  traction_position_state_.set(
+    traction_position_state_.get() + traction_velocity_command_.get() * period.seconds());
+
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, read_log_throttle_);
+  record.append("Reading states:");
+  record.append(
+    "\n\tposition: %.2f for joint '%s'", steering_position_state_.get(), steering_joint_.c_str());
+  record.append(
+    "\n\tposition: %.2f for joint '%s'", traction_position_state_.get(), traction_joint_.c_str());
+  record.append(
+    "\n\tvelocity: %.2f for joint '%s'", traction_velocity_state_.get(), traction_joint_.c_str());
 
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
@@ -255,18 +261,14 @@ hardware_interface::return_type ros2_control_demo_example_11 ::CarlikeBotSystemH
   const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
 {
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
-  std::stringstream ss;
-  ss << "Writing commands:";
-
-  ss << std::fixed << std::setprecision(2) << std::endl
-     << "\t"
-     << "position: " << get_command(steering_joint_ + "/" + hardware_interface::HW_IF_POSITION)
-     << " for joint '" << steering_joint_ << "'" << std::endl
-     << "\t"
-     << "velocity: " << get_command(traction_joint_ + "/" + hardware_interface::HW_IF_VELOCITY)
-     << " for joint '" << traction_joint_ << "'";
-
-  RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 500, "%s", ss.str().c_str());
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, write_log_throttle_);
+  record.append("Writing commands:");
+  record.append(
+    "\n\tposition: %.2f for joint '%s'", steering_position_command_.get(),
+    steering_joint_.c_str());
+  record.append(
+    "\n\tvelocity: %.2f for joint '%s'", traction_velocity_command_.get(),
+    traction_joint_.c_str());
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   return hardware_interface::return_type::OK;
@@ -16,6 +16,7 @@
 #define ROS2_CONTROL_DEMO_EXAMPLE_11__CARLIKEBOT_SYSTEM_HPP_
 
 #include <map>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <utility>
@@ -31,6 +32,8 @@
 #include "rclcpp/time.hpp"
 #include "rclcpp_lifecycle/node_interfaces/lifecycle_node_interface.hpp"
 #include "rclcpp_lifecycle/state.hpp"
+#include "ros2_control_demo_utils/interface_handles.hpp"
+#include "ros2_control_demo_utils/realtime_logger.hpp"
 
 namespace ros2_control_demo_example_11
 {
@@ -86,6 +89,17 @@ private:
   // joint names
   std::string steering_joint_;
   std::string traction_joint_;
+
+  // interfaces of the joints, looked up in on_configure()
+  ros2_control_demo_utils::StateHandle steering_position_state_;
+  ros2_control_demo_utils::StateHandle traction_position_state_;
+  ros2_control_demo_utils::StateHandle traction_velocity_state_;
+  ros2_control_demo_utils::CommandHandle steering_position_command_;
+  ros2_control_demo_utils::CommandHandle traction_velocity_command_;
+
+  ros2_control_demo_utils::RealtimeLogger rt_logger_;
+  ros2_control_demo_utils::LogThrottle read_log_throttle_{std::chrono::milliseconds(500)};
+  ros2_control_demo_utils::LogThrottle write_log_throttle_{std::chrono::milliseconds(500)};
 };
 
 }  // namespace ros2_control_demo_example_11
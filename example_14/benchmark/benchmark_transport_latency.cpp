@@ -0,0 +1,174 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <poll.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ros2_control_demo_example_14/transport.hpp"
+#include "ros2_control_demo_example_14/wire_protocol.hpp"
+
+using ros2_control_demo_example_14::Frame;
+using ros2_control_demo_example_14::FrameDecoder;
+using ros2_control_demo_example_14::Transport;
+using ros2_control_demo_example_14::TransportConfig;
+using ros2_control_demo_example_14::TransportType;
+
+namespace
+{
+constexpr int TIMEOUT_MS = 1000;
+constexpr size_t WARMUP_ROUND_TRIPS = 1000;
+
+bool wait_readable(const Transport & transport)
+{
+  pollfd fd{transport.fd(), POLLIN, 0};
+  return poll(&fd, 1, TIMEOUT_MS) == 1;
+}
+
+/// Receives until \p decoder completes a frame, as the sensor does.
+bool receive_frame(Transport & transport, FrameDecoder & decoder, Frame & frame)
+{
+  uint8_t buffer[256];
+  bool received_frame = false;
+  while (!received_frame)
+  {
+    if (!wait_readable(transport))
+    {
+      return false;
+    }
+    const ssize_t received = transport.receive(buffer, sizeof(buffer));
+    if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+    {
+      return false;
+    }
+    decoder.feed(
+      buffer, static_cast<size_t>(std::max<ssize_t>(received, 0)),
+      [&](const Frame & decoded)
+      {
+        frame = decoded;
+        received_frame = true;
+      });
+  }
+  return true;
+}
+
+/// Opens one direction of a link like the sensor and the actuator do.
+bool open_link(Transport & receiver, Transport & sender)
+{
+  if (!receiver.bind() || !sender.connect())
+  {
+    return false;
+  }
+  return !receiver.connection_oriented() || (wait_readable(receiver) && receiver.accept());
+}
+
+/// Round-trip times in microseconds of frames sent out on one link and echoed back on another.
+std::vector<double> measure_round_trips(TransportType type, uint16_t port, size_t count)
+{
+  TransportConfig forward;
+  forward.type = type;
+  forward.port = port;
+  forward.path = "/tmp/ros2_control_demo_example_14_benchmark_" + std::to_string(port);
+  TransportConfig backward = forward;
+  backward.port = static_cast<uint16_t>(port + 1);
+  backward.path += "_back";
+
+  Transport forward_receiver(forward), forward_sender(forward);
+  Transport backward_receiver(backward), backward_sender(backward);
+  if (
+    !open_link(forward_receiver, forward_sender) ||
+    !open_link(backward_receiver, backward_sender))
+  {
+    std::fprintf(
+      stderr, "Can't open %s links: %s\n", ros2_control_demo_example_14::transport_name(type),
+      std::strerror(errno));
+    return {};
+  }
+
+  const size_t total = WARMUP_ROUND_TRIPS + count;
+  std::thread echo(
+    [&]()
+    {
+      FrameDecoder decoder;
+      Frame frame;
+      uint8_t buffer[Frame::SIZE];
+      for (size_t i = 0; i < total && receive_frame(forward_receiver, decoder, frame); i++)
+      {
+        encode(frame, buffer);
+        backward_sender.send(buffer, sizeof(buffer));
+      }
+    });
+
+  std::vector<double> round_trips;
+  round_trips.reserve(count);
+  FrameDecoder decoder;
+  Frame frame;
+  uint8_t buffer[Frame::SIZE];
+  for (size_t i = 0; i < total; i++)
+  {
+    frame.sequence = static_cast<uint32_t>(i);
+    const auto begin = std::chrono::steady_clock::now();
+    encode(frame, buffer);
+    forward_sender.send(buffer, sizeof(buffer));
+    if (!receive_frame(backward_receiver, decoder, frame))
+    {
+      std::fprintf(stderr, "Frame %zu was not echoed.\n", i);
+      break;
+    }
+    const std::chrono::duration<double, std::micro> round_trip =
+      std::chrono::steady_clock::now() - begin;
+    if (i >= WARMUP_ROUND_TRIPS)
+    {
+      round_trips.push_back(round_trip.count());
+    }
+  }
+  forward_sender.close();
+  echo.join();
+  return round_trips;
+}
+
+double quantile(const std::vector<double> & sorted, double q)
+{
+  return sorted[static_cast<size_t>(q * static_cast<double>(sorted.size() - 1))];
+}
+}  // namespace
+
+// Round-trip time of one frame over each transport of the actuator/sensor link on loopback,
+// including the wake-up of the receiving thread.
+int main(int argc, char ** argv)
+{
+  const size_t count = argc > 1 ? std::stoul(argv[1]) : 10000;
+  const auto port = static_cast<uint16_t>(argc > 2 ? std::stoul(argv[2]) : 23390);
+
+  std::printf("%10s %12s %12s %12s\n", "transport", "p50 [us]", "p99 [us]", "max [us]");
+  for (const TransportType type : {TransportType::TCP, TransportType::UDP, TransportType::UNIX})
+  {
+    auto round_trips = measure_round_trips(type, port, count);
+    if (round_trips.empty())
+    {
+      return 1;
+    }
+    std::sort(round_trips.begin(), round_trips.end());
+    std::printf(
+      "%10s %12.1f %12.1f %12.1f\n", ros2_control_demo_example_14::transport_name(type),
+      quantile(round_trips, 0.5), quantile(round_trips, 0.99), round_trips.back());
+  }
+  return 0;
+}
@@ -32,6 +32,11 @@ def generate_launch_description():
             DeclareLaunchArgument(
                 "slowdown", default_value="50.0", description="Slowdown factor of the RRbot."
             ),
+            DeclareLaunchArgument(
+                "transport",
+                default_value="tcp",
+                description="Link between actuators and sensors: tcp, udp or unix.",
+            ),
             DeclareLaunchArgument(
                 "robot_controller",
                 default_value="forward_velocity_controller",
@@ -73,6 +78,9 @@ def generate_launch_description():
                                 " ",
                                 "slowdown:=",
                                 LaunchConfiguration("slowdown"),
+                                " ",
+                                "transport:=",
+                                LaunchConfiguration("transport"),
                             ]
                         )
                     }
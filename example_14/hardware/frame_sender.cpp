@@ -0,0 +1,99 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ros2_control_demo_example_14/frame_sender.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+namespace ros2_control_demo_example_14
+{
+FrameSender::Result FrameSender::send(
+  Transport & transport, const uint8_t * frame, std::chrono::steady_clock::time_point deadline)
+{
+  // the receiver can't parse the next frame before the rest of the previous one
+  if (pending_size_ > 0)
+  {
+    pending_offset_ += send_until(
+      transport, pending_.data() + pending_offset_, pending_size_ - pending_offset_, deadline);
+    if (pending_offset_ < pending_size_)
+    {
+      dropped_++;
+      return Result::DROPPED;
+    }
+    pending_size_ = 0;
+    late_++;
+  }
+
+  const size_t sent = send_until(transport, frame, Frame::SIZE, deadline);
+  if (sent == 0)
+  {
+    dropped_++;
+    return Result::DROPPED;
+  }
+  if (sent < Frame::SIZE)
+  {
+    std::memcpy(pending_.data(), frame, Frame::SIZE);
+    pending_offset_ = sent;
+    pending_size_ = Frame::SIZE;
+    partial_++;
+    return Result::PARTIAL;
+  }
+  if (std::chrono::steady_clock::now() > deadline)
+  {
+    late_++;
+    return Result::LATE;
+  }
+  return Result::SENT;
+}
+
+void FrameSender::reset()
+{
+  pending_offset_ = 0;
+  pending_size_ = 0;
+  dropped_ = 0;
+  late_ = 0;
+  partial_ = 0;
+}
+
+size_t FrameSender::send_until(
+  Transport & transport, const uint8_t * data, size_t size,
+  std::chrono::steady_clock::time_point deadline)
+{
+  size_t sent = 0;
+  while (sent < size)
+  {
+    const ssize_t result = transport.send(data + sent, size - sent);
+    if (result > 0)
+    {
+      sent += static_cast<size_t>(result);
+      continue;
+    }
+    // a broken or closed link doesn't get better by waiting
+    if (result == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+    {
+      break;
+    }
+    const auto remaining = deadline - std::chrono::steady_clock::now();
+    if (
+      remaining <= std::chrono::steady_clock::duration::zero() ||
+      !transport.wait_writable(remaining))
+    {
+      break;
+    }
+  }
+  return sent;
+}
+
+}  // namespace ros2_control_demo_example_14
@@ -0,0 +1,83 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS2_CONTROL_DEMO_EXAMPLE_14__FRAME_SENDER_HPP_
+#define ROS2_CONTROL_DEMO_EXAMPLE_14__FRAME_SENDER_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <array>
+#include <chrono>
+
+#include "ros2_control_demo_example_14/transport.hpp"
+#include "ros2_control_demo_example_14/wire_protocol.hpp"
+
+namespace ros2_control_demo_example_14
+{
+/**
+ * Sends one frame per control cycle without ever stalling the cycle.
+ *
+ * A frame is sent until the deadline of the cycle at the latest. If the socket buffer is still
+ * full by then, the frame is dropped: the next cycle sends a frame with the newest command
+ * instead of queueing stale ones. On a stream socket a frame may go out only partially; its
+ * remaining bytes are sent first in the next cycle, so the receiver never loses sync. Realtime
+ * safe.
+ */
+class FrameSender
+{
+public:
+  enum class Result
+  {
+    /// the whole frame was sent before the deadline
+    SENT,
+    /// the whole frame was sent, but after the deadline
+    LATE,
+    /// only a part of the frame was sent, the rest follows in the next send()
+    PARTIAL,
+    /// nothing of the frame was sent, it is superseded by the next one
+    DROPPED,
+  };
+
+  /// Sends the Frame::SIZE bytes at \p frame over \p transport, waiting until \p deadline at most.
+  Result send(
+    Transport & transport, const uint8_t * frame, std::chrono::steady_clock::time_point deadline);
+
+  /// Forgets the rest of a partially sent frame and the counters, e.g. for a new connection.
+  void reset();
+
+  /// Frames of which nothing was sent.
+  size_t dropped() const { return dropped_; }
+  /// Frames sent completely, but after their deadline, including the rest of partial frames.
+  size_t late() const { return late_; }
+  /// Frames of which only a part was sent before their deadline.
+  size_t partial() const { return partial_; }
+
+private:
+  /// Sends as much of \p size bytes at \p data as possible until \p deadline. \return bytes sent
+  size_t send_until(
+    Transport & transport, const uint8_t * data, size_t size,
+    std::chrono::steady_clock::time_point deadline);
+
+  std::array<uint8_t, Frame::SIZE> pending_{};
+  size_t pending_offset_ = 0;
+  size_t pending_size_ = 0;
+
+  size_t dropped_ = 0;
+  size_t late_ = 0;
+  size_t partial_ = 0;
+};
+
+}  // namespace ros2_control_demo_example_14
+
+#endif  // ROS2_CONTROL_DEMO_EXAMPLE_14__FRAME_SENDER_HPP_
@@ -19,7 +19,8 @@
 #ifndef ROS2_CONTROL_DEMO_EXAMPLE_14__RRBOT_ACTUATOR_WITHOUT_FEEDBACK_HPP_
 #define ROS2_CONTROL_DEMO_EXAMPLE_14__RRBOT_ACTUATOR_WITHOUT_FEEDBACK_HPP_
 
-#include <netinet/in.h>
+#include <array>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -30,6 +31,11 @@
 #include "hardware_interface/system_interface.hpp"
 #include "hardware_interface/types/hardware_interface_return_values.hpp"
 #include "rclcpp/macros.hpp"
+#include "ros2_control_demo_example_14/frame_sender.hpp"
+#include "ros2_control_demo_example_14/transport.hpp"
+#include "ros2_control_demo_example_14/wire_protocol.hpp"
+#include "ros2_control_demo_utils/interface_handles.hpp"
+#include "ros2_control_demo_utils/realtime_logger.hpp"
 
 namespace ros2_control_demo_example_14
 {
@@ -41,6 +47,9 @@ public:
   hardware_interface::CallbackReturn on_init(
     const hardware_interface::HardwareComponentInterfaceParams & params) override;
 
+  std::vector<hardware_interface::InterfaceDescription>
+  export_unlisted_state_interface_descriptions() override;
+
   hardware_interface::CallbackReturn on_configure(
     const rclcpp_lifecycle::State & previous_state) override;
 
@@ -67,10 +76,24 @@ private:
   double hw_start_sec_;
   double hw_stop_sec_;
 
+  ros2_control_demo_utils::RealtimeLogger rt_logger_;
+
   // Fake "mechanical connection" between actuator and sensor using sockets
-  struct sockaddr_in address_;
-  uint16_t socket_port_;
-  int sock_;
+  Transport transport_;
+
+  // Frames of the commands sent over the socket, a new session on every configuration
+  uint32_t session_ = 0;
+  uint32_t next_sequence_ = 0;
+  std::array<uint8_t, Frame::SIZE> send_buffer_;
+
+  // write() waits at most this long for room in the socket buffer
+  std::chrono::microseconds send_deadline_;
+  FrameSender frame_sender_;
+  // velocity command of the joint, looked up in on_configure()
+  ros2_control_demo_utils::CommandHandle velocity_command_;
+  // dropped, late and partial frames as state interfaces of the component
+  std::array<ros2_control_demo_utils::StateHandle, 3> send_statistics_;
+  ros2_control_demo_utils::LogThrottle send_log_throttle_{std::chrono::milliseconds(1000)};
 };
 
 }  // namespace ros2_control_demo_example_14
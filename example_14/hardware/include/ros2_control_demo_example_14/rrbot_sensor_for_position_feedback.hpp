@@ -19,10 +19,8 @@
 #ifndef ROS2_CONTROL_DEMO_EXAMPLE_14__RRBOT_SENSOR_FOR_POSITION_FEEDBACK_HPP_
 #define ROS2_CONTROL_DEMO_EXAMPLE_14__RRBOT_SENSOR_FOR_POSITION_FEEDBACK_HPP_
 
-#include <netinet/in.h>
-#include <atomic>
+#include <chrono>
 #include <memory>
-#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
@@ -32,9 +30,13 @@
 #include "hardware_interface/sensor_interface.hpp"
 #include "hardware_interface/system_interface.hpp"
 #include "hardware_interface/types/hardware_interface_return_values.hpp"
-#include "rclcpp/clock.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp/time.hpp"
+#include "ros2_control_demo_example_14/transport.hpp"
+#include "ros2_control_demo_example_14/wire_protocol.hpp"
+#include "ros2_control_demo_utils/interface_handles.hpp"
+#include "ros2_control_demo_utils/realtime_logger.hpp"
+#include "ros2_control_demo_utils/spsc_ring.hpp"
 
 namespace ros2_control_demo_example_14
 {
@@ -65,36 +67,48 @@ public:
     const rclcpp::Time & time, const rclcpp::Duration & period) override;
 
 private:
+  /// Adds \p fd to the event loop.
+  bool watch(int fd);
+
+  /// Waits until \p fd can be read. \return false if woken by on_cleanup() or on an error
+  bool wait_readable(int fd);
+
   // Parameters for the RRBot simulation
   double hw_start_sec_;
   double hw_stop_sec_;
   double hw_slowdown_;
 
-  // Store the command for the simulated robot
-  double measured_velocity_;  // Local variable, but avoid initialization on each read
+  ros2_control_demo_utils::RealtimeLogger rt_logger_;
+  ros2_control_demo_utils::LogThrottle read_log_throttle_{std::chrono::milliseconds(500)};
+
+  // position of the joint, looked up in on_configure()
+  ros2_control_demo_utils::StateHandle position_state_;
+
+  // Velocity measured last, it holds until the next sample arrives
   double last_measured_velocity_;
 
-  // Timestamps to calculate position for velocity
-  rclcpp::Clock clock_;
-  rclcpp::Time last_timestamp_;
-  rclcpp::Time current_timestamp;  // Local variable, but avoid initialization on each read
+  // Time of the previous read(), the velocity is integrated from there
+  std::chrono::steady_clock::time_point last_read_;
 
-  // Sync incoming commands between threads
-  std::atomic<double> rt_incoming_data_;
-  std::atomic<bool> receive_data_;
+  // Velocity received from the actuator and when it arrived
+  struct VelocitySample
+  {
+    std::chrono::steady_clock::time_point stamp;
+    double velocity;
+  };
 
-  // Create timer to checking incoming data on socket
+  // Every sample received since the previous read(), from the receiving thread to read()
+  ros2_control_demo_utils::SpscRing<VelocitySample> incoming_samples_{1024};
+  // Thread receiving incoming data on the socket and the frames it splits the data into
   std::thread incoming_data_thread_;
-  std::mutex mtx;
-  std::condition_variable cv;
+  FrameDecoder decoder_;
+
+  // Event loop of the thread, wake_fd_ stops it
+  int epoll_fd_ = -1;
+  int wake_fd_ = -1;
 
   // Fake "mechanical connection" between actuator and sensor using sockets
-  struct sockaddr_in address_;
-  uint16_t socket_port_;
-  int address_length_;
-  int obj_socket_;
-  int sockoptval_ = 1;
-  int sock_;
+  Transport transport_;
 };
 
 }  // namespace ros2_control_demo_example_14
@@ -0,0 +1,131 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS2_CONTROL_DEMO_EXAMPLE_14__TRANSPORT_HPP_
+#define ROS2_CONTROL_DEMO_EXAMPLE_14__TRANSPORT_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+
+namespace ros2_control_demo_example_14
+{
+enum class TransportType
+{
+  /// TCP stream on localhost with Nagle's algorithm disabled
+  TCP,
+  /// UDP datagrams on localhost
+  UDP,
+  /// Unix domain socket of type SOCK_SEQPACKET, reliable and keeping the frame boundaries
+  UNIX,
+};
+
+/// Where the actuator sends its frames to and the sensor receives them.
+struct TransportConfig
+{
+  TransportType type = TransportType::TCP;
+  /// port of TCP and UDP
+  uint16_t port = 0;
+  /// path of the Unix socket
+  std::string path;
+};
+
+/**
+ * Reads the transport from the hardware parameters, e.g. of the URDF:
+ *
+ * - example_param_transport: "tcp" (default), "udp" or "unix"
+ * - example_param_socket_port: port of TCP and UDP, also the default name of the Unix socket
+ * - example_param_socket_path: path of the Unix socket, "/tmp/ros2_control_demo_example_14_<port>"
+ *   by default
+ *
+ * \return false if a parameter is invalid
+ */
+bool parse_transport_config(
+  const std::unordered_map<std::string, std::string> & parameters, TransportConfig & config);
+
+/// Name of \p type in the hardware parameters, e.g. "tcp".
+const char * transport_name(TransportType type);
+
+/// Description of \p config for log messages, e.g. "tcp port 23286".
+std::string describe_transport(const TransportConfig & config);
+
+/**
+ * One direction of the link between actuator and sensor over a socket.
+ *
+ * The receiving end calls bind(), waits until fd() is readable and, for a connection-oriented
+ * transport, accept()s the connection before it receive()s. The sending end connect()s and
+ * send()s. Sending and receiving never block, errors are reported in errno.
+ */
+class Transport
+{
+public:
+  Transport() = default;
+  explicit Transport(const TransportConfig & config) : config_(config) {}
+  ~Transport() { close(); }
+  Transport(const Transport &) = delete;
+  Transport & operator=(const Transport &) = delete;
+
+  const TransportConfig & config() const { return config_; }
+
+  /// Closes all sockets and uses \p config from now on.
+  void set_config(const TransportConfig & config)
+  {
+    close();
+    config_ = config;
+  }
+
+  /// Whether the receiving end has to accept() a connection before it receives data.
+  bool connection_oriented() const { return config_.type != TransportType::UDP; }
+
+  /// Receiving end: creates the socket and binds it, a TCP or Unix socket also listens.
+  bool bind();
+
+  /// Receiving end: accepts the connection waiting on the listening socket.
+  bool accept();
+
+  /// Sending end: creates the socket and connects it to the receiving end.
+  bool connect();
+
+  /// The socket to wait on: the listening socket until accept(), the connection afterwards.
+  int fd() const { return connection_fd_ >= 0 ? connection_fd_ : socket_fd_; }
+
+  /// \return like send(2), never blocks and never raises SIGPIPE
+  ssize_t send(const uint8_t * data, size_t size);
+
+  /// Waits at most \p timeout until send() has room. \return false on timeout or error
+  bool wait_writable(std::chrono::nanoseconds timeout) const;
+
+  /// \return like recv(2), never blocks
+  ssize_t receive(uint8_t * data, size_t size);
+
+  /// Closes the accepted connection, the receiving end may accept() a new one.
+  void disconnect();
+
+  /// Closes all sockets.
+  void close();
+
+private:
+  TransportConfig config_;
+  int socket_fd_ = -1;
+  int connection_fd_ = -1;
+  // the Unix socket file was created by bind() and is removed by close()
+  bool bound_path_ = false;
+};
+
+}  // namespace ros2_control_demo_example_14
+
+#endif  // ROS2_CONTROL_DEMO_EXAMPLE_14__TRANSPORT_HPP_
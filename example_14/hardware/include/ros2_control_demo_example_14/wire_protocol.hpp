@@ -0,0 +1,112 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS2_CONTROL_DEMO_EXAMPLE_14__WIRE_PROTOCOL_HPP_
+#define ROS2_CONTROL_DEMO_EXAMPLE_14__WIRE_PROTOCOL_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <array>
+
+namespace ros2_control_demo_example_14
+{
+/**
+ * Frame sent from the actuator to the sensor in every write().
+ *
+ * On the wire a frame has a fixed size of Frame::SIZE bytes: the magic bytes "RRB1", the
+ * session, the sequence number, the send time and the values, followed by the CRC-32 of all bytes
+ * before it.
+ * Numbers are in host byte order, both ends run on the same machine.
+ */
+struct Frame
+{
+  static constexpr uint8_t MAGIC[4] = {'R', 'R', 'B', '1'};
+  static constexpr size_t NUM_VALUES = 1;
+  static constexpr size_t SIZE = sizeof(MAGIC) + 2 * sizeof(uint32_t) + sizeof(uint64_t) +
+                                 NUM_VALUES * sizeof(double) + sizeof(uint32_t);
+
+  /// chosen anew whenever the sender starts its sequence over, e.g. when it is configured again
+  uint32_t session = 0;
+  /// incremented by one for every frame the sender encodes
+  uint32_t sequence = 0;
+  /// send time in nanoseconds of std::chrono::steady_clock
+  uint64_t stamp_ns = 0;
+  std::array<double, NUM_VALUES> values{};
+};
+
+/// CRC-32 as used by Ethernet and zlib.
+uint32_t crc32(const uint8_t * data, size_t size);
+
+/// Writes \p frame to the Frame::SIZE bytes at \p buffer.
+void encode(const Frame & frame, uint8_t * buffer);
+
+/// Reads the Frame::SIZE bytes at \p buffer. \return false if magic bytes or CRC don't match
+bool decode(const uint8_t * buffer, Frame & frame);
+
+/**
+ * Splits a byte stream into frames, however the bytes were split or merged on the way.
+ *
+ * Bytes that don't belong to a valid frame are skipped until the next magic bytes. Frames with a
+ * sequence number at or before the last one accepted are rejected as duplicates or reordered,
+ * gaps in the sequence are counted as lost frames. A frame of another session starts the sequence
+ * over, so a restarted sender is accepted right away. Realtime safe.
+ */
+class FrameDecoder
+{
+public:
+  /// Parses \p size received bytes and calls \p on_frame with each accepted frame in order.
+  template <typename Callback>
+  void feed(const uint8_t * data, size_t size, Callback && on_frame)
+  {
+    Frame frame;
+    for (size_t i = 0; i < size; i++)
+    {
+      if (push(data[i], frame))
+      {
+        on_frame(frame);
+      }
+    }
+  }
+
+  /// Parses one byte. \return true if it completed a frame that was accepted into \p frame
+  bool push(uint8_t byte, Frame & frame);
+
+  /// Forgets buffered bytes and the sequence, e.g. for a new connection.
+  void reset();
+
+  size_t crc_errors() const { return crc_errors_; }
+  size_t sequence_errors() const { return sequence_errors_; }
+  size_t lost_frames() const { return lost_frames_; }
+  /// number of times the sender started a new session
+  size_t restarts() const { return restarts_; }
+
+private:
+  /// Drops buffered bytes until the buffer starts with (a part of) the magic bytes again.
+  void resync(size_t offset);
+
+  std::array<uint8_t, Frame::SIZE> buffer_{};
+  size_t buffered_ = 0;
+  bool has_sequence_ = false;
+  uint32_t session_ = 0;
+  uint32_t next_sequence_ = 0;
+
+  size_t crc_errors_ = 0;
+  size_t sequence_errors_ = 0;
+  size_t lost_frames_ = 0;
+  size_t restarts_ = 0;
+};
+
+}  // namespace ros2_control_demo_example_14
+
+#endif  // ROS2_CONTROL_DEMO_EXAMPLE_14__WIRE_PROTOCOL_HPP_
@@ -18,15 +18,12 @@
 
 #include "ros2_control_demo_example_14/rrbot_actuator_without_feedback.hpp"
 
-#include <netdb.h>
-#include <sys/socket.h>
 #include <chrono>
 #include <cmath>
 #include <cstring>
-#include <iomanip>
 #include <limits>
 #include <memory>
-#include <sstream>
+#include <random>
 #include <vector>
 
 #include "hardware_interface/actuator_interface.hpp"
@@ -36,6 +33,11 @@
 
 namespace ros2_control_demo_example_14
 {
+namespace
+{
+constexpr const char * SEND_STATISTICS[] = {"send_dropped", "send_late", "send_partial"};
+}  // namespace
+
 hardware_interface::CallbackReturn RRBotActuatorWithoutFeedback::on_init(
   const hardware_interface::HardwareComponentInterfaceParams & params)
 {
@@ -45,13 +47,24 @@ hardware_interface::CallbackReturn RRBotActuatorWithoutFeedback::on_init(
   {
     return hardware_interface::CallbackReturn::ERROR;
   }
+
+  // log messages of write() are formatted outside of the realtime loop
+  rt_logger_.configure(get_logger());
+
   // START: This part here is for exemplary purposes - Please do not copy to your production code
   hw_start_sec_ =
     hardware_interface::stod(info_.hardware_parameters["example_param_hw_start_duration_sec"]);
   hw_stop_sec_ =
     hardware_interface::stod(info_.hardware_parameters["example_param_hw_stop_duration_sec"]);
-  socket_port_ =
-    static_cast<uint16_t>(std::stoi(info_.hardware_parameters["example_param_socket_port"]));
+  TransportConfig transport_config;
+  if (!parse_transport_config(info_.hardware_parameters, transport_config))
+  {
+    RCLCPP_FATAL(get_logger(), "Invalid transport in the hardware parameters.");
+    return hardware_interface::CallbackReturn::ERROR;
+  }
+  transport_.set_config(transport_config);
+  send_deadline_ =
+    std::chrono::microseconds(stoi(info_.hardware_parameters["example_param_send_deadline_us"]));
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   const hardware_interface::ComponentInfo & joint = info_.joints[0];
@@ -73,25 +86,23 @@ hardware_interface::CallbackReturn RRBotActuatorWithoutFeedback::on_init(
     return hardware_interface::CallbackReturn::ERROR;
   }
 
-  // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
-  // Initialize objects for fake mechanical connection
-  sock_ = socket(AF_INET, SOCK_STREAM, 0);
-  if (sock_ < 0)
+  return hardware_interface::CallbackReturn::SUCCESS;
+}
+
+std::vector<hardware_interface::InterfaceDescription>
+RRBotActuatorWithoutFeedback::export_unlisted_state_interface_descriptions()
+{
+  // the statistics of the link are state interfaces in addition to the ones of the URDF
+  std::vector<hardware_interface::InterfaceDescription> descriptions;
+  for (const char * statistic : SEND_STATISTICS)
   {
-    RCLCPP_FATAL(get_logger(), "Creating socket failed.");
-    return hardware_interface::CallbackReturn::ERROR;
+    hardware_interface::InterfaceInfo info;
+    info.name = statistic;
+    info.initial_value = "0.0";
+    info.data_type = "double";
+    descriptions.emplace_back(info_.name, info);
   }
-
-  auto server = gethostbyname("localhost");
-
-  address_.sin_family = AF_INET;
-  bcopy(
-    reinterpret_cast<char *>(server->h_addr), reinterpret_cast<char *>(&address_.sin_addr.s_addr),
-    static_cast<size_t>(server->h_length));
-  address_.sin_port = htons(socket_port_);
-  // END: This part here is for exemplary purposes - Please do not copy to your production code
-
-  return hardware_interface::CallbackReturn::SUCCESS;
+  return descriptions;
 }
 
 hardware_interface::CallbackReturn RRBotActuatorWithoutFeedback::on_configure(
@@ -103,7 +114,8 @@ hardware_interface::CallbackReturn RRBotActuatorWithoutFeedback::on_configure(
   const int max_retries = 5;
   const int initial_delay_ms = 1000;  // Initial delay of 1 second
 
-  RCLCPP_INFO(get_logger(), "Trying to connect to port %d.", socket_port_);
+  const auto transport = describe_transport(transport_.config());
+  RCLCPP_INFO(get_logger(), "Trying to connect to %s.", transport.c_str());
 
   int retries = 0;
   int delay_ms = initial_delay_ms;
@@ -111,7 +123,7 @@ hardware_interface::CallbackReturn RRBotActuatorWithoutFeedback::on_configure(
 
   while (retries < max_retries)
   {
-    if (connect(sock_, (struct sockaddr *)&address_, sizeof(address_)) == 0)
+    if (transport_.connect())
     {
       connected = true;
       break;
@@ -135,7 +147,7 @@ hardware_interface::CallbackReturn RRBotActuatorWithoutFeedback::on_configure(
   }
   else
   {
-    RCLCPP_INFO(get_logger(), "Successfully connected to port %d.", socket_port_);
+    RCLCPP_INFO(get_logger(), "Successfully connected to %s.", transport.c_str());
   }
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
@@ -144,6 +156,30 @@ hardware_interface::CallbackReturn RRBotActuatorWithoutFeedback::on_configure(
   {
     set_command(name, 0.0);
   }
+  session_ = std::random_device()();
+  next_sequence_ = 0;
+  frame_sender_.reset();
+
+  ros2_control_demo_utils::HandleResolver resolver;
+  resolver.add_states(unlisted_states_);
+  resolver.add_commands(joint_commands_);
+  if (!resolver.resolve_command(
+        info_.joints[0].name + "/" + hardware_interface::HW_IF_VELOCITY, velocity_command_))
+  {
+    RCLCPP_FATAL(
+      get_logger(), "Failed to look up the velocity command of joint '%s'.",
+      info_.joints[0].name.c_str());
+    return hardware_interface::CallbackReturn::ERROR;
+  }
+  for (size_t i = 0; i < send_statistics_.size(); i++)
+  {
+    if (!resolver.resolve_state(info_.name + "/" + SEND_STATISTICS[i], send_statistics_[i]))
+    {
+      RCLCPP_FATAL(get_logger(), "Failed to look up the state interface '%s'.", SEND_STATISTICS[i]);
+      return hardware_interface::CallbackReturn::ERROR;
+    }
+    send_statistics_[i].set(0.0);
+  }
 
   return hardware_interface::CallbackReturn::SUCCESS;
 }
@@ -151,7 +187,7 @@ hardware_interface::CallbackReturn RRBotActuatorWithoutFeedback::on_configure(
 hardware_interface::CallbackReturn RRBotActuatorWithoutFeedback::on_cleanup(
   const rclcpp_lifecycle::State & /*previous_state*/)
 {
-  shutdown(sock_, SHUT_RDWR);  // shutdown socket
+  transport_.close();
 
   return hardware_interface::CallbackReturn::SUCCESS;
 }
@@ -214,21 +250,41 @@ hardware_interface::return_type ros2_control_demo_example_14::RRBotActuatorWitho
   const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
 {
   // START: This part here is for exemplary purposes - Please do not copy to your production code
-  std::stringstream ss;
-  std::ostringstream data;
-
-  ss << "Writing..." << std::endl;
-  ss << std::fixed << std::setprecision(2);
-
-  auto name = info_.joints[0].name + "/" + hardware_interface::HW_IF_VELOCITY;
-  ss << "Writing command: " << get_command(name) << std::endl;
-
-  data << get_command(name);
-  ss << "Sending data command: " << data.str() << std::endl;
-  RCLCPP_INFO(get_logger(), "%s", ss.str().c_str());
+  // one frame per cycle, so commands can neither merge in the stream nor be parsed partially
+  Frame frame;
+  frame.session = session_;
+  frame.sequence = next_sequence_++;
+  frame.stamp_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                           std::chrono::steady_clock::now().time_since_epoch())
+                                           .count());
+  frame.values[0] = velocity_command_.get();
+  encode(frame, send_buffer_.data());
+
+  // committed at the end of the block, before a warning below may start the next record
+  {
+    auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO);
+    record.append("Writing...\n");
+    record.append("Writing command: %.2f\n", frame.values[0]);
+    record.append("Sending frame %u with command %g\n", frame.sequence, frame.values[0]);
+  }
 
-  // Simulate sending commands to the hardware
-  send(sock_, data.str().c_str(), strlen(data.str().c_str()), 0);
+  // Simulate sending commands to the hardware, a slow or dead link must not stall the loop
+  const auto result = frame_sender_.send(
+    transport_, send_buffer_.data(), std::chrono::steady_clock::now() + send_deadline_);
+  send_statistics_[0].set(static_cast<double>(frame_sender_.dropped()));
+  send_statistics_[1].set(static_cast<double>(frame_sender_.late()));
+  send_statistics_[2].set(static_cast<double>(frame_sender_.partial()));
+  if (result != FrameSender::Result::SENT)
+  {
+    if (
+      auto warning =
+        rt_logger_.record(ros2_control_demo_utils::LogSeverity::WARN, send_log_throttle_))
+    {
+      warning.append(
+        "Link to the sensor falls behind: %zu frames dropped, %zu late, %zu partial\n",
+        frame_sender_.dropped(), frame_sender_.late(), frame_sender_.partial());
+    }
+  }
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   return hardware_interface::return_type::OK;
@@ -18,15 +18,14 @@
 
 #include "ros2_control_demo_example_14/rrbot_sensor_for_position_feedback.hpp"
 
-#include <netdb.h>
-#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <cstring>
-#include <iomanip>
-#include <limits>
 #include <memory>
-#include <sstream>
 #include <thread>
 
 #include "hardware_interface/lexical_casts.hpp"
@@ -45,14 +44,23 @@ hardware_interface::CallbackReturn RRBotSensorPositionFeedback::on_init(
   {
     return hardware_interface::CallbackReturn::ERROR;
   }
+
+  // log messages of read() are formatted outside of the realtime loop
+  rt_logger_.configure(get_logger());
+
   // START: This part here is for exemplary purposes - Please do not copy to your production code
   hw_start_sec_ =
     hardware_interface::stod(info_.hardware_parameters["example_param_hw_start_duration_sec"]);
   hw_stop_sec_ =
     hardware_interface::stod(info_.hardware_parameters["example_param_hw_stop_duration_sec"]);
   hw_slowdown_ = hardware_interface::stod(info_.hardware_parameters["example_param_hw_slowdown"]);
-  socket_port_ =
-    static_cast<uint16_t>(std::stoi(info_.hardware_parameters["example_param_socket_port"]));
+  TransportConfig transport_config;
+  if (!parse_transport_config(info_.hardware_parameters, transport_config))
+  {
+    RCLCPP_FATAL(get_logger(), "Invalid transport in the hardware parameters.");
+    return hardware_interface::CallbackReturn::ERROR;
+  }
+  transport_.set_config(transport_config);
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   const hardware_interface::ComponentInfo & joint = info_.joints[0];
@@ -73,42 +81,15 @@ hardware_interface::CallbackReturn RRBotSensorPositionFeedback::on_init(
     return hardware_interface::CallbackReturn::ERROR;
   }
 
-  clock_ = rclcpp::Clock();
-
   // START: This part here is for exemplary purposes - Please do not copy to your production code
   // Initialize objects for fake mechanical connection
-  obj_socket_ = socket(AF_INET, SOCK_STREAM, 0);
-  if (obj_socket_ < 0)
+  RCLCPP_INFO(get_logger(), "Binding to %s.", describe_transport(transport_.config()).c_str());
+  if (!transport_.bind())
   {
-    RCLCPP_FATAL(get_logger(), "Creating socket failed.");
+    RCLCPP_FATAL(get_logger(), "Binding to socket failed: %s", strerror(errno));
     return hardware_interface::CallbackReturn::ERROR;
   }
 
-  RCLCPP_INFO(get_logger(), "Setting socket options.");
-  if (setsockopt(obj_socket_, SOL_SOCKET, SO_REUSEADDR, &sockoptval_, sizeof(sockoptval_)))
-  {
-    RCLCPP_FATAL(get_logger(), "Setting socket failed.");
-    return hardware_interface::CallbackReturn::ERROR;
-  }
-
-  address_length_ = sizeof(address_);
-
-  address_.sin_family = AF_INET;
-  address_.sin_addr.s_addr = INADDR_ANY;
-  address_.sin_port = htons(socket_port_);
-
-  RCLCPP_INFO(get_logger(), "Binding to socket address.");
-  if (bind(obj_socket_, reinterpret_cast<struct sockaddr *>(&address_), sizeof(address_)) < 0)
-  {
-    RCLCPP_FATAL(
-      get_logger(), "Binding to socket failed: %s",
-      strerror(errno));  // Print the error message
-    return hardware_interface::CallbackReturn::ERROR;
-  }
-
-  // Storage for incoming data
-  rt_incoming_data_ = std::numeric_limits<double>::quiet_NaN();
-
   return hardware_interface::CallbackReturn::SUCCESS;
 }
 
@@ -117,71 +98,109 @@ hardware_interface::CallbackReturn RRBotSensorPositionFeedback::on_configure(
 {
   RCLCPP_INFO(get_logger(), "Configuring ...please wait...");
 
+  // read() accesses the joint position through a handle instead of by name
+  ros2_control_demo_utils::HandleResolver resolver;
+  resolver.add_states(joint_states_);
+  if (!resolver.resolve_state(
+        info_.joints[0].name + "/" + hardware_interface::HW_IF_POSITION, position_state_))
+  {
+    RCLCPP_FATAL(
+      get_logger(), "Failed to look up the position of joint '%s'.", info_.joints[0].name.c_str());
+    return hardware_interface::CallbackReturn::ERROR;
+  }
+
   // START: This part here is for exemplary purposes - Please do not copy to your production code
-  // Thread for incoming data
-  receive_data_ = true;
+  // Thread for incoming data, read() consumes every sample it receives. It sleeps in epoll until
+  // data arrives or on_cleanup() signals the eventfd, so no sample waits for a polling period.
+  incoming_samples_.reset(incoming_samples_.capacity());
+  decoder_.reset();
+  wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (wake_fd_ < 0 || epoll_fd_ < 0 || !watch(wake_fd_))
+  {
+    RCLCPP_FATAL(get_logger(), "Creating the event loop failed: %s", strerror(errno));
+    return hardware_interface::CallbackReturn::ERROR;
+  }
+
   incoming_data_thread_ = std::thread(
     [this]()
     {
-      // Await and accept connection
-      RCLCPP_INFO(get_logger(), "Listening for connection on port %d.", socket_port_);
-      if (listen(obj_socket_, 1) < 0)
+      // Await and accept connection, datagrams arrive without one
+      if (transport_.connection_oriented())
       {
-        RCLCPP_FATAL(get_logger(), "Cannot listen from the server.");
-        return hardware_interface::CallbackReturn::ERROR;
+        RCLCPP_INFO(
+          get_logger(), "Listening for connection on %s.",
+          describe_transport(transport_.config()).c_str());
+        if (!watch(transport_.fd()))
+        {
+          RCLCPP_FATAL(get_logger(), "Cannot listen from the server.");
+          return hardware_interface::CallbackReturn::ERROR;
+        }
+        if (!wait_readable(transport_.fd()))
+        {
+          return hardware_interface::CallbackReturn::SUCCESS;
+        }
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, transport_.fd(), nullptr);
+        if (!transport_.accept())
+        {
+          RCLCPP_FATAL(get_logger(), "Cannot accept on the server.");
+          return hardware_interface::CallbackReturn::ERROR;
+        }
+        RCLCPP_INFO(get_logger(), "Accepting on socket.");
       }
-
-      sock_ = accept(
-        obj_socket_, reinterpret_cast<struct sockaddr *>(&address_),
-        reinterpret_cast<socklen_t *>(&address_length_));
-      if (sock_ < 0)
+      if (!watch(transport_.fd()))
       {
-        RCLCPP_FATAL(get_logger(), "Cannot accept on the server.");
+        RCLCPP_FATAL(get_logger(), "Cannot wait for data on the socket.");
         return hardware_interface::CallbackReturn::ERROR;
       }
-      RCLCPP_INFO(get_logger(), "Accepting on socket.");
-
-      int incoming_data_read_rate = 1000;  // Hz
-      RCLCPP_INFO(
-        get_logger(),
-        "Creating thread for incoming data and read them with %d Hz to not miss any data.",
-        incoming_data_read_rate);
 
       // Variables for reading from a socket
       const size_t reading_size_bytes = 1024;
-      char buffer[reading_size_bytes] = {0};
+      uint8_t buffer[reading_size_bytes];
 
-      // Use nanoseconds to avoid chrono's rounding
-      std::this_thread::sleep_for(std::chrono::nanoseconds(1000000000 / incoming_data_read_rate));
+      // the decoder counts the errors since configuration, they are reported when they increase
+      size_t reported_errors = 0;
+      std::chrono::steady_clock::time_point last_report;
 
       RCLCPP_INFO(get_logger(), "Receiving data");
-      while (rclcpp::ok())
+      while (wait_readable(transport_.fd()))
       {
+        // drain the socket, one wake-up handles everything that arrived meanwhile
+        ssize_t received;
+        while ((received = transport_.receive(buffer, reading_size_bytes)) > 0)
         {
-          std::unique_lock<std::mutex> lock(mtx);
-          bool should_stop = cv.wait_for(
-            lock, std::chrono::nanoseconds(1000000000 / incoming_data_read_rate),
-            [this]() { return !receive_data_.load(); });
-
-          if (should_stop)
-          {
-            break;
-          }
+          // steady_clock is CLOCK_MONOTONIC, the clock read() integrates over
+          const auto stamp = std::chrono::steady_clock::now();
+          decoder_.feed(
+            buffer, static_cast<size_t>(received),
+            [this, stamp](const Frame & frame)
+            {
+              if (!incoming_samples_.push({stamp, frame.values[0]}))
+              {
+                RCLCPP_WARN_THROTTLE(
+                  get_logger(), *this->get_clock(), 500, "Sample dropped, read() falls behind.");
+              }
+            });
         }
-
-        if (recv(sock_, buffer, reading_size_bytes, 0) > 0)
+        const size_t errors =
+          decoder_.crc_errors() + decoder_.sequence_errors() + decoder_.lost_frames();
+        const auto now = std::chrono::steady_clock::now();
+        if (errors > reported_errors && now - last_report >= std::chrono::seconds(1))
         {
-          RCLCPP_DEBUG(get_logger(), "Read from buffer sockets data: '%s'", buffer);
-          rt_incoming_data_ = hardware_interface::stod(buffer);
+          RCLCPP_WARN(
+            get_logger(), "Rejected %zu corrupt and %zu out of sequence frames, %zu frames lost.",
+            decoder_.crc_errors(), decoder_.sequence_errors(), decoder_.lost_frames());
+          reported_errors = errors;
+          last_report = now;
         }
-        else
+        // an empty datagram is no end of a connection
+        if (
+          received < 0 ? errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR
+                       : transport_.connection_oriented())
         {
-          RCLCPP_INFO_THROTTLE(
-            get_logger(), *this->get_clock(), 500, "Data not yet received from socket.");
-          rt_incoming_data_ = std::numeric_limits<double>::quiet_NaN();
+          RCLCPP_WARN(get_logger(), "Connection to the actuator closed.");
+          break;
         }
-
-        bzero(buffer, reading_size_bytes);
       }
       return hardware_interface::CallbackReturn::SUCCESS;
     });
@@ -196,7 +215,7 @@ hardware_interface::CallbackReturn RRBotSensorPositionFeedback::on_configure(
   last_measured_velocity_ = 0;
 
   // In general after a hardware is configured it can be read
-  last_timestamp_ = clock_.now();
+  last_read_ = std::chrono::steady_clock::now();
 
   RCLCPP_INFO(get_logger(), "Configuration successful.");
   return hardware_interface::CallbackReturn::SUCCESS;
@@ -205,21 +224,26 @@ hardware_interface::CallbackReturn RRBotSensorPositionFeedback::on_configure(
 hardware_interface::CallbackReturn RRBotSensorPositionFeedback::on_cleanup(
   const rclcpp_lifecycle::State & /*previous_state*/)
 {
-  // To stop the thread
+  // Wake the thread for incoming data, it stops as soon as it sees the event
+  if (wake_fd_ >= 0)
   {
-    std::lock_guard<std::mutex> lock(mtx);
-    receive_data_ = false;
-    shutdown(sock_, SHUT_RDWR);        // shutdown socket
-    shutdown(obj_socket_, SHUT_RDWR);  // shutdown socket
+    eventfd_write(wake_fd_, 1);
   }
-  cv.notify_all();
-
-  // stop reading thread
   if (incoming_data_thread_.joinable())
   {
     incoming_data_thread_.join();
   }
 
+  transport_.disconnect();
+  for (int * fd : {&epoll_fd_, &wake_fd_})
+  {
+    if (*fd >= 0)
+    {
+      close(*fd);
+      *fd = -1;
+    }
+  }
+
   return hardware_interface::CallbackReturn::SUCCESS;
 }
 
@@ -268,37 +292,76 @@ hardware_interface::CallbackReturn RRBotSensorPositionFeedback::on_deactivate(
 hardware_interface::return_type RRBotSensorPositionFeedback::read(
   const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
 {
-  current_timestamp = clock_.now();
-  rclcpp::Duration duration = current_timestamp - last_timestamp_;
-  last_timestamp_ = current_timestamp;
+  const auto now = std::chrono::steady_clock::now();
 
   // START: This part here is for exemplary purposes - Please do not copy to your production code
-  std::stringstream ss;
-  ss << "Reading..." << std::endl;
-
-  // Sensor reading
-  measured_velocity_ = rt_incoming_data_;
-  if (!std::isnan(measured_velocity_))
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, read_log_throttle_);
+  record.append("Reading...\n");
+
+  // Sensor reading: integrate every velocity since the previous read() from its arrival on
+  double distance = 0.0;
+  auto begin = last_read_;
+  size_t num_samples = 0;
+  VelocitySample sample;
+  while (incoming_samples_.pop(sample))
   {
-    last_measured_velocity_ = measured_velocity_;
+    // a sample may arrive between taking now and popping it, it counts from now on
+    const auto stamp = std::min(std::max(sample.stamp, begin), now);
+    distance += last_measured_velocity_ * std::chrono::duration<double>(stamp - begin).count();
+    last_measured_velocity_ = sample.velocity;
+    begin = stamp;
+    num_samples++;
   }
+  distance += last_measured_velocity_ * std::chrono::duration<double>(now - begin).count();
+  last_read_ = now;
 
   // integrate velocity to position
-  const auto name = info_.joints[0].name + "/" + hardware_interface::HW_IF_POSITION;
-  const auto new_value =
-    get_state(name) + (last_measured_velocity_ * duration.seconds()) / hw_slowdown_;
-  set_state(name, new_value);
-
-  ss << std::fixed << std::setprecision(2);
-  ss << "Got measured velocity " << measured_velocity_ << std::endl;
-  ss << "Got state(position) " << new_value << " for joint '" << info_.joints[0].name << "'"
-     << std::endl;
-  RCLCPP_INFO(get_logger(), "%s", ss.str().c_str());
+  const double new_value = position_state_.get() + distance / hw_slowdown_;
+  position_state_.set(new_value);
+
+  record.append(
+    "Got measured velocity %.2f from %zu samples\n", last_measured_velocity_, num_samples);
+  record.append(
+    "Got state(position) %.2f for joint '%s'\n", new_value, info_.joints[0].name.c_str());
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   return hardware_interface::return_type::OK;
 }
 
+bool RRBotSensorPositionFeedback::watch(int fd)
+{
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.fd = fd;
+  return epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+bool RRBotSensorPositionFeedback::wait_readable(int fd)
+{
+  epoll_event events[2];
+  while (true)
+  {
+    const int count = epoll_wait(epoll_fd_, events, 2, -1);
+    if (count < 0 && errno != EINTR)
+    {
+      return false;
+    }
+    bool readable = false;
+    for (int i = 0; i < count; i++)
+    {
+      if (events[i].data.fd == wake_fd_)
+      {
+        return false;
+      }
+      readable = readable || events[i].data.fd == fd;
+    }
+    if (readable)
+    {
+      return true;
+    }
+  }
+}
+
 }  // namespace ros2_control_demo_example_14
 
 #include "pluginlib/class_list_macros.hpp"
@@ -0,0 +1,280 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ros2_control_demo_example_14/transport.hpp"
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace ros2_control_demo_example_14
+{
+namespace
+{
+int socket_type(TransportType type)
+{
+  switch (type)
+  {
+    case TransportType::UDP:
+      return SOCK_DGRAM;
+    case TransportType::UNIX:
+      return SOCK_SEQPACKET;
+    case TransportType::TCP:
+    default:
+      return SOCK_STREAM;
+  }
+}
+
+/// \return the length of \p address, 0 if the path of a Unix socket is too long
+socklen_t make_address(const TransportConfig & config, sockaddr_storage & address)
+{
+  std::memset(&address, 0, sizeof(address));
+  if (config.type == TransportType::UNIX)
+  {
+    auto & unix_address = reinterpret_cast<sockaddr_un &>(address);
+    if (config.path.size() >= sizeof(unix_address.sun_path))
+    {
+      errno = ENAMETOOLONG;
+      return 0;
+    }
+    unix_address.sun_family = AF_UNIX;
+    std::memcpy(unix_address.sun_path, config.path.c_str(), config.path.size() + 1);
+    return sizeof(sockaddr_un);
+  }
+  auto & inet_address = reinterpret_cast<sockaddr_in &>(address);
+  inet_address.sin_family = AF_INET;
+  inet_address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  inet_address.sin_port = htons(config.port);
+  return sizeof(sockaddr_in);
+}
+
+bool set_option(int fd, int level, int option)
+{
+  const int enable = 1;
+  return setsockopt(fd, level, option, &enable, sizeof(enable)) == 0;
+}
+
+void close_fd(int & fd)
+{
+  if (fd >= 0)
+  {
+    // keep the error of the call that failed
+    const int error = errno;
+    ::close(fd);
+    errno = error;
+    fd = -1;
+  }
+}
+}  // namespace
+
+bool parse_transport_config(
+  const std::unordered_map<std::string, std::string> & parameters, TransportConfig & config)
+{
+  const auto transport = parameters.find("example_param_transport");
+  if (transport == parameters.end() || transport->second == "tcp")
+  {
+    config.type = TransportType::TCP;
+  }
+  else if (transport->second == "udp")
+  {
+    config.type = TransportType::UDP;
+  }
+  else if (transport->second == "unix")
+  {
+    config.type = TransportType::UNIX;
+  }
+  else
+  {
+    return false;
+  }
+
+  const auto port = parameters.find("example_param_socket_port");
+  if (port != parameters.end())
+  {
+    try
+    {
+      const int value = std::stoi(port->second);
+      if (value < 0 || value > UINT16_MAX)
+      {
+        return false;
+      }
+      config.port = static_cast<uint16_t>(value);
+    }
+    catch (const std::logic_error &)
+    {
+      return false;
+    }
+  }
+  else if (config.type != TransportType::UNIX)
+  {
+    return false;
+  }
+
+  const auto path = parameters.find("example_param_socket_path");
+  if (path != parameters.end())
+  {
+    config.path = path->second;
+  }
+  else if (port != parameters.end())
+  {
+    config.path = "/tmp/ros2_control_demo_example_14_" + std::to_string(config.port);
+  }
+  return config.type != TransportType::UNIX || !config.path.empty();
+}
+
+const char * transport_name(TransportType type)
+{
+  switch (type)
+  {
+    case TransportType::TCP:
+      return "tcp";
+    case TransportType::UDP:
+      return "udp";
+    case TransportType::UNIX:
+      return "unix";
+    default:
+      return "unknown";
+  }
+}
+
+std::string describe_transport(const TransportConfig & config)
+{
+  if (config.type == TransportType::UNIX)
+  {
+    return "unix socket " + config.path;
+  }
+  return std::string(transport_name(config.type)) + " port " + std::to_string(config.port);
+}
+
+bool Transport::bind()
+{
+  close();
+  sockaddr_storage address;
+  const socklen_t length = make_address(config_, address);
+  if (length == 0)
+  {
+    return false;
+  }
+
+  socket_fd_ =
+    socket(address.ss_family, socket_type(config_.type) | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (socket_fd_ < 0)
+  {
+    return false;
+  }
+  if (config_.type == TransportType::UNIX)
+  {
+    // a file left behind by a previous run would make bind() fail
+    unlink(config_.path.c_str());
+    bound_path_ = true;
+  }
+  else if (!set_option(socket_fd_, SOL_SOCKET, SO_REUSEADDR))
+  {
+    close();
+    return false;
+  }
+
+  if (
+    ::bind(socket_fd_, reinterpret_cast<sockaddr *>(&address), length) < 0 ||
+    (connection_oriented() && listen(socket_fd_, 1) < 0))
+  {
+    close();
+    return false;
+  }
+  return true;
+}
+
+bool Transport::accept()
+{
+  if (!connection_oriented())
+  {
+    return true;
+  }
+  disconnect();
+  connection_fd_ = accept4(socket_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+  if (connection_fd_ < 0)
+  {
+    return false;
+  }
+  if (config_.type == TransportType::TCP && !set_option(connection_fd_, IPPROTO_TCP, TCP_NODELAY))
+  {
+    close_fd(connection_fd_);
+    return false;
+  }
+  return true;
+}
+
+bool Transport::connect()
+{
+  close();
+  sockaddr_storage address;
+  const socklen_t length = make_address(config_, address);
+  if (length == 0)
+  {
+    return false;
+  }
+
+  socket_fd_ = socket(address.ss_family, socket_type(config_.type) | SOCK_CLOEXEC, 0);
+  if (
+    socket_fd_ < 0 ||
+    (config_.type == TransportType::TCP && !set_option(socket_fd_, IPPROTO_TCP, TCP_NODELAY)) ||
+    ::connect(socket_fd_, reinterpret_cast<sockaddr *>(&address), length) < 0)
+  {
+    close_fd(socket_fd_);
+    return false;
+  }
+  return true;
+}
+
+ssize_t Transport::send(const uint8_t * data, size_t size)
+{
+  return ::send(fd(), data, size, MSG_DONTWAIT | MSG_NOSIGNAL);
+}
+
+bool Transport::wait_writable(std::chrono::nanoseconds timeout) const
+{
+  const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+  const timespec timeout_spec{
+    static_cast<time_t>(seconds.count()), static_cast<long>((timeout - seconds).count())};
+  pollfd poll_fd{fd(), POLLOUT, 0};
+  return ppoll(&poll_fd, 1, &timeout_spec, nullptr) == 1 && (poll_fd.revents & POLLOUT);
+}
+
+ssize_t Transport::receive(uint8_t * data, size_t size)
+{
+  return recv(fd(), data, size, MSG_DONTWAIT);
+}
+
+void Transport::disconnect() { close_fd(connection_fd_); }
+
+void Transport::close()
+{
+  disconnect();
+  close_fd(socket_fd_);
+  if (bound_path_)
+  {
+    unlink(config_.path.c_str());
+    bound_path_ = false;
+  }
+}
+
+}  // namespace ros2_control_demo_example_14
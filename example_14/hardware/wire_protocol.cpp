@@ -0,0 +1,160 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ros2_control_demo_example_14/wire_protocol.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ros2_control_demo_example_14
+{
+namespace
+{
+constexpr size_t SESSION_OFFSET = sizeof(Frame::MAGIC);
+constexpr size_t SEQUENCE_OFFSET = SESSION_OFFSET + sizeof(uint32_t);
+constexpr size_t STAMP_OFFSET = SEQUENCE_OFFSET + sizeof(uint32_t);
+constexpr size_t VALUES_OFFSET = STAMP_OFFSET + sizeof(uint64_t);
+constexpr size_t CRC_OFFSET = VALUES_OFFSET + Frame::NUM_VALUES * sizeof(double);
+static_assert(CRC_OFFSET + sizeof(uint32_t) == Frame::SIZE, "inconsistent frame layout");
+
+struct Crc32Table
+{
+  uint32_t entries[256];
+
+  constexpr Crc32Table() : entries()
+  {
+    for (uint32_t i = 0; i < 256; i++)
+    {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; bit++)
+      {
+        crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320u : crc >> 1;
+      }
+      entries[i] = crc;
+    }
+  }
+};
+
+constexpr Crc32Table CRC32_TABLE;
+}  // namespace
+
+uint32_t crc32(const uint8_t * data, size_t size)
+{
+  uint32_t crc = 0xffffffffu;
+  for (size_t i = 0; i < size; i++)
+  {
+    crc = CRC32_TABLE.entries[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  }
+  return crc ^ 0xffffffffu;
+}
+
+void encode(const Frame & frame, uint8_t * buffer)
+{
+  std::memcpy(buffer, Frame::MAGIC, sizeof(Frame::MAGIC));
+  std::memcpy(buffer + SESSION_OFFSET, &frame.session, sizeof(frame.session));
+  std::memcpy(buffer + SEQUENCE_OFFSET, &frame.sequence, sizeof(frame.sequence));
+  std::memcpy(buffer + STAMP_OFFSET, &frame.stamp_ns, sizeof(frame.stamp_ns));
+  std::memcpy(buffer + VALUES_OFFSET, frame.values.data(), Frame::NUM_VALUES * sizeof(double));
+  const uint32_t crc = crc32(buffer, CRC_OFFSET);
+  std::memcpy(buffer + CRC_OFFSET, &crc, sizeof(crc));
+}
+
+bool decode(const uint8_t * buffer, Frame & frame)
+{
+  uint32_t crc;
+  std::memcpy(&crc, buffer + CRC_OFFSET, sizeof(crc));
+  if (
+    std::memcmp(buffer, Frame::MAGIC, sizeof(Frame::MAGIC)) != 0 ||
+    crc != crc32(buffer, CRC_OFFSET))
+  {
+    return false;
+  }
+  std::memcpy(&frame.session, buffer + SESSION_OFFSET, sizeof(frame.session));
+  std::memcpy(&frame.sequence, buffer + SEQUENCE_OFFSET, sizeof(frame.sequence));
+  std::memcpy(&frame.stamp_ns, buffer + STAMP_OFFSET, sizeof(frame.stamp_ns));
+  std::memcpy(frame.values.data(), buffer + VALUES_OFFSET, Frame::NUM_VALUES * sizeof(double));
+  return true;
+}
+
+bool FrameDecoder::push(uint8_t byte, Frame & frame)
+{
+  buffer_[buffered_++] = byte;
+  if (buffered_ <= sizeof(Frame::MAGIC))
+  {
+    if (byte != Frame::MAGIC[buffered_ - 1])
+    {
+      resync(1);
+    }
+    return false;
+  }
+  if (buffered_ < Frame::SIZE)
+  {
+    return false;
+  }
+
+  if (!decode(buffer_.data(), frame))
+  {
+    crc_errors_++;
+    resync(1);
+    return false;
+  }
+  buffered_ = 0;
+
+  // the sender was restarted, e.g. cleaned up and configured again while a connectionless
+  // transport kept the decoder alive: its sequence numbers start over
+  if (has_sequence_ && frame.session != session_)
+  {
+    restarts_++;
+    has_sequence_ = false;
+  }
+
+  // the difference as signed number survives the wrap-around of the sequence number
+  const auto ahead = static_cast<int32_t>(frame.sequence - next_sequence_);
+  if (has_sequence_ && ahead < 0)
+  {
+    sequence_errors_++;
+    return false;
+  }
+  if (has_sequence_)
+  {
+    lost_frames_ += static_cast<size_t>(ahead);
+  }
+  has_sequence_ = true;
+  session_ = frame.session;
+  next_sequence_ = frame.sequence + 1;
+  return true;
+}
+
+void FrameDecoder::reset()
+{
+  buffered_ = 0;
+  has_sequence_ = false;
+  next_sequence_ = 0;
+}
+
+void FrameDecoder::resync(size_t offset)
+{
+  for (; offset < buffered_; offset++)
+  {
+    const size_t size = std::min(buffered_ - offset, sizeof(Frame::MAGIC));
+    if (std::memcmp(buffer_.data() + offset, Frame::MAGIC, size) == 0)
+    {
+      break;
+    }
+  }
+  std::memmove(buffer_.data(), buffer_.data() + offset, buffered_ - offset);
+  buffered_ -= offset;
+}
+
+}  // namespace ros2_control_demo_example_14
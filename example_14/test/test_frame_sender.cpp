@@ -0,0 +1,158 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <sys/socket.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "ros2_control_demo_example_14/frame_sender.hpp"
+
+using ros2_control_demo_example_14::encode;
+using ros2_control_demo_example_14::Frame;
+using ros2_control_demo_example_14::FrameDecoder;
+using ros2_control_demo_example_14::FrameSender;
+using ros2_control_demo_example_14::Transport;
+using ros2_control_demo_example_14::TransportConfig;
+using ros2_control_demo_example_14::TransportType;
+
+namespace
+{
+class TestFrameSender : public ::testing::Test
+{
+protected:
+  void open(TransportType type)
+  {
+    TransportConfig config;
+    config.type = type;
+    config.port = 23397;
+    config.path = "/tmp/ros2_control_demo_example_14_test_frame_sender";
+    receiver_.set_config(config);
+    link_.set_config(config);
+    ASSERT_TRUE(receiver_.bind());
+    // small socket buffers fill up after a few frames, the accepted socket inherits them
+    const int buffer_size = 4096;
+    setsockopt(receiver_.fd(), SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+    ASSERT_TRUE(link_.connect());
+    setsockopt(link_.fd(), SOL_SOCKET, SO_SNDBUF, &buffer_size, sizeof(buffer_size));
+    bool accepted = false;
+    for (int i = 0; i < 1000 && !accepted; i++)
+    {
+      accepted = receiver_.accept();
+      std::this_thread::sleep_for(std::chrono::milliseconds(accepted ? 0 : 1));
+    }
+    ASSERT_TRUE(accepted);
+  }
+
+  FrameSender::Result send(std::chrono::steady_clock::duration timeout)
+  {
+    Frame frame;
+    frame.sequence = next_sequence_++;
+    frame.values[0] = frame.sequence;
+    uint8_t buffer[Frame::SIZE];
+    encode(frame, buffer);
+    return sender_.send(link_, buffer, std::chrono::steady_clock::now() + timeout);
+  }
+
+  // sends without waiting until frames keep being dropped because nobody receives them
+  void fill()
+  {
+    int dropped_in_a_row = 0;
+    for (int i = 0; i < 100000 && dropped_in_a_row < 100; i++)
+    {
+      const auto result = send(std::chrono::steady_clock::duration::zero());
+      dropped_in_a_row = result == FrameSender::Result::DROPPED ? dropped_in_a_row + 1 : 0;
+      if (dropped_in_a_row == 0)
+      {
+        std::this_thread::yield();
+      }
+    }
+    ASSERT_EQ(dropped_in_a_row, 100);
+  }
+
+  void receive()
+  {
+    uint8_t data[4096];
+    ssize_t size;
+    while ((size = receiver_.receive(data, sizeof(data))) > 0)
+    {
+      decoder_.feed(data, static_cast<size_t>(size), [this](const Frame & frame) {
+        received_.push_back(frame);
+      });
+    }
+  }
+
+  Transport receiver_;
+  Transport link_;
+  FrameSender sender_;
+  uint32_t next_sequence_ = 0;
+  FrameDecoder decoder_;
+  std::vector<Frame> received_;
+};
+}  // namespace
+
+TEST_F(TestFrameSender, drops_frames_instead_of_blocking)
+{
+  open(TransportType::TCP);
+  const auto begin = std::chrono::steady_clock::now();
+  fill();
+  EXPECT_LT(std::chrono::steady_clock::now() - begin, std::chrono::seconds(1));
+
+  // once the receiver catches up, the newest frames get through again
+  FrameSender::Result result = FrameSender::Result::DROPPED;
+  for (int i = 0; i < 1000 && result != FrameSender::Result::SENT; i++)
+  {
+    receive();
+    result = send(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(result, FrameSender::Result::SENT);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  receive();
+
+  // partially sent frames were completed, so the stream stayed in sync
+  EXPECT_EQ(decoder_.crc_errors(), 0u);
+  EXPECT_EQ(decoder_.sequence_errors(), 0u);
+  EXPECT_EQ(decoder_.lost_frames(), sender_.dropped());
+  EXPECT_EQ(received_.size(), next_sequence_ - sender_.dropped());
+  EXPECT_EQ(received_.back().sequence, next_sequence_ - 1);
+}
+
+TEST_F(TestFrameSender, waits_until_deadline_at_most)
+{
+  // a full Unix socket has no room until the receiver reads, TCP probes for more room meanwhile
+  open(TransportType::UNIX);
+  fill();
+  const auto begin = std::chrono::steady_clock::now();
+  const auto result = send(std::chrono::milliseconds(20));
+  const auto elapsed = std::chrono::steady_clock::now() - begin;
+  EXPECT_EQ(result, FrameSender::Result::DROPPED);
+  EXPECT_GE(elapsed, std::chrono::milliseconds(20));
+  EXPECT_LT(elapsed, std::chrono::milliseconds(500));
+}
+
+TEST_F(TestFrameSender, drops_frames_on_closed_link)
+{
+  open(TransportType::TCP);
+  receiver_.close();
+  FrameSender::Result result = FrameSender::Result::SENT;
+  const auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < 10; i++)
+  {
+    result = send(std::chrono::milliseconds(100));
+  }
+  EXPECT_EQ(result, FrameSender::Result::DROPPED);
+  EXPECT_LT(std::chrono::steady_clock::now() - begin, std::chrono::milliseconds(100));
+}
@@ -0,0 +1,87 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <poll.h>
+#include <string>
+#include <unordered_map>
+
+#include "ros2_control_demo_example_14/transport.hpp"
+
+using ros2_control_demo_example_14::parse_transport_config;
+using ros2_control_demo_example_14::Transport;
+using ros2_control_demo_example_14::TransportConfig;
+using ros2_control_demo_example_14::TransportType;
+
+namespace
+{
+bool wait_readable(const Transport & transport)
+{
+  pollfd fd{transport.fd(), POLLIN, 0};
+  return poll(&fd, 1, 1000) == 1;
+}
+}  // namespace
+
+TEST(TestTransport, parses_hardware_parameters)
+{
+  TransportConfig config;
+  ASSERT_TRUE(parse_transport_config({{"example_param_socket_port", "23286"}}, config));
+  EXPECT_EQ(config.type, TransportType::TCP);
+  EXPECT_EQ(config.port, 23286);
+
+  ASSERT_TRUE(parse_transport_config(
+    {{"example_param_transport", "unix"}, {"example_param_socket_port", "23286"}}, config));
+  EXPECT_EQ(config.type, TransportType::UNIX);
+  EXPECT_EQ(config.path, "/tmp/ros2_control_demo_example_14_23286");
+
+  ASSERT_TRUE(parse_transport_config(
+    {{"example_param_transport", "unix"}, {"example_param_socket_path", "/tmp/rrbot"}}, config));
+  EXPECT_EQ(config.path, "/tmp/rrbot");
+
+  EXPECT_FALSE(parse_transport_config(
+    {{"example_param_transport", "can"}, {"example_param_socket_port", "23286"}}, config));
+  EXPECT_FALSE(parse_transport_config({{"example_param_transport", "udp"}}, config));
+  EXPECT_FALSE(parse_transport_config({{"example_param_socket_port", "70000"}}, config));
+}
+
+TEST(TestTransport, sends_over_each_transport)
+{
+  for (const TransportType type : {TransportType::TCP, TransportType::UDP, TransportType::UNIX})
+  {
+    TransportConfig config;
+    config.type = type;
+    config.port = 23396;
+    config.path = "/tmp/ros2_control_demo_example_14_test_transport";
+    Transport receiver(config);
+    Transport sender(config);
+    ASSERT_TRUE(receiver.bind()) << transport_name(type);
+    ASSERT_TRUE(sender.connect()) << transport_name(type);
+    if (receiver.connection_oriented())
+    {
+      ASSERT_TRUE(wait_readable(receiver));
+      ASSERT_TRUE(receiver.accept());
+    }
+
+    const uint8_t sent[] = {1, 2, 3};
+    EXPECT_EQ(sender.send(sent, sizeof(sent)), 3);
+    ASSERT_TRUE(wait_readable(receiver)) << transport_name(type);
+    uint8_t received[8];
+    EXPECT_EQ(receiver.receive(received, sizeof(received)), 3);
+    EXPECT_EQ(received[2], 3);
+
+    // nothing more to receive, but the socket doesn't block
+    EXPECT_LT(receiver.receive(received, sizeof(received)), 0);
+  }
+}
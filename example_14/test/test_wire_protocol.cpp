@@ -0,0 +1,139 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "ros2_control_demo_example_14/wire_protocol.hpp"
+
+using ros2_control_demo_example_14::Frame;
+using ros2_control_demo_example_14::FrameDecoder;
+
+namespace
+{
+std::vector<uint8_t> encode_frames(uint32_t first_sequence, size_t count, uint32_t session = 0)
+{
+  std::vector<uint8_t> bytes(count * Frame::SIZE);
+  for (size_t i = 0; i < count; i++)
+  {
+    Frame frame;
+    frame.session = session;
+    frame.sequence = first_sequence + static_cast<uint32_t>(i);
+    frame.stamp_ns = 1000 * i;
+    frame.values[0] = 0.5 * static_cast<double>(i);
+    ros2_control_demo_example_14::encode(frame, bytes.data() + i * Frame::SIZE);
+  }
+  return bytes;
+}
+
+std::vector<Frame> feed(FrameDecoder & decoder, const std::vector<uint8_t> & bytes, size_t chunk)
+{
+  std::vector<Frame> frames;
+  for (size_t i = 0; i < bytes.size(); i += chunk)
+  {
+    decoder.feed(
+      bytes.data() + i, std::min(chunk, bytes.size() - i),
+      [&frames](const Frame & frame) { frames.push_back(frame); });
+  }
+  return frames;
+}
+}  // namespace
+
+TEST(TestWireProtocol, crc32_matches_reference)
+{
+  const uint8_t data[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  EXPECT_EQ(ros2_control_demo_example_14::crc32(data, sizeof(data)), 0xcbf43926u);
+}
+
+TEST(TestWireProtocol, decodes_merged_and_split_frames)
+{
+  const auto bytes = encode_frames(7, 10);
+  // merged into one chunk, split in the middle of frames and byte by byte
+  for (const size_t chunk : {bytes.size(), size_t(5), size_t(1)})
+  {
+    FrameDecoder decoder;
+    const auto frames = feed(decoder, bytes, chunk);
+    ASSERT_EQ(frames.size(), 10u) << "chunk " << chunk;
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+      EXPECT_EQ(frames[i].sequence, 7 + i);
+      EXPECT_EQ(frames[i].stamp_ns, 1000 * i);
+      EXPECT_DOUBLE_EQ(frames[i].values[0], 0.5 * static_cast<double>(i));
+    }
+    EXPECT_EQ(decoder.crc_errors(), 0u);
+    EXPECT_EQ(decoder.lost_frames(), 0u);
+  }
+}
+
+TEST(TestWireProtocol, skips_garbage_and_corrupt_frames)
+{
+  auto bytes = encode_frames(0, 3);
+  // a bit flip in the value of the second frame and garbage including the start of the magic
+  bytes[Frame::SIZE + Frame::SIZE - 6] ^= 0x10;
+  const std::vector<uint8_t> garbage = {'x', 'R', 'R', 'y', 0};
+  bytes.insert(bytes.begin() + Frame::SIZE, garbage.begin(), garbage.end());
+  bytes.insert(bytes.begin(), garbage.begin(), garbage.end());
+
+  FrameDecoder decoder;
+  const auto frames = feed(decoder, bytes, 3);
+  ASSERT_EQ(frames.size(), 2u);
+  EXPECT_EQ(frames[0].sequence, 0u);
+  EXPECT_EQ(frames[1].sequence, 2u);
+  EXPECT_EQ(decoder.crc_errors(), 1u);
+  EXPECT_EQ(decoder.lost_frames(), 1u);
+}
+
+TEST(TestWireProtocol, rejects_old_sequence_numbers)
+{
+  auto bytes = encode_frames(UINT32_MAX - 1, 3);
+  // a repeated frame, then a reordered one
+  const auto repeated = encode_frames(0, 1);
+  const auto reordered = encode_frames(UINT32_MAX - 1, 1);
+  bytes.insert(bytes.end(), repeated.begin(), repeated.end());
+  bytes.insert(bytes.end(), reordered.begin(), reordered.end());
+
+  FrameDecoder decoder;
+  const auto frames = feed(decoder, bytes, bytes.size());
+  // the sequence wraps around from UINT32_MAX to 0
+  ASSERT_EQ(frames.size(), 3u);
+  EXPECT_EQ(frames[2].sequence, 0u);
+  EXPECT_EQ(decoder.sequence_errors(), 2u);
+
+  decoder.reset();
+  EXPECT_EQ(feed(decoder, reordered, 1).size(), 1u);
+}
+
+TEST(TestWireProtocol, accepts_restarted_sender)
+{
+  // the sender was configured again after a long run and starts its sequence over
+  auto bytes = encode_frames(360000, 3, 1);
+  const auto restarted = encode_frames(0, 3, 2);
+  bytes.insert(bytes.end(), restarted.begin(), restarted.end());
+
+  FrameDecoder decoder;
+  const auto frames = feed(decoder, bytes, 7);
+  ASSERT_EQ(frames.size(), 6u);
+  EXPECT_EQ(frames[3].session, 2u);
+  EXPECT_EQ(frames[3].sequence, 0u);
+  EXPECT_EQ(frames[5].sequence, 2u);
+  EXPECT_EQ(decoder.restarts(), 1u);
+  EXPECT_EQ(decoder.sequence_errors(), 0u);
+  EXPECT_EQ(decoder.lost_frames(), 0u);
+
+  // within the new session old sequence numbers are rejected again
+  EXPECT_EQ(feed(decoder, encode_frames(1, 1, 2), 1).size(), 0u);
+  EXPECT_EQ(decoder.sequence_errors(), 1u);
+}
@@ -15,6 +15,7 @@
 #ifndef ROS2_CONTROL_DEMO_EXAMPLE_16__DIFFBOT_SYSTEM_HPP_
 #define ROS2_CONTROL_DEMO_EXAMPLE_16__DIFFBOT_SYSTEM_HPP_
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -29,6 +30,8 @@
 #include "rclcpp/time.hpp"
 #include "rclcpp_lifecycle/node_interfaces/lifecycle_node_interface.hpp"
 #include "rclcpp_lifecycle/state.hpp"
+#include "ros2_control_demo_utils/interface_handles.hpp"
+#include "ros2_control_demo_utils/realtime_logger.hpp"
 
 namespace ros2_control_demo_example_16
 {
@@ -59,6 +62,15 @@ private:
   // Parameters for the DiffBot simulation
   double hw_start_sec_;
   double hw_stop_sec_;
+
+  // wheel interfaces looked up in on_configure(), in the order of the joints
+  std::vector<ros2_control_demo_utils::StateHandle> position_states_;
+  std::vector<ros2_control_demo_utils::StateHandle> velocity_states_;
+  std::vector<ros2_control_demo_utils::CommandHandle> velocity_commands_;
+
+  ros2_control_demo_utils::RealtimeLogger rt_logger_;
+  ros2_control_demo_utils::LogThrottle read_log_throttle_{std::chrono::milliseconds(500)};
+  ros2_control_demo_utils::LogThrottle write_log_throttle_{std::chrono::milliseconds(500)};
 };
 
 }  // namespace ros2_control_demo_example_16
@@ -15,6 +15,7 @@
 #ifndef ROS2_CONTROL_DEMO_EXAMPLE_17__RRBOT_HPP_
 #define ROS2_CONTROL_DEMO_EXAMPLE_17__RRBOT_HPP_
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -28,6 +29,10 @@
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp_lifecycle/node_interfaces/lifecycle_node_interface.hpp"
 #include "rclcpp_lifecycle/state.hpp"
+#include "ros2_control_demo_utils/cycle_instrumentation.hpp"
+#include "ros2_control_demo_utils/interface_handles.hpp"
+#include "ros2_control_demo_utils/realtime_logger.hpp"
+#include "ros2_control_demo_utils/simulated_actuator_bank.hpp"
 #include "std_msgs/msg/string.hpp"
 
 namespace ros2_control_demo_example_17
@@ -49,6 +54,9 @@ public:
   hardware_interface::CallbackReturn on_deactivate(
     const rclcpp_lifecycle::State & previous_state) override;
 
+  std::vector<hardware_interface::InterfaceDescription>
+  export_unlisted_state_interface_descriptions() override;
+
   hardware_interface::return_type read(
     const rclcpp::Time & time, const rclcpp::Duration & period) override;
 
@@ -67,6 +75,18 @@ private:
   double hw_stop_sec_;
   double hw_slowdown_;
 
+  // simulated joints and their position interfaces, in the order of the joints
+  ros2_control_demo_utils::SimulatedActuatorBank actuators_;
+  std::vector<ros2_control_demo_utils::StateHandle> position_states_;
+  std::vector<ros2_control_demo_utils::CommandHandle> position_commands_;
+
+  // timing of read() and write(), exported as state interfaces and diagnostics
+  ros2_control_demo_utils::CycleInstrumentation instrumentation_;
+
+  ros2_control_demo_utils::RealtimeLogger rt_logger_;
+  ros2_control_demo_utils::LogThrottle read_log_throttle_{std::chrono::milliseconds(500)};
+  ros2_control_demo_utils::LogThrottle write_log_throttle_{std::chrono::milliseconds(500)};
+
   std::shared_ptr<diagnostic_updater::Updater> updater_;
   void produce_diagnostics(diagnostic_updater::DiagnosticStatusWrapper & stat);
 
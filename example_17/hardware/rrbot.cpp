@@ -16,10 +16,8 @@
 
 #include <chrono>
 #include <cmath>
-#include <iomanip>
 #include <limits>
 #include <memory>
-#include <sstream>
 #include <string>
 #include <vector>
 
@@ -39,6 +37,11 @@ hardware_interface::CallbackReturn RRBotSystemPositionOnlyHardware::on_init(
     return hardware_interface::CallbackReturn::ERROR;
   }
 
+  // log messages of read() and write() are formatted outside of the realtime loop
+  rt_logger_.configure(get_logger());
+  // read() and write() are expected at the rate the controller manager runs this component
+  instrumentation_.configure(get_hardware_info().name, get_hardware_info().rw_rate);
+
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
   hw_start_sec_ =
     stod(get_hardware_info().hardware_parameters.at("example_param_hw_start_duration_sec"));
@@ -109,7 +112,36 @@ hardware_interface::CallbackReturn RRBotSystemPositionOnlyHardware::on_init(
 void RRBotSystemPositionOnlyHardware::produce_diagnostics(
   diagnostic_updater::DiagnosticStatusWrapper & stat)
 {
-  stat.summary(diagnostic_msgs::msg::DiagnosticStatus::OK, "Hardware is OK");
+  using ros2_control_demo_utils::CycleInstrumentation;
+  for (const auto metric :
+       {CycleInstrumentation::READ_DURATION, CycleInstrumentation::WRITE_DURATION,
+        CycleInstrumentation::PERIOD_JITTER})
+  {
+    const auto summary = instrumentation_.summary(metric);
+    const std::string name = CycleInstrumentation::metric_name(metric);
+    stat.add(name + " min [us]", summary.min * 1e6);
+    stat.add(name + " max [us]", summary.max * 1e6);
+    stat.add(name + " p99 [us]", summary.p99 * 1e6);
+    stat.add(name + " p99.9 [us]", summary.p99_9 * 1e6);
+  }
+
+  const auto jitter = instrumentation_.summary(CycleInstrumentation::PERIOD_JITTER);
+  if (jitter.p99_9 > 0.5 * instrumentation_.expected_period())
+  {
+    stat.summary(
+      diagnostic_msgs::msg::DiagnosticStatus::WARN, "Period jitters by more than half a period");
+  }
+  else
+  {
+    stat.summary(diagnostic_msgs::msg::DiagnosticStatus::OK, "Hardware is OK");
+  }
+}
+
+std::vector<hardware_interface::InterfaceDescription>
+RRBotSystemPositionOnlyHardware::export_unlisted_state_interface_descriptions()
+{
+  // the cycle statistics are state interfaces in addition to the ones of the URDF
+  return instrumentation_.state_interface_descriptions();
 }
 
 hardware_interface::CallbackReturn RRBotSystemPositionOnlyHardware::on_configure(
@@ -134,6 +166,34 @@ hardware_interface::CallbackReturn RRBotSystemPositionOnlyHardware::on_configure
   {
     set_command(name, 0.0);
   }
+
+  // the simulation steps all joints at once, on interfaces looked up here
+  ros2_control_demo_utils::HandleResolver resolver;
+  resolver.add_states(joint_states_);
+  resolver.add_states(unlisted_states_);
+  resolver.add_commands(joint_commands_);
+  position_states_.resize(get_hardware_info().joints.size());
+  position_commands_.resize(get_hardware_info().joints.size());
+  for (size_t i = 0; i < get_hardware_info().joints.size(); i++)
+  {
+    const auto name = get_hardware_info().joints[i].name + "/" + hardware_interface::HW_IF_POSITION;
+    if (
+      !resolver.resolve_state(name, position_states_[i]) ||
+      !resolver.resolve_command(name, position_commands_[i]))
+    {
+      RCLCPP_FATAL(
+        get_logger(), "Failed to look up the position interfaces of joint '%s'.",
+        get_hardware_info().joints[i].name.c_str());
+      return hardware_interface::CallbackReturn::ERROR;
+    }
+  }
+  actuators_.resize(get_hardware_info().joints.size(), hw_slowdown_);
+  if (!instrumentation_.resolve_state_interfaces(resolver))
+  {
+    RCLCPP_FATAL(get_logger(), "Failed to look up the state interfaces of the cycle statistics.");
+    return hardware_interface::CallbackReturn::ERROR;
+  }
+
   RCLCPP_INFO(get_logger(), "Successfully configured!");
 
   // Get Default Node added to executor
@@ -245,6 +305,7 @@ hardware_interface::CallbackReturn RRBotSystemPositionOnlyHardware::on_activate(
   {
     set_command(name, get_state(name));
   }
+  instrumentation_.reset();
 
   RCLCPP_INFO(get_logger(), "Successfully activated!");
 
@@ -270,21 +331,26 @@ hardware_interface::CallbackReturn RRBotSystemPositionOnlyHardware::on_deactivat
 }
 
 hardware_interface::return_type RRBotSystemPositionOnlyHardware::read(
-  const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
+  const rclcpp::Time & /*time*/, const rclcpp::Duration & period)
 {
+  const auto timer = instrumentation_.time_read();
+
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
-  std::stringstream ss;
-  ss << "Reading states:";
+  // Simulate RRBot's movement
+  actuators_.read_commands(position_commands_);
+  actuators_.step(period.seconds());
+  actuators_.write_positions(position_states_);
 
-  for (const auto & [name, descr] : joint_state_interfaces_)
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, read_log_throttle_);
+  if (record)
   {
-    // Simulate RRBot's movement
-    auto new_value = get_state(name) + (get_command(name) - get_state(name)) / hw_slowdown_;
-    set_state(name, new_value);
-    ss << std::fixed << std::setprecision(2) << std::endl
-       << "\t" << get_state(name) << " for joint '" << name << "'";
+    record.append("Reading states:");
+    for (size_t i = 0; i < position_states_.size(); i++)
+    {
+      record.append(
+        "\n\t%.2f for joint '%s'", actuators_.positions()[i], position_states_[i].name().c_str());
+    }
   }
-  RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 500, "%s", ss.str().c_str());
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   return hardware_interface::return_type::OK;
@@ -293,17 +359,19 @@ hardware_interface::return_type RRBotSystemPositionOnlyHardware::read(
 hardware_interface::return_type RRBotSystemPositionOnlyHardware::write(
   const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
 {
-  // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
-  std::stringstream ss;
-  ss << "Writing commands:";
+  const auto timer = instrumentation_.time_write();
 
-  for (const auto & [name, descr] : joint_command_interfaces_)
+  // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
+  // Simulate sending commands to the hardware, nothing is looked up while the record is throttled
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, write_log_throttle_);
+  if (record)
   {
-    // Simulate sending commands to the hardware
-    ss << std::fixed << std::setprecision(2) << std::endl
-       << "\t" << get_command(name) << " for joint '" << name << "'";
+    record.append("Writing commands:");
+    for (const auto & command : position_commands_)
+    {
+      record.append("\n\t%.2f for joint '%s'", command.get(), command.name().c_str());
+    }
   }
-  RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 500, "%s", ss.str().c_str());
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   return hardware_interface::return_type::OK;
@@ -17,10 +17,8 @@
 #include <chrono>
 #include <cmath>
 #include <cstddef>
-#include <iomanip>
 #include <limits>
 #include <memory>
-#include <sstream>
 #include <vector>
 
 #include "hardware_interface/lexical_casts.hpp"
@@ -39,6 +37,9 @@ hardware_interface::CallbackReturn DiffBotSystemHardware::on_init(
     return hardware_interface::CallbackReturn::ERROR;
   }
 
+  // log messages of read() and write() are formatted outside of the realtime loop
+  rt_logger_.configure(get_logger());
+
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
   hw_start_sec_ =
     hardware_interface::stod(info_.hardware_parameters["example_param_hw_start_duration_sec"]);
@@ -118,6 +119,28 @@ hardware_interface::CallbackReturn DiffBotSystemHardware::on_configure(
   {
     set_command(name, 0.0);
   }
+
+  // read() and write() access the wheels through handles instead of by name
+  ros2_control_demo_utils::HandleResolver resolver;
+  resolver.add_states(joint_states_);
+  resolver.add_commands(joint_commands_);
+  position_states_.resize(info_.joints.size());
+  velocity_states_.resize(info_.joints.size());
+  velocity_commands_.resize(info_.joints.size());
+  for (size_t i = 0; i < info_.joints.size(); i++)
+  {
+    const auto & joint = info_.joints[i].name;
+    const auto position = joint + "/" + hardware_interface::HW_IF_POSITION;
+    const auto velocity = joint + "/" + hardware_interface::HW_IF_VELOCITY;
+    if (
+      !resolver.resolve_state(position, position_states_[i]) ||
+      !resolver.resolve_state(velocity, velocity_states_[i]) ||
+      !resolver.resolve_command(velocity, velocity_commands_[i]))
+    {
+      RCLCPP_FATAL(get_logger(), "Failed to look up the interfaces of joint '%s'.", joint.c_str());
+      return hardware_interface::CallbackReturn::ERROR;
+    }
+  }
   RCLCPP_INFO(get_logger(), "Successfully configured!");
 
   return hardware_interface::CallbackReturn::SUCCESS;
@@ -169,25 +192,21 @@ hardware_interface::return_type DiffBotSystemHardware::read(
   const rclcpp::Time & /*time*/, const rclcpp::Duration & period)
 {
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
-  std::stringstream ss;
-  ss << "Reading states:";
-  ss << std::fixed << std::setprecision(2);
-  for (const auto & [name, descr] : joint_state_interfaces_)
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, read_log_throttle_);
+  record.append("Reading states:");
+  for (size_t i = 0; i < position_states_.size(); i++)
   {
-    if (descr.get_interface_name() == hardware_interface::HW_IF_POSITION)
-    {
-      // Simulate DiffBot wheels's movement as a first-order system
-      // Update the joint status: this is a revolute joint without any limit.
-      // Simply integrates
-      auto velo = get_command(descr.get_prefix_name() + "/" + hardware_interface::HW_IF_VELOCITY);
-      set_state(name, get_state(name) + period.seconds() * velo);
-
-      ss << std::endl
-         << "\t position " << get_state(name) << " and velocity " << velo << " for '" << name
-         << "'!";
-    }
+    // Simulate DiffBot wheels's movement as a first-order system
+    // Update the joint status: this is a revolute joint without any limit.
+    // Simply integrates
+    const double velo = velocity_commands_[i].get();
+    const double position = position_states_[i].get() + period.seconds() * velo;
+    position_states_[i].set(position);
+
+    record.append(
+      "\n\t position %.2f and velocity %.2f for '%s'!", position, velo,
+      position_states_[i].name().c_str());
   }
-  RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 500, "%s", ss.str().c_str());
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   return hardware_interface::return_type::OK;
@@ -197,17 +216,16 @@ hardware_interface::return_type ros2_control_demo_example_2 ::DiffBotSystemHardw
   const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
 {
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
-  std::stringstream ss;
-  ss << "Writing commands:";
-  for (const auto & [name, descr] : joint_command_interfaces_)
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, write_log_throttle_);
+  record.append("Writing commands:");
+  for (size_t i = 0; i < velocity_commands_.size(); i++)
   {
     // Simulate sending commands to the hardware
-    set_state(name, get_command(name));
+    const double command = velocity_commands_[i].get();
+    velocity_states_[i].set(command);
 
-    ss << std::fixed << std::setprecision(2) << std::endl
-       << "\t" << "command " << get_command(name) << " for '" << name << "'!";
+    record.append("\n\tcommand %.2f for '%s'!", command, velocity_commands_[i].name().c_str());
   }
-  RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 500, "%s", ss.str().c_str());
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   return hardware_interface::return_type::OK;
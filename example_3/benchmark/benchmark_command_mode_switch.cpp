@@ -0,0 +1,131 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "ros2_control_demo_example_3/command_mode_index.hpp"
+
+using ros2_control_demo_example_3::CommandModeIndex;
+
+namespace
+{
+const std::vector<std::string> MODES = {"position", "velocity", "acceleration"};
+
+/// Joints and modes of a switch by comparing with the names of all joints, as done before.
+void resolve_by_search(
+  const std::vector<std::string> & joint_names, const std::vector<std::string> & start_interfaces,
+  const std::vector<std::string> & stop_interfaces, std::vector<size_t> & new_modes,
+  std::vector<bool> & stopped)
+{
+  new_modes.clear();
+  for (const std::string & key : start_interfaces)
+  {
+    for (size_t i = 0; i < joint_names.size(); i++)
+    {
+      for (size_t mode = 0; mode < MODES.size(); mode++)
+      {
+        if (key == joint_names[i] + "/" + MODES[mode])
+        {
+          new_modes.push_back(mode);
+        }
+      }
+    }
+  }
+  for (const std::string & key : stop_interfaces)
+  {
+    for (size_t i = 0; i < joint_names.size(); i++)
+    {
+      if (key.find(joint_names[i]) != std::string::npos)
+      {
+        stopped[i] = true;
+      }
+    }
+  }
+}
+
+/// Joints and modes of a switch by the CommandModeIndex.
+void resolve_by_index(
+  const CommandModeIndex & index, const std::vector<std::string> & start_interfaces,
+  const std::vector<std::string> & stop_interfaces, std::vector<size_t> & new_modes,
+  std::vector<bool> & stopped)
+{
+  for (const std::string & key : start_interfaces)
+  {
+    if (const auto * entry = index.find(key))
+    {
+      new_modes[entry->joint] = entry->mode;
+    }
+  }
+  for (const std::string & key : stop_interfaces)
+  {
+    if (const auto * entry = index.find(key))
+    {
+      stopped[entry->joint] = true;
+    }
+  }
+}
+
+/// Median time in microseconds of \p count calls of \p resolve.
+template <typename Resolve>
+double measure(size_t count, Resolve && resolve)
+{
+  std::vector<double> times;
+  for (size_t i = 0; i < count; i++)
+  {
+    const auto begin = std::chrono::steady_clock::now();
+    resolve();
+    const std::chrono::duration<double, std::micro> time = std::chrono::steady_clock::now() - begin;
+    times.push_back(time.count());
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+}  // namespace
+
+// Time of resolving a mode switch of all joints from position to velocity, once by searching
+// the joint names for every interface and once with the CommandModeIndex.
+int main(int argc, char ** argv)
+{
+  const size_t num_joints = argc > 1 ? std::stoul(argv[1]) : 1000;
+  const size_t count = argc > 2 ? std::stoul(argv[2]) : 20;
+
+  std::vector<std::string> joint_names, start_interfaces, stop_interfaces;
+  for (size_t i = 0; i < num_joints; i++)
+  {
+    joint_names.push_back("joint" + std::to_string(i + 1));
+    start_interfaces.push_back(joint_names.back() + "/velocity");
+    stop_interfaces.push_back(joint_names.back() + "/position");
+  }
+  CommandModeIndex index;
+  index.build(joint_names, MODES);
+
+  std::vector<size_t> new_modes;
+  std::vector<bool> stopped(num_joints);
+  const double search = measure(
+    count,
+    [&]()
+    { resolve_by_search(joint_names, start_interfaces, stop_interfaces, new_modes, stopped); });
+  new_modes.assign(num_joints, 0);
+  const double indexed = measure(
+    count,
+    [&]() { resolve_by_index(index, start_interfaces, stop_interfaces, new_modes, stopped); });
+
+  std::printf("%8s %16s %16s\n", "joints", "search [us]", "index [us]");
+  std::printf("%8zu %16.1f %16.1f\n", num_joints, search, indexed);
+  return 0;
+}
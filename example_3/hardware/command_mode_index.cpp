@@ -0,0 +1,39 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ros2_control_demo_example_3/command_mode_index.hpp"
+
+namespace ros2_control_demo_example_3
+{
+void CommandModeIndex::build(
+  const std::vector<std::string> & joint_names, const std::vector<std::string> & mode_interfaces)
+{
+  entries_.clear();
+  entries_.reserve(joint_names.size() * mode_interfaces.size());
+  for (size_t joint = 0; joint < joint_names.size(); joint++)
+  {
+    for (size_t mode = 0; mode < mode_interfaces.size(); mode++)
+    {
+      entries_.emplace(joint_names[joint] + "/" + mode_interfaces[mode], Entry{joint, mode});
+    }
+  }
+}
+
+const CommandModeIndex::Entry * CommandModeIndex::find(const std::string & interface_name) const
+{
+  const auto entry = entries_.find(interface_name);
+  return entry != entries_.end() ? &entry->second : nullptr;
+}
+
+}  // namespace ros2_control_demo_example_3
@@ -0,0 +1,62 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS2_CONTROL_DEMO_EXAMPLE_3__COMMAND_MODE_INDEX_HPP_
+#define ROS2_CONTROL_DEMO_EXAMPLE_3__COMMAND_MODE_INDEX_HPP_
+
+#include <stddef.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ros2_control_demo_example_3
+{
+/**
+ * Finds the joint and the command mode of a command interface by its full name, e.g.
+ * "joint1/velocity".
+ *
+ * The names are matched exactly, so "joint10/velocity" never counts for "joint1". A lookup hashes
+ * the name once, a mode switch of I interfaces costs O(I) however many joints there are.
+ */
+class CommandModeIndex
+{
+public:
+  struct Entry
+  {
+    /// index of the joint in the hardware info
+    size_t joint;
+    /// index of the interface in the mode interfaces given to build()
+    size_t mode;
+  };
+
+  /**
+   * Indexes the interface \p mode_interfaces[m] of joint \p joint_names[j] as joint j in mode m,
+   * not realtime safe.
+   */
+  void build(
+    const std::vector<std::string> & joint_names,
+    const std::vector<std::string> & mode_interfaces);
+
+  /// \return nullptr if \p interface_name is not one of the indexed interfaces
+  const Entry * find(const std::string & interface_name) const;
+
+  size_t size() const { return entries_.size(); }
+
+private:
+  std::unordered_map<std::string, Entry> entries_;
+};
+
+}  // namespace ros2_control_demo_example_3
+
+#endif  // ROS2_CONTROL_DEMO_EXAMPLE_3__COMMAND_MODE_INDEX_HPP_
@@ -31,6 +31,9 @@
 #include "rclcpp/time.hpp"
 #include "rclcpp_lifecycle/node_interfaces/lifecycle_node_interface.hpp"
 #include "rclcpp_lifecycle/state.hpp"
+#include "ros2_control_demo_example_3/command_mode_index.hpp"
+#include "ros2_control_demo_utils/interface_handles.hpp"
+#include "ros2_control_demo_utils/realtime_logger.hpp"
 
 namespace ros2_control_demo_example_3
 {
@@ -67,6 +70,11 @@ private:
   double hw_stop_sec_;
   double hw_slowdown_;
 
+  ros2_control_demo_utils::RealtimeLogger rt_logger_;
+  ros2_control_demo_utils::LogThrottle read_log_throttle_{std::chrono::milliseconds(500)};
+  ros2_control_demo_utils::LogThrottle write_log_throttle_{std::chrono::milliseconds(500)};
+  ros2_control_demo_utils::LogThrottle idle_log_throttle_{std::chrono::milliseconds(1000)};
+
   // Enum defining at which control level we are
   // Dumb way of maintaining the command_interface type per joint.
   enum integration_level_t : std::uint8_t
@@ -79,6 +87,21 @@ private:
 
   // Active control mode for each actuator
   std::vector<integration_level_t> control_level_;
+
+  // joint and mode of the command interfaces named in a mode switch, built in on_init()
+  CommandModeIndex command_modes_;
+
+  // interfaces of a joint, looked up in on_configure()
+  struct JointHandles
+  {
+    ros2_control_demo_utils::StateHandle position_state;
+    ros2_control_demo_utils::StateHandle velocity_state;
+    ros2_control_demo_utils::StateHandle acceleration_state;
+    ros2_control_demo_utils::CommandHandle position_command;
+    ros2_control_demo_utils::CommandHandle velocity_command;
+    ros2_control_demo_utils::CommandHandle acceleration_command;
+  };
+  std::vector<JointHandles> joint_handles_;
 };
 
 }  // namespace ros2_control_demo_example_3
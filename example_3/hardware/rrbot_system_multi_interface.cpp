@@ -14,12 +14,11 @@
 
 #include "ros2_control_demo_example_3/rrbot_system_multi_interface.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
-#include <iomanip>
 #include <limits>
 #include <memory>
-#include <sstream>
 #include <string>
 #include <vector>
 
@@ -38,6 +37,9 @@ hardware_interface::CallbackReturn RRBotSystemMultiInterfaceHardware::on_init(
     return hardware_interface::CallbackReturn::ERROR;
   }
 
+  // log messages of read() and write() are formatted outside of the realtime loop
+  rt_logger_.configure(get_logger());
+
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
   hw_start_sec_ = stod(info_.hardware_parameters["example_param_hw_start_duration_sec"]);
   hw_stop_sec_ = stod(info_.hardware_parameters["example_param_hw_stop_duration_sec"]);
@@ -90,6 +92,16 @@ hardware_interface::CallbackReturn RRBotSystemMultiInterfaceHardware::on_init(
     }
   }
 
+  // resolve the interfaces of a mode switch by exact name instead of searching all joints
+  std::vector<std::string> joint_names;
+  for (const hardware_interface::ComponentInfo & joint : info_.joints)
+  {
+    joint_names.push_back(joint.name);
+  }
+  command_modes_.build(
+    joint_names, {hardware_interface::HW_IF_POSITION, hardware_interface::HW_IF_VELOCITY,
+                  hardware_interface::HW_IF_ACCELERATION});
+
   return hardware_interface::CallbackReturn::SUCCESS;
 }
 
@@ -115,6 +127,34 @@ hardware_interface::CallbackReturn RRBotSystemMultiInterfaceHardware::on_configu
   {
     set_command(name, 0.0);
   }
+
+  // look up the interfaces once instead of by name in every read() and write()
+  ros2_control_demo_utils::HandleResolver resolver;
+  resolver.add_states(joint_states_);
+  resolver.add_commands(joint_commands_);
+  joint_handles_.resize(info_.joints.size());
+  for (std::size_t i = 0; i < info_.joints.size(); i++)
+  {
+    const auto prefix = info_.joints[i].name + "/";
+    auto & joint = joint_handles_[i];
+    if (
+      !resolver.resolve_state(prefix + hardware_interface::HW_IF_POSITION, joint.position_state) ||
+      !resolver.resolve_state(prefix + hardware_interface::HW_IF_VELOCITY, joint.velocity_state) ||
+      !resolver.resolve_state(
+        prefix + hardware_interface::HW_IF_ACCELERATION, joint.acceleration_state) ||
+      !resolver.resolve_command(
+        prefix + hardware_interface::HW_IF_POSITION, joint.position_command) ||
+      !resolver.resolve_command(
+        prefix + hardware_interface::HW_IF_VELOCITY, joint.velocity_command) ||
+      !resolver.resolve_command(
+        prefix + hardware_interface::HW_IF_ACCELERATION, joint.acceleration_command))
+    {
+      RCLCPP_FATAL(
+        get_logger(), "Failed to look up the interfaces of joint '%s'.",
+        info_.joints[i].name.c_str());
+      return hardware_interface::CallbackReturn::ERROR;
+    }
+  }
   RCLCPP_INFO(get_logger(), "Successfully configured!");
 
   return hardware_interface::CallbackReturn::SUCCESS;
@@ -124,54 +164,55 @@ hardware_interface::return_type RRBotSystemMultiInterfaceHardware::prepare_comma
   const std::vector<std::string> & start_interfaces,
   const std::vector<std::string> & stop_interfaces)
 {
+  // in the order of the mode interfaces given to command_modes_ in on_init()
+  constexpr integration_level_t LEVELS[] = {
+    integration_level_t::POSITION, integration_level_t::VELOCITY,
+    integration_level_t::ACCELERATION};
+
   // Prepare for new command modes
-  std::vector<integration_level_t> new_modes = {};
-  for (std::string key : start_interfaces)
+  std::vector<integration_level_t> new_modes(info_.joints.size(), integration_level_t::UNDEFINED);
+  for (const std::string & key : start_interfaces)
   {
-    for (std::size_t i = 0; i < info_.joints.size(); i++)
+    const auto * entry = command_modes_.find(key);
+    if (!entry)
     {
-      if (key == info_.joints[i].name + "/" + hardware_interface::HW_IF_POSITION)
-      {
-        new_modes.push_back(integration_level_t::POSITION);
-      }
-      if (key == info_.joints[i].name + "/" + hardware_interface::HW_IF_VELOCITY)
-      {
-        new_modes.push_back(integration_level_t::VELOCITY);
-      }
-      if (key == info_.joints[i].name + "/" + hardware_interface::HW_IF_ACCELERATION)
-      {
-        new_modes.push_back(integration_level_t::ACCELERATION);
-      }
+      continue;
     }
+    // Example criteria: A joint can't be given two command modes at once
+    if (new_modes[entry->joint] != integration_level_t::UNDEFINED)
+    {
+      return hardware_interface::return_type::ERROR;
+    }
+    new_modes[entry->joint] = LEVELS[entry->mode];
   }
   // Example criteria: All joints must be given new command mode at the same time
-  if (new_modes.size() != info_.joints.size())
+  if (
+    std::find(new_modes.begin(), new_modes.end(), integration_level_t::UNDEFINED) !=
+    new_modes.end())
   {
     return hardware_interface::return_type::ERROR;
   }
   // Example criteria: All joints must have the same command mode
   if (!std::all_of(
-        new_modes.begin() + 1, new_modes.end(),
+        new_modes.begin(), new_modes.end(),
         [&](integration_level_t mode) { return mode == new_modes[0]; }))
   {
     return hardware_interface::return_type::ERROR;
   }
 
   // Stop motion on all relevant joints that are stopping
-  for (std::string key : stop_interfaces)
+  for (const std::string & key : stop_interfaces)
   {
-    for (std::size_t i = 0; i < info_.joints.size(); i++)
+    const auto * entry = command_modes_.find(key);
+    if (!entry)
     {
-      if (key.find(info_.joints[i].name) != std::string::npos)
-      {
-        set_command(
-          info_.joints[i].name + "/" + hardware_interface::HW_IF_POSITION,
-          get_state(info_.joints[i].name + "/" + hardware_interface::HW_IF_POSITION));
-        set_command(info_.joints[i].name + "/" + hardware_interface::HW_IF_VELOCITY, 0.0);
-        set_command(info_.joints[i].name + "/" + hardware_interface::HW_IF_ACCELERATION, 0.0);
-        control_level_[i] = integration_level_t::UNDEFINED;  // Revert to undefined
-      }
+      continue;
     }
+    auto & joint = joint_handles_[entry->joint];
+    joint.position_command.set(joint.position_state.get());
+    joint.velocity_command.set(0.0);
+    joint.acceleration_command.set(0.0);
+    control_level_[entry->joint] = integration_level_t::UNDEFINED;  // Revert to undefined
   }
   // Set the new command modes
   for (std::size_t i = 0; i < info_.joints.size(); i++)
@@ -231,47 +272,47 @@ hardware_interface::return_type RRBotSystemMultiInterfaceHardware::read(
   const rclcpp::Time & /*time*/, const rclcpp::Duration & period)
 {
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
-  std::stringstream ss;
-  ss << "Reading states:";
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, read_log_throttle_);
+  record.append("Reading states:");
   for (std::size_t i = 0; i < info_.joints.size(); i++)
   {
-    const auto name_acc = info_.joints[i].name + "/" + hardware_interface::HW_IF_ACCELERATION;
-    const auto name_vel = info_.joints[i].name + "/" + hardware_interface::HW_IF_VELOCITY;
-    const auto name_pos = info_.joints[i].name + "/" + hardware_interface::HW_IF_POSITION;
+    auto & joint = joint_handles_[i];
     switch (control_level_[i])
     {
       case integration_level_t::UNDEFINED:
-        RCLCPP_INFO_THROTTLE(
-          get_logger(), *get_clock(), 1000, "Nothing is using the hardware interface!");
+        record.discard();
+        rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, idle_log_throttle_)
+          .append("Nothing is using the hardware interface!");
         return hardware_interface::return_type::OK;
         break;
       case integration_level_t::POSITION:
-        set_state(name_acc, 0.);
-        set_state(name_vel, 0.);
-        set_state(
-          name_pos,
-          get_state(name_pos) + (get_command(name_pos) - get_state(name_pos)) / hw_slowdown_);
+        joint.acceleration_state.set(0.);
+        joint.velocity_state.set(0.);
+        joint.position_state.set(
+          joint.position_state.get() +
+            (joint.position_command.get() - joint.position_state.get()) / hw_slowdown_);
         break;
       case integration_level_t::VELOCITY:
-        set_state(name_acc, 0.);
-        set_state(name_vel, get_command(name_vel));
-        set_state(
-          name_pos, get_state(name_pos) + get_state(name_vel) * period.seconds() / hw_slowdown_);
+        joint.acceleration_state.set(0.);
+        joint.velocity_state.set(joint.velocity_command.get());
+        joint.position_state.set(
+          joint.position_state.get() +
+            joint.velocity_state.get() * period.seconds() / hw_slowdown_);
         break;
       case integration_level_t::ACCELERATION:
-        set_state(name_acc, get_command(name_acc));
-        set_state(
-          name_vel, get_state(name_vel) + get_state(name_acc) * period.seconds() / hw_slowdown_);
-        set_state(
-          name_pos, get_state(name_pos) + get_state(name_vel) * period.seconds() / hw_slowdown_);
+        joint.acceleration_state.set(joint.acceleration_command.get());
+        joint.velocity_state.set(
+          joint.velocity_state.get() +
+            joint.acceleration_state.get() * period.seconds() / hw_slowdown_);
+        joint.position_state.set(
+          joint.position_state.get() +
+            joint.velocity_state.get() * period.seconds() / hw_slowdown_);
         break;
     }
-    ss << std::fixed << std::setprecision(2) << std::endl
-       << "\t"
-       << "pos: " << get_state(name_pos) << ", vel: " << get_state(name_vel)
-       << ", acc: " << get_state(name_acc) << " for joint " << i;
+    record.append(
+      "\n\tpos: %.2f, vel: %.2f, acc: %.2f for joint %zu", joint.position_state.get(),
+      joint.velocity_state.get(), joint.acceleration_state.get(), i);
   }
-  RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 500, "%s", ss.str().c_str());
   // END: This part here is for exemplary purposes - Please do not copy to your production code
   return hardware_interface::return_type::OK;
 }
@@ -280,21 +321,17 @@ hardware_interface::return_type RRBotSystemMultiInterfaceHardware::write(
   const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
 {
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
-  std::stringstream ss;
-  ss << "Writing commands:";
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, write_log_throttle_);
+  record.append("Writing commands:");
   for (std::size_t i = 0; i < info_.joints.size(); i++)
   {
     // Simulate sending commands to the hardware
-    const auto name_acc = info_.joints[i].name + "/" + hardware_interface::HW_IF_ACCELERATION;
-    const auto name_vel = info_.joints[i].name + "/" + hardware_interface::HW_IF_VELOCITY;
-    const auto name_pos = info_.joints[i].name + "/" + hardware_interface::HW_IF_POSITION;
-    ss << std::fixed << std::setprecision(2) << std::endl
-       << "\t"
-       << "command pos: " << get_command(name_pos) << ", vel: " << get_command(name_vel)
-       << ", acc: " << get_command(name_acc) << " for joint " << i
-       << ", control lvl: " << static_cast<int>(control_level_[i]);
+    const auto & joint = joint_handles_[i];
+    record.append(
+      "\n\tcommand pos: %.2f, vel: %.2f, acc: %.2f for joint %zu", joint.position_command.get(),
+      joint.velocity_command.get(), joint.acceleration_command.get(), i);
+    record.append(", control lvl: %d", static_cast<int>(control_level_[i]));
   }
-  RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 500, "%s", ss.str().c_str());
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   return hardware_interface::return_type::OK;
@@ -0,0 +1,69 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "ros2_control_demo_example_3/command_mode_index.hpp"
+
+using ros2_control_demo_example_3::CommandModeIndex;
+
+namespace
+{
+const std::vector<std::string> MODES = {"position", "velocity", "acceleration"};
+}  // namespace
+
+TEST(TestCommandModeIndex, finds_joint_and_mode)
+{
+  CommandModeIndex index;
+  index.build({"joint1", "joint10", "joint2"}, MODES);
+  ASSERT_EQ(index.size(), 9u);
+
+  const auto * entry = index.find("joint10/velocity");
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->joint, 1u);
+  EXPECT_EQ(entry->mode, 1u);
+
+  entry = index.find("joint1/acceleration");
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->joint, 0u);
+  EXPECT_EQ(entry->mode, 2u);
+
+  entry = index.find("joint2/position");
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->joint, 2u);
+  EXPECT_EQ(entry->mode, 0u);
+}
+
+TEST(TestCommandModeIndex, matches_names_exactly)
+{
+  CommandModeIndex index;
+  index.build({"joint1", "joint10"}, MODES);
+
+  // a substring search for "joint1" would have matched all of these
+  EXPECT_EQ(index.find("joint1"), nullptr);
+  EXPECT_EQ(index.find("joint1/effort"), nullptr);
+  EXPECT_EQ(index.find("joint100/position"), nullptr);
+  EXPECT_EQ(index.find("joint1/position/extra"), nullptr);
+  EXPECT_EQ(index.find("other_joint1/position"), nullptr);
+  EXPECT_EQ(index.find(""), nullptr);
+
+  // rebuilding forgets the joints of before
+  index.build({"joint10"}, MODES);
+  EXPECT_EQ(index.find("joint1/position"), nullptr);
+  ASSERT_NE(index.find("joint10/position"), nullptr);
+  EXPECT_EQ(index.find("joint10/position")->joint, 0u);
+}
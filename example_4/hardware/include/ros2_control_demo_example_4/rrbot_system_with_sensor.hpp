@@ -19,6 +19,7 @@
 #ifndef ROS2_CONTROL_DEMO_EXAMPLE_4__RRBOT_SYSTEM_WITH_SENSOR_HPP_
 #define ROS2_CONTROL_DEMO_EXAMPLE_4__RRBOT_SYSTEM_WITH_SENSOR_HPP_
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -29,6 +30,10 @@
 #include "hardware_interface/types/hardware_interface_return_values.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp_lifecycle/state.hpp"
+#include "ros2_control_demo_utils/interface_handles.hpp"
+#include "ros2_control_demo_utils/realtime_logger.hpp"
+#include "ros2_control_demo_utils/sensor_noise.hpp"
+#include "ros2_control_demo_utils/simulated_actuator_bank.hpp"
 
 namespace ros2_control_demo_example_4
 {
@@ -61,6 +66,22 @@ private:
   double hw_stop_sec_;
   double hw_slowdown_;
   double hw_sensor_change_;
+  uint64_t hw_sensor_noise_seed_;
+
+  // simulated joints and their position interfaces, in the order of the joints
+  ros2_control_demo_utils::SimulatedActuatorBank actuators_;
+  std::vector<ros2_control_demo_utils::StateHandle> position_states_;
+  std::vector<ros2_control_demo_utils::CommandHandle> position_commands_;
+
+  // noisy measurements of the sensor interfaces, in the order of the sensors and their interfaces
+  ros2_control_demo_utils::SensorNoise sensor_noise_;
+  std::vector<double> sensor_values_;
+  std::vector<ros2_control_demo_utils::StateHandle> sensor_handles_;
+
+  ros2_control_demo_utils::RealtimeLogger rt_logger_;
+  ros2_control_demo_utils::LogThrottle read_log_throttle_{std::chrono::milliseconds(500)};
+  ros2_control_demo_utils::LogThrottle sensor_log_throttle_{std::chrono::milliseconds(500)};
+  ros2_control_demo_utils::LogThrottle write_log_throttle_{std::chrono::milliseconds(500)};
 };
 
 }  // namespace ros2_control_demo_example_4
@@ -18,13 +18,11 @@
 
 #include "ros2_control_demo_example_4/rrbot_system_with_sensor.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
-#include <iomanip>
 #include <limits>
 #include <memory>
-#include <random>
-#include <sstream>
 #include <vector>
 
 #include "hardware_interface/types/hardware_interface_type_values.hpp"
@@ -42,11 +40,15 @@ hardware_interface::CallbackReturn RRBotSystemWithSensorHardware::on_init(
     return hardware_interface::CallbackReturn::ERROR;
   }
 
+  // log messages of read() and write() are formatted outside of the realtime loop
+  rt_logger_.configure(get_logger());
+
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
   hw_start_sec_ = stod(info_.hardware_parameters["example_param_hw_start_duration_sec"]);
   hw_stop_sec_ = stod(info_.hardware_parameters["example_param_hw_stop_duration_sec"]);
   hw_slowdown_ = stod(info_.hardware_parameters["example_param_hw_slowdown"]);
   hw_sensor_change_ = stod(info_.hardware_parameters["example_param_max_sensor_change"]);
+  hw_sensor_noise_seed_ = stoull(info_.hardware_parameters["example_param_sensor_noise_seed"]);
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   for (const hardware_interface::ComponentInfo & joint : info_.joints)
@@ -115,6 +117,53 @@ hardware_interface::CallbackReturn RRBotSystemWithSensorHardware::on_configure(
   {
     set_command(name, 0.0);
   }
+
+  // the simulation steps all joints at once, on interfaces looked up here
+  ros2_control_demo_utils::HandleResolver resolver;
+  resolver.add_states(joint_states_);
+  resolver.add_states(sensor_states_);
+  resolver.add_commands(joint_commands_);
+  position_states_.resize(info_.joints.size());
+  position_commands_.resize(info_.joints.size());
+  for (size_t i = 0; i < info_.joints.size(); i++)
+  {
+    const auto name = info_.joints[i].name + "/" + hardware_interface::HW_IF_POSITION;
+    if (
+      !resolver.resolve_state(name, position_states_[i]) ||
+      !resolver.resolve_command(name, position_commands_[i]))
+    {
+      RCLCPP_FATAL(
+        get_logger(), "Failed to look up the position interfaces of joint '%s'.",
+        info_.joints[i].name.c_str());
+      return hardware_interface::CallbackReturn::ERROR;
+    }
+  }
+  actuators_.resize(info_.joints.size(), hw_slowdown_);
+
+  // the sensor measures half of the maximum change with noise, restarted from the seed
+  sensor_handles_.clear();
+  for (const hardware_interface::ComponentInfo & sensor : info_.sensors)
+  {
+    for (const hardware_interface::InterfaceInfo & interface : sensor.state_interfaces)
+    {
+      sensor_handles_.emplace_back();
+      if (!resolver.resolve_state(sensor.name + "/" + interface.name, sensor_handles_.back()))
+      {
+        RCLCPP_FATAL(
+          get_logger(), "Failed to look up the state interface '%s' of sensor '%s'.",
+          interface.name.c_str(), sensor.name.c_str());
+        return hardware_interface::CallbackReturn::ERROR;
+      }
+    }
+  }
+  sensor_values_.resize(sensor_handles_.size());
+  sensor_noise_.configure(sensor_handles_.size(), hw_sensor_noise_seed_);
+  for (size_t i = 0; i < sensor_handles_.size(); i++)
+  {
+    sensor_noise_.set_model(
+      i, {hw_sensor_change_ / 6.0, hw_sensor_change_ / 100.0, hw_sensor_change_ / 1000.0});
+  }
+
   RCLCPP_INFO(get_logger(), "Successfully configured!");
 
   return hardware_interface::CallbackReturn::SUCCESS;
@@ -162,35 +211,46 @@ hardware_interface::CallbackReturn RRBotSystemWithSensorHardware::on_deactivate(
 }
 
 hardware_interface::return_type RRBotSystemWithSensorHardware::read(
-  const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
+  const rclcpp::Time & /*time*/, const rclcpp::Duration & period)
 {
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
-  std::stringstream ss;
-  ss << "Reading states from joints:" << std::fixed << std::setprecision(2);
+  // Simulate RRBot's movement
+  actuators_.read_commands(position_commands_);
+  actuators_.step(period.seconds());
+  actuators_.write_positions(position_states_);
 
-  for (const auto & [name, descr] : joint_state_interfaces_)
+  // one record at a time, committed at the end of the block
   {
-    // Simulate RRBot's movement
-    auto new_value = get_state(name) + (get_command(name) - get_state(name)) / hw_slowdown_;
-    set_state(name, new_value);
-    ss << std::endl << "\t" << get_state(name) << " for joint '" << name << "'";
+    auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, read_log_throttle_);
+    if (record)
+    {
+      record.append("Reading states from joints:");
+      for (size_t i = 0; i < position_states_.size(); i++)
+      {
+        record.append(
+          "\n\t%.2f for joint '%s'", actuators_.positions()[i], position_states_[i].name().c_str());
+      }
+    }
   }
-  RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 500, "%s", ss.str().c_str());
 
-  ss.str("");
-  ss << "Reading states from sensors:" << std::fixed << std::setprecision(2);
-  unsigned int i = 0;
-  for (const auto & [name, descr] : sensor_state_interfaces_)
+  // Simulate RRBot's sensor data
+  std::fill(sensor_values_.begin(), sensor_values_.end(), hw_sensor_change_ / 2.0);
+  sensor_noise_.apply(sensor_values_.data(), period.seconds());
+  for (size_t i = 0; i < sensor_handles_.size(); i++)
   {
-    // Simulate RRBot's sensor data
-    unsigned int seed = static_cast<unsigned int>(time(NULL)) + i++;
-    std::minstd_rand random_generator(seed);
-    std::uniform_real_distribution<double> distribution(0.0, hw_sensor_change_);
-    set_state(name, distribution(random_generator));
+    sensor_handles_[i].set(sensor_values_[i]);
+  }
 
-    ss << std::endl << "\t" << get_state(name) << " for sensor '" << name << "'";
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, sensor_log_throttle_);
+  if (record)
+  {
+    record.append("Reading states from sensors:");
+    for (size_t i = 0; i < sensor_handles_.size(); i++)
+    {
+      record.append(
+        "\n\t%.2f for sensor '%s'", sensor_values_[i], sensor_handles_[i].name().c_str());
+    }
   }
-  RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 500, "%s", ss.str().c_str());
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   return hardware_interface::return_type::OK;
@@ -200,15 +260,16 @@ hardware_interface::return_type ros2_control_demo_example_4::RRBotSystemWithSens
   const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
 {
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
-  std::stringstream ss;
-  ss << "Writing commands:";
-  for (const auto & [name, descr] : joint_command_interfaces_)
+  // Simulate sending commands to the hardware, nothing is looked up while the record is throttled
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, write_log_throttle_);
+  if (record)
   {
-    // Simulate sending commands to the hardware
-    ss << std::fixed << std::setprecision(2) << std::endl
-       << "\t" << get_command(name) << " for joint '" << name << "'";
+    record.append("Writing commands:");
+    for (const auto & command : position_commands_)
+    {
+      record.append("\n\t%.2f for joint '%s'", command.get(), command.name().c_str());
+    }
   }
-  RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 500, "%s", ss.str().c_str());
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   return hardware_interface::return_type::OK;
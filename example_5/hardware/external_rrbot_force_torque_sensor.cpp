@@ -18,13 +18,11 @@
 
 #include "ros2_control_demo_example_5/external_rrbot_force_torque_sensor.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
-#include <iomanip>
 #include <limits>
 #include <memory>
-#include <random>
-#include <sstream>
 #include <vector>
 
 #include "hardware_interface/types/hardware_interface_type_values.hpp"
@@ -42,15 +40,52 @@ hardware_interface::CallbackReturn ExternalRRBotForceTorqueSensorHardware::on_in
     return hardware_interface::CallbackReturn::ERROR;
   }
 
+  // log messages of read() are formatted outside of the realtime loop
+  rt_logger_.configure(get_logger());
+
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
   hw_start_sec_ = stod(info_.hardware_parameters["example_param_hw_start_duration_sec"]);
   hw_stop_sec_ = stod(info_.hardware_parameters["example_param_hw_stop_duration_sec"]);
   hw_sensor_change_ = stod(info_.hardware_parameters["example_param_max_sensor_change"]);
+  hw_sensor_noise_seed_ = stoull(info_.hardware_parameters["example_param_sensor_noise_seed"]);
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   return hardware_interface::CallbackReturn::SUCCESS;
 }
 
+hardware_interface::CallbackReturn ExternalRRBotForceTorqueSensorHardware::on_configure(
+  const rclcpp_lifecycle::State & /*previous_state*/)
+{
+  // the sensor measures half of the maximum change on each axis with noise, restarted from the
+  // seed, and all axes are simulated at once on interfaces looked up here
+  ros2_control_demo_utils::HandleResolver resolver;
+  resolver.add_states(sensor_states_);
+  sensor_handles_.clear();
+  for (const hardware_interface::ComponentInfo & sensor : info_.sensors)
+  {
+    for (const hardware_interface::InterfaceInfo & interface : sensor.state_interfaces)
+    {
+      sensor_handles_.emplace_back();
+      if (!resolver.resolve_state(sensor.name + "/" + interface.name, sensor_handles_.back()))
+      {
+        RCLCPP_FATAL(
+          get_logger(), "Failed to look up the state interface '%s' of sensor '%s'.",
+          interface.name.c_str(), sensor.name.c_str());
+        return hardware_interface::CallbackReturn::ERROR;
+      }
+    }
+  }
+  sensor_values_.resize(sensor_handles_.size());
+  sensor_noise_.configure(sensor_handles_.size(), hw_sensor_noise_seed_);
+  for (size_t i = 0; i < sensor_handles_.size(); i++)
+  {
+    sensor_noise_.set_model(
+      i, {hw_sensor_change_ / 6.0, hw_sensor_change_ / 100.0, hw_sensor_change_ / 1000.0});
+  }
+
+  return hardware_interface::CallbackReturn::SUCCESS;
+}
+
 hardware_interface::CallbackReturn ExternalRRBotForceTorqueSensorHardware::on_activate(
   const rclcpp_lifecycle::State & /*previous_state*/)
 {
@@ -88,23 +123,27 @@ hardware_interface::CallbackReturn ExternalRRBotForceTorqueSensorHardware::on_de
 }
 
 hardware_interface::return_type ExternalRRBotForceTorqueSensorHardware::read(
-  const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
+  const rclcpp::Time & /*time*/, const rclcpp::Duration & period)
 {
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
-  std::stringstream ss;
-  ss << "Reading states from sensors:" << std::fixed << std::setprecision(2);
-  unsigned int i = 0;
-  for (const auto & [name, descr] : sensor_state_interfaces_)
+  // Simulate RRBot's sensor data, the whole wrench in one batch
+  std::fill(sensor_values_.begin(), sensor_values_.end(), hw_sensor_change_ / 2.0);
+  sensor_noise_.apply(sensor_values_.data(), period.seconds());
+  for (size_t i = 0; i < sensor_handles_.size(); i++)
   {
-    // Simulate RRBot's sensor data
-    unsigned int seed = static_cast<unsigned int>(time(NULL)) + i++;
-    std::minstd_rand random_generator(seed);
-    std::uniform_real_distribution<double> distribution(0.0, hw_sensor_change_);
-    set_state(name, distribution(random_generator));
+    sensor_handles_[i].set(sensor_values_[i]);
+  }
 
-    ss << std::endl << "\t" << get_state(name) << " for sensor '" << name << "'";
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO, read_log_throttle_);
+  if (record)
+  {
+    record.append("Reading states from sensors:");
+    for (size_t i = 0; i < sensor_handles_.size(); i++)
+    {
+      record.append(
+        "\n\t%.2f for sensor '%s'", sensor_values_[i], sensor_handles_[i].name().c_str());
+    }
   }
-  RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 500, "%s", ss.str().c_str());
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   return hardware_interface::return_type::OK;
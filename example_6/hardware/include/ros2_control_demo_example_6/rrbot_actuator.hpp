@@ -29,6 +29,7 @@
 #include "hardware_interface/system_interface.hpp"
 #include "hardware_interface/types/hardware_interface_return_values.hpp"
 #include "rclcpp/macros.hpp"
+#include "ros2_control_demo_utils/realtime_logger.hpp"
 
 namespace ros2_control_demo_example_6
 {
@@ -60,6 +61,8 @@ private:
   double hw_start_sec_;
   double hw_stop_sec_;
   double hw_slowdown_;
+
+  ros2_control_demo_utils::RealtimeLogger rt_logger_;
 };
 
 }  // namespace ros2_control_demo_example_6
@@ -20,10 +20,8 @@
 
 #include <chrono>
 #include <cmath>
-#include <iomanip>
 #include <limits>
 #include <memory>
-#include <sstream>
 #include <vector>
 
 #include "hardware_interface/actuator_interface.hpp"
@@ -41,6 +39,10 @@ hardware_interface::CallbackReturn RRBotModularJoint::on_init(
   {
     return hardware_interface::CallbackReturn::ERROR;
   }
+
+  // log messages of read() and write() are formatted outside of the realtime loop
+  rt_logger_.configure(get_logger());
+
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
   hw_start_sec_ = stod(info_.hardware_parameters["example_param_hw_start_duration_sec"]);
   hw_stop_sec_ = stod(info_.hardware_parameters["example_param_hw_stop_duration_sec"]);
@@ -158,20 +160,17 @@ hardware_interface::return_type RRBotModularJoint::read(
   const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
 {
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
-  std::stringstream ss;
-  ss << "Reading states:";
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO);
+  record.append("Reading states:");
 
-  // Simulate RRBot's movement
   for (const auto & [name, descr] : joint_state_interfaces_)
   {
     // Simulate RRBot's movement
-    auto new_value = get_state(name) + (get_command(name) - get_state(name)) / hw_slowdown_;
+    const double state = get_state(name);
+    const double new_value = state + (get_command(name) - state) / hw_slowdown_;
     set_state(name, new_value);
-    ss << std::fixed << std::setprecision(2) << std::endl
-       << "\t" << get_state(name) << " for joint '" << name << "'";
+    record.append("\n\t%.2f for joint '%s'", new_value, name.c_str());
   }
-
-  RCLCPP_INFO(get_logger(), "%s", ss.str().c_str());
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   return hardware_interface::return_type::OK;
@@ -181,16 +180,16 @@ hardware_interface::return_type ros2_control_demo_example_6::RRBotModularJoint::
   const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
 {
   // BEGIN: This part here is for exemplary purposes - Please do not copy to your production code
-  std::stringstream ss;
-  ss << "Writing commands:";
-
-  for (const auto & [name, descr] : joint_command_interfaces_)
+  // Simulate sending commands to the hardware, nothing is looked up if the record is dropped
+  auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO);
+  if (record)
   {
-    // Simulate sending commands to the hardware
-    ss << std::fixed << std::setprecision(2) << std::endl
-       << "\t" << get_command(name) << " for joint '" << name << "'";
+    record.append("Writing commands:");
+    for (const auto & [name, descr] : joint_command_interfaces_)
+    {
+      record.append("\n\t%.2f for joint '%s'", get_command(name), name.c_str());
+    }
   }
-  RCLCPP_INFO(get_logger(), "%s", ss.str().c_str());
   // END: This part here is for exemplary purposes - Please do not copy to your production code
 
   return hardware_interface::return_type::OK;
@@ -13,7 +13,8 @@
 # limitations under the License.
 
 from launch import LaunchDescription
-from launch.substitutions import Command, FindExecutable, PathJoinSubstitution
+from launch.actions import DeclareLaunchArgument
+from launch.substitutions import Command, FindExecutable, LaunchConfiguration, PathJoinSubstitution
 from launch_ros.actions import Node
 from launch_ros.substitutions import FindPackageShare
 
@@ -22,6 +23,21 @@ def generate_launch_description():
 
     return LaunchDescription(
         [
+            DeclareLaunchArgument(
+                "repetitions",
+                default_value="1",
+                description="Number of times the path is traced.",
+            ),
+            DeclareLaunchArgument(
+                "stream_chunk_size",
+                default_value="0",
+                description="Points per chunk sent to the trajectory stream, 0 sends one message.",
+            ),
+            DeclareLaunchArgument(
+                "stream_lead_time",
+                default_value="1.0",
+                description="Time in seconds a chunk is sent ahead of its execution.",
+            ),
             Node(
                 package="ros2_control_demo_example_7",
                 executable="send_trajectory",
@@ -41,7 +57,12 @@ def generate_launch_description():
                                 ),
                             ]
                         )
-                    }
+                    },
+                    {
+                        "repetitions": LaunchConfiguration("repetitions"),
+                        "stream_chunk_size": LaunchConfiguration("stream_chunk_size"),
+                        "stream_lead_time": LaunchConfiguration("stream_lead_time"),
+                    },
                 ],
             )
         ]
@@ -33,13 +33,45 @@
 #include "rclcpp/time.hpp"
 #include "rclcpp/timer.hpp"
 #include "rclcpp_lifecycle/lifecycle_publisher.hpp"
+#include "rclcpp_action/server.hpp"
 #include "rclcpp_lifecycle/node_interfaces/lifecycle_node_interface.hpp"
-#include "realtime_tools/realtime_thread_safe_box.hpp"
+#include "realtime_tools/realtime_server_goal_handle.hpp"
+#include "ros2_control_demo_example_7/realtime_handoff.hpp"
+#include "ros2_control_demo_example_7/trajectory.hpp"
+#include "ros2_control_demo_example_7/trajectory_stream.hpp"
+#include "std_msgs/msg/string.hpp"
 #include "trajectory_msgs/msg/joint_trajectory.hpp"
 #include "trajectory_msgs/msg/joint_trajectory_point.hpp"
 
 namespace ros2_control_demo_example_7
 {
+/// What to do with a trajectory received while another one is executed
+enum class NewTrajectoryMode
+{
+  /// start the new trajectory right away from its first point
+  REPLACE,
+  /// start the new trajectory when the current one ends
+  APPEND,
+  /// start the new trajectory right away, blending into it from the current command
+  BLEND,
+};
+
+using FollowJointTrajectory = control_msgs::action::FollowJointTrajectory;
+using RealtimeGoalHandle = realtime_tools::RealtimeServerGoalHandle<FollowJointTrajectory>;
+using RealtimeGoalHandlePtr = std::shared_ptr<RealtimeGoalHandle>;
+
+/**
+ * What the ROS callbacks hand over to update(): a trajectory and, if it was sent as action goal,
+ * the goal to report feedback and the result to.
+ */
+struct TrajectoryRequest
+{
+  Trajectory trajectory;
+  RealtimeGoalHandlePtr goal;
+  /// set by the cancel callback of the goal, update() then stops the trajectory
+  std::shared_ptr<std::atomic<bool>> cancel_requested;
+};
+
 class RobotController : public controller_interface::ControllerInterface
 {
 public:
@@ -64,37 +96,83 @@ public:
     const rclcpp_lifecycle::State & previous_state) override;
 
 protected:
+  /// Hands \p request over to update(), canceling the goal of a request it did not take yet.
+  void publish_request(std::unique_ptr<TrajectoryRequest> request);
+
+  /// Calls runNonRealtime() of the goals and forgets the finished ones, not realtime safe.
+  void monitor_goals();
+
+  /// Starts executing \p request at \p start_time, transitioning into it during \p splice.
+  void start_trajectory(
+    std::unique_ptr<const TrajectoryRequest> request, const rclcpp::Time & start_time,
+    double splice);
+
+  /// Stops the active or queued trajectory if its goal was canceled, realtime safe.
+  void handle_cancel_requests();
+
+  /// Samples the blend segment or the trajectory into point_interp_, returns true at the end.
+  bool sample_command(double time);
+
+  /// Executes the trajectory stream if one is running, returns false if it is idle.
+  bool update_stream(double period);
+
+  /// Writes point_interp_ to the command interfaces.
+  void write_commands();
+
+  /// Fills the preallocated feedback of the active goal, realtime safe.
+  void update_feedback(const rclcpp::Time & time);
+
   std::vector<std::string> joint_names_;
   std::vector<std::string> command_interface_types_;
   std::vector<std::string> state_interface_types_;
+  InterpolationMethod interpolation_method_ = InterpolationMethod::LINEAR;
+  NewTrajectoryMode new_trajectory_mode_ = NewTrajectoryMode::REPLACE;
+  double blend_duration_ = 0.1;
+  bool populate_trajectory_files_ = true;
 
   rclcpp::Subscription<trajectory_msgs::msg::JointTrajectory>::SharedPtr joint_command_subscriber_;
-  realtime_tools::RealtimeThreadSafeBox<trajectory_msgs::msg::JointTrajectory> traj_msg_external_;
-  std::atomic<bool> new_msg_ = false;
+  rclcpp::Subscription<trajectory_msgs::msg::JointTrajectory>::SharedPtr stream_subscriber_;
+  rclcpp::Subscription<std_msgs::msg::String>::SharedPtr trajectory_file_subscriber_;
+  rclcpp_action::Server<FollowJointTrajectory>::SharedPtr action_server_;
+  rclcpp::TimerBase::SharedPtr goal_monitor_timer_;
+  rclcpp::Duration action_monitor_period_ = rclcpp::Duration(0, 0);
+  // accepted goals that did not report their result yet, only used outside of update()
+  struct AcceptedGoal
+  {
+    RealtimeGoalHandlePtr goal;
+    // shared with the request of the goal, so a cancel never takes the place of a trajectory
+    // waiting in traj_handoff_
+    std::shared_ptr<std::atomic<bool>> cancel_requested;
+  };
+  std::mutex goals_mutex_;
+  std::vector<AcceptedGoal> goals_;
+
+  // requests built in the ROS callbacks, taken over by update() without copying
+  RealtimeHandoff<const TrajectoryRequest> traj_handoff_;
   rclcpp::Time start_time_;
-  trajectory_msgs::msg::JointTrajectory trajectory_msg_;
+  rclcpp::Time last_feedback_time_;
+  // taken over by update(), retired to traj_handoff_ when the next one arrives
+  std::unique_ptr<const TrajectoryRequest> active_request_;
+  // received in append mode while active_request_ is executed
+  std::unique_ptr<const TrajectoryRequest> queued_request_;
+  bool trajectory_done_ = true;
+  // transition from the previous command into the active trajectory
+  BlendSegment blend_;
+  bool blending_ = false;
   trajectory_msgs::msg::JointTrajectoryPoint point_interp_;
-
-  std::vector<std::reference_wrapper<hardware_interface::LoanedCommandInterface>>
-    joint_position_command_interface_;
-  std::vector<std::reference_wrapper<hardware_interface::LoanedCommandInterface>>
-    joint_velocity_command_interface_;
-  std::vector<std::reference_wrapper<hardware_interface::LoanedStateInterface>>
-    joint_position_state_interface_;
-  std::vector<std::reference_wrapper<hardware_interface::LoanedStateInterface>>
-    joint_velocity_state_interface_;
-
-  std::unordered_map<
-    std::string, std::vector<std::reference_wrapper<hardware_interface::LoanedCommandInterface>> *>
-    command_interface_map_ = {
-      {"position", &joint_position_command_interface_},
-      {"velocity", &joint_velocity_command_interface_}};
-
-  std::unordered_map<
-    std::string, std::vector<std::reference_wrapper<hardware_interface::LoanedStateInterface>> *>
-    state_interface_map_ = {
-      {"position", &joint_position_state_interface_},
-      {"velocity", &joint_velocity_state_interface_}};
+  // segment of the active trajectory sampled in the last cycle, starting point of the lookup
+  size_t segment_index_ = 0;
+
+  // chunks of long paths, executed with priority over trajectories while a stream is running
+  TrajectoryStream stream_;
+
+  // command plan resolved in on_activate, indexed like joint_names_ and the columns of a
+  // Trajectory; nullptr where an interface is not claimed
+  std::vector<hardware_interface::LoanedCommandInterface *> joint_position_command_handles_;
+  std::vector<hardware_interface::LoanedCommandInterface *> joint_velocity_command_handles_;
+  std::vector<hardware_interface::LoanedStateInterface *> joint_position_state_handles_;
+  std::vector<hardware_interface::LoanedStateInterface *> joint_velocity_state_handles_;
+  size_t failed_command_writes_ = 0;
 };
 
 }  // namespace ros2_control_demo_example_7
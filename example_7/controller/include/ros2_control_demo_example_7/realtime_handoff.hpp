@@ -0,0 +1,158 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS2_CONTROL_DEMO_EXAMPLE_7__REALTIME_HANDOFF_HPP_
+#define ROS2_CONTROL_DEMO_EXAMPLE_7__REALTIME_HANDOFF_HPP_
+
+#include <stddef.h>
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace ros2_control_demo_example_7
+{
+/**
+ * Wait-free handoff of heap objects from one non-realtime producer to one realtime consumer.
+ *
+ * The producer builds an object and publishes it with an atomic pointer exchange. The consumer
+ * takes the pointer with another exchange and never copies, allocates or frees anything: objects
+ * it is done with are put into a fixed number of retire slots and deleted by the producer in
+ * reclaim(), which publish() calls before every exchange.
+ *
+ * A published object that was never taken is replaced by the next publish() and returned from it.
+ */
+template <typename T, size_t RetireSlots = 4>
+class RealtimeHandoff
+{
+  static_assert(std::atomic<T *>::is_always_lock_free, "pointer exchange has to be lock-free");
+  static_assert(RetireSlots > 0, "at least one retire slot is needed");
+
+public:
+  RealtimeHandoff() = default;
+  RealtimeHandoff(const RealtimeHandoff &) = delete;
+  RealtimeHandoff & operator=(const RealtimeHandoff &) = delete;
+
+  ~RealtimeHandoff()
+  {
+    reclaim();
+    delete pending_.exchange(nullptr, std::memory_order_acquire);
+  }
+
+  /**
+   * Non-realtime: hands \p object over to the consumer.
+   *
+   * \return the previously published object if the consumer did not take it
+   */
+  std::unique_ptr<T> publish(std::unique_ptr<T> object)
+  {
+    reclaim();
+    return std::unique_ptr<T>(pending_.exchange(object.release(), std::memory_order_acq_rel));
+  }
+
+  /// Non-realtime: deletes all objects retired by the consumer.
+  void reclaim()
+  {
+    for (auto & slot : retired_)
+    {
+      delete slot.exchange(nullptr, std::memory_order_acquire);
+    }
+  }
+
+  /**
+   * Realtime: returns the most recently published object or nullptr if there is none.
+   *
+   * Nothing is taken while fewer than \p free_retire_slots retire slots are free, so the consumer
+   * is always able to retire the objects the new one is replacing.
+   */
+  T * try_take(size_t free_retire_slots = 1)
+  {
+    if (count_free_retire_slots() < free_retire_slots)
+    {
+      return nullptr;
+    }
+    return pending_.exchange(nullptr, std::memory_order_acq_rel);
+  }
+
+  /**
+   * Realtime: passes ownership of a previously taken \p object back for deletion by the producer.
+   *
+   * \return false if all retire slots are occupied, the caller keeps ownership then
+   */
+  bool retire(T * object)
+  {
+    if (object == nullptr)
+    {
+      return true;
+    }
+    for (auto & slot : retired_)
+    {
+      // only the consumer stores non-null values, so the slot cannot be taken in between
+      if (slot.load(std::memory_order_acquire) == nullptr)
+      {
+        slot.store(object, std::memory_order_release);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Realtime: retires \p object like retire(), calling \p on_retire with it right before.
+   *
+   * \p on_retire only runs once a retire slot is certain, it is the last point at which the object
+   * may be used, e.g. to report a result that must not be reported twice.
+   *
+   * \return false if all retire slots are occupied, \p object is left untouched then
+   */
+  template <typename Callback>
+  bool retire(std::unique_ptr<T> & object, Callback && on_retire)
+  {
+    if (!object)
+    {
+      return true;
+    }
+    for (auto & slot : retired_)
+    {
+      // only the consumer stores non-null values, so the slot stays free until the store below
+      if (slot.load(std::memory_order_acquire) == nullptr)
+      {
+        on_retire(*object);
+        slot.store(object.release(), std::memory_order_release);
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  size_t count_free_retire_slots() const
+  {
+    size_t count = 0;
+    for (const auto & slot : retired_)
+    {
+      if (slot.load(std::memory_order_acquire) == nullptr)
+      {
+        count++;
+      }
+    }
+    return count;
+  }
+
+  std::atomic<T *> pending_{nullptr};
+  std::array<std::atomic<T *>, RetireSlots> retired_{};
+};
+
+}  // namespace ros2_control_demo_example_7
+
+#endif  // ROS2_CONTROL_DEMO_EXAMPLE_7__REALTIME_HANDOFF_HPP_
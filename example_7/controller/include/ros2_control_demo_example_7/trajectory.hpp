@@ -0,0 +1,241 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS2_CONTROL_DEMO_EXAMPLE_7__TRAJECTORY_HPP_
+#define ROS2_CONTROL_DEMO_EXAMPLE_7__TRAJECTORY_HPP_
+
+#include <stddef.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ros2_control_demo_example_7/trajectory_file.hpp"
+#include "trajectory_msgs/msg/joint_trajectory.hpp"
+
+namespace ros2_control_demo_example_7
+{
+enum class InterpolationMethod
+{
+  /// linear blending of positions and velocities of neighbouring points
+  LINEAR,
+  /// cubic Hermite splines if velocities are given, quintic splines if accelerations are given
+  SPLINES,
+};
+
+/**
+ * Maps the joints of a trajectory message to the controlled \p joint_names.
+ *
+ * \p columns receives the index in \p joint_names of every joint in \p msg_joint_names.
+ * \return false and an explanation in \p error unless the message contains exactly the
+ * controlled joints
+ */
+bool map_joint_columns(
+  const std::vector<std::string> & msg_joint_names, const std::vector<std::string> & joint_names,
+  std::vector<size_t> & columns, std::string & error);
+
+/// Converts a time_from_start to seconds.
+double to_seconds(const builtin_interfaces::msg::Duration & duration);
+
+/// Parses the value of the interpolation_method parameter ("linear" or "splines").
+bool interpolation_method_from_string(const std::string & value, InterpolationMethod & method);
+
+/**
+ * Computes the coefficients of quintic polynomials of duration \p T between two states of \p dof
+ * joints. \p coefficients receives 6 * dof values, ordered by order with a stride of \p dof.
+ */
+void compute_quintic(
+  const double * p_0, const double * v_0, const double * a_0, const double * p_1,
+  const double * v_1, const double * a_1, double T, size_t dof, double * coefficients);
+
+/// Evaluates polynomials laid out as by compute_quintic() and their derivatives at \p tau.
+void evaluate_polynomial(
+  const double * coefficients, size_t degree, size_t dof, double tau, double * positions,
+  double * velocities, double * accelerations);
+
+/**
+ * Evaluates cubic Hermite polynomials of duration \p T between two states of \p dof joints and
+ * their derivatives at \p tau, for segments whose coefficients were not precomputed.
+ */
+void evaluate_cubic_hermite(
+  const double * p_0, const double * v_0, const double * p_1, const double * v_1, double T,
+  size_t dof, double tau, double * positions, double * velocities, double * accelerations);
+
+/**
+ * Joint trajectory stored as structure of arrays.
+ *
+ * The time stamps of all points are kept in one contiguous array, positions, velocities and
+ * accelerations in one contiguous array each, laid out point by point with a stride of dof().
+ * Sampling therefore only touches two adjacent rows of memory and the per-joint loops can be
+ * vectorized by the compiler.
+ *
+ * A trajectory is built once outside of the realtime thread and is immutable afterwards, the
+ * realtime thread only reads from it. For spline interpolation the polynomial coefficients of all
+ * segments are computed while building, so sampling is a single Horner evaluation per joint.
+ *
+ * The arrays are either owned by the trajectory or, for a trajectory loaded with from_file(), the
+ * arrays of a memory-mapped file that are used in place.
+ */
+class Trajectory
+{
+public:
+  Trajectory() = default;
+  // the array pointers refer to the own vectors, which are only moved without reallocating
+  Trajectory(const Trajectory &) = delete;
+  Trajectory & operator=(const Trajectory &) = delete;
+  Trajectory(Trajectory &&) = default;
+  Trajectory & operator=(Trajectory &&) = default;
+
+  /**
+   * Copies the points of \p msg into the internal arrays and prepares the segments for \p method.
+   *
+   * The values are reordered to follow \p joint_names, so column i of the arrays always belongs
+   * to joint_names[i] regardless of the order used by the sender.
+   * Splines need velocities; a trajectory with positions only is interpolated linearly.
+   *
+   * \return false and an explanation in \p error if the message is malformed, e.g. if it does not
+   * contain exactly the joints in \p joint_names, the number of values of a point does not match
+   * the number of joints or time_from_start is not increasing.
+   */
+  bool from_msg(
+    const trajectory_msgs::msg::JointTrajectory & msg, const std::vector<std::string> & joint_names,
+    InterpolationMethod method, std::string & error);
+
+  /**
+   * Executes the arrays of \p file in place, the trajectory keeps the mapping alive.
+   *
+   * Nothing is copied, so the joints of the file have to be \p joint_names in the same order.
+   * Spline segments are cubic Hermite polynomials evaluated without precomputed coefficients.
+   * A file with positions only is interpolated linearly, no velocities are allocated for it.
+   *
+   * \return false and an explanation in \p error if the joints of the file don't match or
+   * \p method is spline interpolation and the file has no velocities
+   */
+  bool from_file(
+    std::shared_ptr<const MappedTrajectoryFile> file, const std::vector<std::string> & joint_names,
+    InterpolationMethod method, std::string & error);
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+  size_t dof() const { return dof_; }
+  bool has_velocities() const { return has_velocities_; }
+  bool has_accelerations() const { return has_accelerations_; }
+
+  /// degree of the spline segments, 0 if the trajectory is interpolated linearly
+  size_t spline_degree() const { return degree_; }
+
+  /// time_from_start of the last point
+  double duration() const { return size_ == 0 ? 0.0 : times_data_[size_ - 1]; }
+
+  double time(size_t point) const { return times_data_[point]; }
+  const double * positions(size_t point) const { return positions_data_ + point * dof_; }
+  /// not available for a file without velocities, see from_file()
+  const double * velocities(size_t point) const { return velocities_data_ + point * dof_; }
+  const double * accelerations(size_t point) const { return accelerations_data_ + point * dof_; }
+
+  /**
+   * Returns the segment [index, index + 1] containing \p time.
+   *
+   * \p cursor is the segment returned in the previous cycle. It is advanced linearly for a few
+   * steps, which covers the regular case of time progressing by one control period. After a time
+   * jump we fall back to a binary search, so the amortized cost per cycle is O(1).
+   */
+  size_t find_segment(double time, size_t cursor) const;
+
+  /**
+   * Samples the trajectory at \p time.
+   *
+   * \p positions, \p velocities and \p accelerations have to point to arrays of dof() elements.
+   * At or beyond the end of the trajectory the last positions and zero velocities and
+   * accelerations are written.
+   *
+   * \return true if the end of the trajectory is reached
+   */
+  bool sample(
+    double time, size_t & cursor, double * positions, double * velocities,
+    double * accelerations) const;
+
+private:
+  void compute_cubic_coefficients();
+  void compute_quintic_coefficients();
+
+  /// coefficients of order \p order of all joints of segment \p segment
+  double * coefficients(size_t segment, size_t order)
+  {
+    return &coefficients_[(segment * (degree_ + 1) + order) * dof_];
+  }
+  const double * coefficients(size_t segment, size_t order) const
+  {
+    return &coefficients_[(segment * (degree_ + 1) + order) * dof_];
+  }
+
+  size_t size_ = 0;
+  size_t dof_ = 0;
+  size_t degree_ = 0;
+  bool has_velocities_ = false;
+  bool has_accelerations_ = false;
+
+  // the arrays that are sampled, either the vectors below or the arrays of file_
+  const double * times_data_ = nullptr;
+  const double * positions_data_ = nullptr;
+  const double * velocities_data_ = nullptr;
+  const double * accelerations_data_ = nullptr;
+  std::shared_ptr<const MappedTrajectoryFile> file_;
+
+  std::vector<double> times_;
+  std::vector<double> positions_;
+  std::vector<double> velocities_;
+  std::vector<double> accelerations_;
+  // polynomial coefficients in the local time of each segment, stored per segment and order
+  // with a stride of dof() so that one order of all joints is contiguous; empty for a mapped file
+  std::vector<double> coefficients_;
+};
+
+/**
+ * Quintic transition from the current state of the joints into a trajectory.
+ *
+ * Used to splice a newly received trajectory into the running motion without a jump in position,
+ * velocity or acceleration. compute() only samples the target trajectory once and solves one
+ * polynomial per joint, so it is cheap enough to be called in the realtime thread.
+ */
+class BlendSegment
+{
+public:
+  /// Allocates the internal buffers, not realtime safe.
+  void resize(size_t dof);
+
+  /**
+   * Computes the transition from \p positions, \p velocities and \p accelerations to the state of
+   * \p target at its time \p duration.
+   */
+  void compute(
+    const double * positions, const double * velocities, const double * accelerations,
+    const Trajectory & target, double duration);
+
+  double duration() const { return duration_; }
+
+  /// Samples the transition at \p time since its start.
+  void sample(double time, double * positions, double * velocities, double * accelerations) const;
+
+private:
+  size_t dof_ = 0;
+  double duration_ = 0.0;
+  std::vector<double> coefficients_;
+  std::vector<double> target_positions_;
+  std::vector<double> target_velocities_;
+  std::vector<double> target_accelerations_;
+};
+
+}  // namespace ros2_control_demo_example_7
+
+#endif  // ROS2_CONTROL_DEMO_EXAMPLE_7__TRAJECTORY_HPP_
@@ -0,0 +1,168 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS2_CONTROL_DEMO_EXAMPLE_7__TRAJECTORY_FILE_HPP_
+#define ROS2_CONTROL_DEMO_EXAMPLE_7__TRAJECTORY_FILE_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace ros2_control_demo_example_7
+{
+constexpr char TRAJECTORY_FILE_MAGIC[8] = {'R', '6', 'B', 'T', 'R', 'A', 'J', '\0'};
+constexpr uint32_t TRAJECTORY_FILE_VERSION = 1;
+/// alignment of the arrays in the file, a cache line
+constexpr uint64_t TRAJECTORY_FILE_ALIGNMENT = 64;
+
+/**
+ * Header at the start of a binary trajectory file.
+ *
+ * The header is followed by the joint names, each terminated by '\0', and by the arrays
+ *  - times: num_points doubles, time_from_start in seconds
+ *  - positions: num_points * num_joints doubles, point by point
+ *  - velocities: like positions, only present if HAS_VELOCITIES is set in flags
+ *
+ * Offsets are counted from the start of the file and every array starts at a multiple of
+ * TRAJECTORY_FILE_ALIGNMENT, so the arrays of a memory-mapped file are used in place. All values
+ * are stored in the byte order of the machine that wrote the file.
+ */
+struct TrajectoryFileHeader
+{
+  static constexpr uint32_t HAS_VELOCITIES = 1;
+
+  char magic[8];
+  uint32_t version;
+  uint32_t flags;
+  uint64_t num_points;
+  uint64_t num_joints;
+  uint64_t names_offset;
+  uint64_t names_size;
+  uint64_t times_offset;
+  uint64_t positions_offset;
+  uint64_t velocities_offset;
+  /// size of the whole file
+  uint64_t file_size;
+};
+
+/// Computes the header and thereby the layout of a file for the given trajectory.
+TrajectoryFileHeader make_trajectory_file_header(
+  const std::vector<std::string> & joint_names, uint64_t num_points, bool has_velocities);
+
+/**
+ * Writes a binary trajectory file whose size is known up front.
+ *
+ * The points can be written in any order and from several threads at once, as long as the ranges
+ * written concurrently don't overlap. This lets producers write their results as soon as they
+ * have them instead of collecting the whole trajectory in memory.
+ */
+class TrajectoryFileWriter
+{
+public:
+  TrajectoryFileWriter() = default;
+  TrajectoryFileWriter(const TrajectoryFileWriter &) = delete;
+  TrajectoryFileWriter & operator=(const TrajectoryFileWriter &) = delete;
+  ~TrajectoryFileWriter();
+
+  /**
+   * Creates \p filename for \p num_points points of \p joint_names and writes the header and names.
+   *
+   * \return false and an explanation in \p error if the file can't be created
+   */
+  bool open(
+    const std::string & filename, const std::vector<std::string> & joint_names,
+    uint64_t num_points, bool has_velocities, std::string & error);
+
+  /**
+   * Writes the points [first, first + count).
+   *
+   * \p positions and \p velocities hold count * num_joints values point by point, \p velocities
+   * is ignored if the file has none.
+   */
+  bool write_points(
+    uint64_t first, uint64_t count, const double * times, const double * positions,
+    const double * velocities);
+
+  /// Closes the file, returns false if any write failed.
+  bool close(std::string & error);
+
+  const TrajectoryFileHeader & header() const { return header_; }
+
+private:
+  bool write_at(uint64_t offset, const void * data, uint64_t size);
+
+  int fd_ = -1;
+  TrajectoryFileHeader header_{};
+  std::atomic<bool> failed_{false};
+};
+
+/**
+ * Read-only memory mapping of a binary trajectory file.
+ *
+ * open() checks the header and the time stamps, afterwards the arrays are used in place: nothing
+ * is copied, the pages are shared with the page cache and with every other process replaying the
+ * same file.
+ */
+class MappedTrajectoryFile
+{
+public:
+  MappedTrajectoryFile() = default;
+  MappedTrajectoryFile(const MappedTrajectoryFile &) = delete;
+  MappedTrajectoryFile & operator=(const MappedTrajectoryFile &) = delete;
+  ~MappedTrajectoryFile();
+
+  /**
+   * Maps \p filename and validates it.
+   *
+   * The kernel is asked to start reading the whole file in the background. It is not told that the
+   * file is read sequentially, the pages behind the reader are still needed for the binary search
+   * after a time jump and when the file is replayed. With \p populate all pages are mapped before
+   * open() returns, so reading the arrays later does not fault.
+   *
+   * \return false and an explanation in \p error if the file can't be mapped or is not a valid
+   * trajectory file of a supported version
+   */
+  bool open(const std::string & filename, bool populate, std::string & error);
+
+  const TrajectoryFileHeader & header() const { return header_; }
+  const std::vector<std::string> & joint_names() const { return joint_names_; }
+  bool has_velocities() const { return header_.flags & TrajectoryFileHeader::HAS_VELOCITIES; }
+
+  const double * times() const { return array(header_.times_offset); }
+  const double * positions() const { return array(header_.positions_offset); }
+  /// nullptr if the file has no velocities
+  const double * velocities() const
+  {
+    return has_velocities() ? array(header_.velocities_offset) : nullptr;
+  }
+
+private:
+  const double * array(uint64_t offset) const
+  {
+    return reinterpret_cast<const double *>(static_cast<const char *>(data_) + offset);
+  }
+  bool validate(std::string & error);
+  void advise(uint64_t offset, uint64_t size, int advice) const;
+
+  void * data_ = nullptr;
+  size_t size_ = 0;
+  TrajectoryFileHeader header_{};
+  std::vector<std::string> joint_names_;
+};
+
+}  // namespace ros2_control_demo_example_7
+
+#endif  // ROS2_CONTROL_DEMO_EXAMPLE_7__TRAJECTORY_FILE_HPP_
@@ -0,0 +1,132 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS2_CONTROL_DEMO_EXAMPLE_7__TRAJECTORY_STREAM_HPP_
+#define ROS2_CONTROL_DEMO_EXAMPLE_7__TRAJECTORY_STREAM_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ros2_control_demo_example_7/trajectory.hpp"
+#include "trajectory_msgs/msg/joint_trajectory.hpp"
+
+namespace ros2_control_demo_example_7
+{
+enum class StreamState
+{
+  /// no stream is executed
+  IDLE,
+  /// the stream is executed
+  RUNNING,
+  /// the next point did not arrive in time, the last one is held and the stream clock is paused
+  UNDERRUN,
+  /// the last point of the stream was reached in this cycle
+  FINISHED,
+};
+
+/**
+ * Bounded ring of trajectory points that are executed while later ones are still arriving.
+ *
+ * A long path is sent as a sequence of chunks, i.e. JointTrajectory messages whose
+ * time_from_start continues from the previous chunk, and terminated by a chunk without points.
+ * The ring is allocated once with a fixed capacity, so the memory used does not grow with the
+ * length of the path.
+ *
+ * The points are stored as structure of arrays like in Trajectory. One non-realtime producer
+ * appends chunks with push(), the realtime consumer samples the stream with sample(). The two
+ * only share the monotonic write and read counters, so neither of them ever waits for the other.
+ */
+class TrajectoryStream
+{
+public:
+  TrajectoryStream() = default;
+  TrajectoryStream(const TrajectoryStream &) = delete;
+  TrajectoryStream & operator=(const TrajectoryStream &) = delete;
+
+  /**
+   * Allocates room for \p capacity points of \p dof joints and drops the buffered ones.
+   *
+   * With InterpolationMethod::LINEAR the segments are interpolated like in Trajectory::sample().
+   */
+  void resize(size_t capacity, size_t dof, InterpolationMethod method);
+
+  /**
+   * Non-realtime: appends the points of \p chunk, or ends the stream if \p chunk has no points.
+   *
+   * Either all points of the chunk are appended or none.
+   *
+   * \return false and an explanation in \p error if the chunk is malformed, does not continue the
+   * time of the previous chunk or does not fit into the free part of the ring
+   */
+  bool push(
+    const trajectory_msgs::msg::JointTrajectory & chunk,
+    const std::vector<std::string> & joint_names, std::string & error);
+
+  /**
+   * Realtime: advances the stream by \p period seconds and samples it.
+   *
+   * Points that were passed are released to the producer. With splines, segments between points
+   * with velocities are interpolated as cubic Hermite splines, all others linearly. Nothing is
+   * written if the stream is IDLE.
+   */
+  StreamState sample(
+    double period, double * positions, double * velocities, double * accelerations);
+
+  /// Drops all buffered points and ends the stream, neither push() nor sample() may run.
+  void clear();
+
+  size_t capacity() const { return capacity_; }
+
+  /// number of times the consumer ran out of points in the middle of a stream
+  size_t underruns() const { return underruns_; }
+
+private:
+  size_t slot(size_t index) const { return index % capacity_; }
+  bool is_end_marker(size_t index) const;
+  void interpolate(
+    size_t index, double * positions, double * velocities, double * accelerations) const;
+  void hold(size_t index, double * positions, double * velocities, double * accelerations) const;
+
+  size_t capacity_ = 0;
+  size_t dof_ = 0;
+  InterpolationMethod method_ = InterpolationMethod::LINEAR;
+  std::vector<double> times_;
+  std::vector<double> positions_;
+  std::vector<double> velocities_;
+  std::vector<uint8_t> has_velocities_;
+
+  // total number of points written by the producer and released by the consumer
+  std::atomic<size_t> write_{0};
+  std::atomic<size_t> read_{0};
+
+  // producer state
+  std::mutex producer_mutex_;
+  std::vector<size_t> columns_;
+  double last_time_ = 0.0;
+  bool stream_open_ = false;
+
+  // consumer state
+  bool running_ = false;
+  bool underrun_ = false;
+  double stream_time_ = 0.0;
+  size_t underruns_ = 0;
+};
+
+}  // namespace ros2_control_demo_example_7
+
+#endif  // ROS2_CONTROL_DEMO_EXAMPLE_7__TRAJECTORY_STREAM_HPP_
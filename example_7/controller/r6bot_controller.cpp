@@ -16,12 +16,16 @@
 
 #include <stddef.h>
 #include <algorithm>
+#include <iterator>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "lifecycle_msgs/msg/state.hpp"
 #include "rclcpp/qos.hpp"
 #include "rclcpp/time.hpp"
+#include "rclcpp_action/create_server.hpp"
 #include "rclcpp_lifecycle/node_interfaces/lifecycle_node_interface.hpp"
 #include "rclcpp_lifecycle/state.hpp"
 
@@ -29,6 +33,14 @@ using config_type = controller_interface::interface_configuration_type;
 
 namespace ros2_control_demo_example_7
 {
+namespace
+{
+bool is_cancel_requested(const TrajectoryRequest & request)
+{
+  return request.cancel_requested && request.cancel_requested->load(std::memory_order_acquire);
+}
+}  // namespace
+
 RobotController::RobotController() : controller_interface::ControllerInterface() {}
 
 controller_interface::CallbackReturn RobotController::on_init()
@@ -39,9 +51,17 @@ controller_interface::CallbackReturn RobotController::on_init()
     auto_declare<std::vector<std::string>>("command_interfaces", command_interface_types_);
   state_interface_types_ =
     auto_declare<std::vector<std::string>>("state_interfaces", state_interface_types_);
+  auto_declare<std::string>("interpolation_method", "linear");
+  auto_declare<std::string>("new_trajectory_mode", "replace");
+  auto_declare<double>("blend_duration", blend_duration_);
+  auto_declare<double>("action_monitor_rate", 20.0);
+  auto_declare<int>("stream_buffer_size", 10000);
+  auto_declare<bool>("populate_trajectory_files", populate_trajectory_files_);
 
   point_interp_.positions.assign(joint_names_.size(), 0);
   point_interp_.velocities.assign(joint_names_.size(), 0);
+  point_interp_.accelerations.assign(joint_names_.size(), 0);
+  blend_.resize(joint_names_.size());
 
   return CallbackReturn::SUCCESS;
 }
@@ -81,131 +101,588 @@ controller_interface::InterfaceConfiguration RobotController::state_interface_co
 
 controller_interface::CallbackReturn RobotController::on_configure(const rclcpp_lifecycle::State &)
 {
-  auto callback = [this](const trajectory_msgs::msg::JointTrajectory traj_msg) -> void
+  const auto interpolation_method = get_node()->get_parameter("interpolation_method").as_string();
+  if (!interpolation_method_from_string(interpolation_method, interpolation_method_))
+  {
+    RCLCPP_ERROR(
+      get_node()->get_logger(),
+      "Unknown interpolation_method '%s', expected 'linear' or 'splines'.",
+      interpolation_method.c_str());
+    return CallbackReturn::FAILURE;
+  }
+
+  const auto new_trajectory_mode = get_node()->get_parameter("new_trajectory_mode").as_string();
+  if (new_trajectory_mode == "replace")
+  {
+    new_trajectory_mode_ = NewTrajectoryMode::REPLACE;
+  }
+  else if (new_trajectory_mode == "append")
+  {
+    new_trajectory_mode_ = NewTrajectoryMode::APPEND;
+  }
+  else if (new_trajectory_mode == "blend")
+  {
+    new_trajectory_mode_ = NewTrajectoryMode::BLEND;
+  }
+  else
+  {
+    RCLCPP_ERROR(
+      get_node()->get_logger(),
+      "Unknown new_trajectory_mode '%s', expected 'replace', 'append' or 'blend'.",
+      new_trajectory_mode.c_str());
+    return CallbackReturn::FAILURE;
+  }
+
+  blend_duration_ = get_node()->get_parameter("blend_duration").as_double();
+  if (blend_duration_ <= 0.0)
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "blend_duration has to be positive.");
+    return CallbackReturn::FAILURE;
+  }
+
+  const double action_monitor_rate = get_node()->get_parameter("action_monitor_rate").as_double();
+  if (action_monitor_rate <= 0.0)
+  {
+    RCLCPP_ERROR(get_node()->get_logger(), "action_monitor_rate has to be positive.");
+    return CallbackReturn::FAILURE;
+  }
+  action_monitor_period_ = rclcpp::Duration::from_seconds(1.0 / action_monitor_rate);
+
+  const auto stream_buffer_size = get_node()->get_parameter("stream_buffer_size").as_int();
+  if (stream_buffer_size <= 0)
   {
+    RCLCPP_ERROR(get_node()->get_logger(), "stream_buffer_size has to be positive.");
+    return CallbackReturn::FAILURE;
+  }
+  stream_.resize(
+    static_cast<size_t>(stream_buffer_size), joint_names_.size(), interpolation_method_);
+  populate_trajectory_files_ = get_node()->get_parameter("populate_trajectory_files").as_bool();
+
+  // the trajectory is converted here, outside of the realtime thread, and only the pointer to it
+  // is exchanged with update()
+  auto callback = [this](const std::shared_ptr<trajectory_msgs::msg::JointTrajectory> traj_msg)
+  {
+    auto request = std::make_unique<TrajectoryRequest>();
+    std::string error;
+    if (!request->trajectory.from_msg(*traj_msg, joint_names_, interpolation_method_, error))
+    {
+      RCLCPP_ERROR(get_node()->get_logger(), "Rejected trajectory: %s", error.c_str());
+      return;
+    }
+
     RCLCPP_INFO(get_node()->get_logger(), "Received new trajectory.");
-    traj_msg_external_.set(traj_msg);
-    new_msg_ = true;
+    publish_request(std::move(request));
   };
 
   joint_command_subscriber_ =
     get_node()->create_subscription<trajectory_msgs::msg::JointTrajectory>(
       "~/joint_trajectory", rclcpp::SystemDefaultsQoS(), callback);
 
+  // trajectory files are mapped here and executed from the mapped pages, nothing is deserialized;
+  // populating the mapping moves the page faults from update() to this callback
+  auto file_callback = [this](const std::shared_ptr<std_msgs::msg::String> filename_msg)
+  {
+    auto file = std::make_shared<MappedTrajectoryFile>();
+    auto request = std::make_unique<TrajectoryRequest>();
+    std::string error;
+    if (
+      !file->open(filename_msg->data, populate_trajectory_files_, error) ||
+      !request->trajectory.from_file(file, joint_names_, interpolation_method_, error))
+    {
+      RCLCPP_ERROR(get_node()->get_logger(), "Rejected trajectory file: %s", error.c_str());
+      return;
+    }
+
+    RCLCPP_INFO(
+      get_node()->get_logger(), "Loaded trajectory file '%s' with %zu points.",
+      filename_msg->data.c_str(), request->trajectory.size());
+    publish_request(std::move(request));
+  };
+
+  trajectory_file_subscriber_ = get_node()->create_subscription<std_msgs::msg::String>(
+    "~/trajectory_file", rclcpp::SystemDefaultsQoS(), file_callback);
+
+  // chunks are copied into the ring right here, update() consumes them while more arrive
+  auto stream_callback =
+    [this](const std::shared_ptr<trajectory_msgs::msg::JointTrajectory> chunk_msg)
+  {
+    std::string error;
+    if (!stream_.push(*chunk_msg, joint_names_, error))
+    {
+      RCLCPP_ERROR(get_node()->get_logger(), "Rejected trajectory chunk: %s", error.c_str());
+    }
+  };
+
+  stream_subscriber_ = get_node()->create_subscription<trajectory_msgs::msg::JointTrajectory>(
+    "~/joint_trajectory_stream", rclcpp::SystemDefaultsQoS(), stream_callback);
+
+  using GoalHandle = rclcpp_action::ServerGoalHandle<FollowJointTrajectory>;
+
+  auto goal_callback =
+    [this](const rclcpp_action::GoalUUID &, std::shared_ptr<const FollowJointTrajectory::Goal>)
+  {
+    if (get_lifecycle_state().id() != lifecycle_msgs::msg::State::PRIMARY_STATE_ACTIVE)
+    {
+      RCLCPP_ERROR(get_node()->get_logger(), "Can't accept new goal, controller is not active.");
+      return rclcpp_action::GoalResponse::REJECT;
+    }
+    return rclcpp_action::GoalResponse::ACCEPT_AND_EXECUTE;
+  };
+
+  auto cancel_callback = [this](const std::shared_ptr<GoalHandle> goal_handle)
+  {
+    // update() sees the flag, stops the trajectory of the goal and reports the cancellation
+    std::lock_guard<std::mutex> guard(goals_mutex_);
+    for (const auto & accepted : goals_)
+    {
+      if (accepted.goal->gh_ == goal_handle)
+      {
+        RCLCPP_INFO(get_node()->get_logger(), "Canceling goal.");
+        accepted.cancel_requested->store(true, std::memory_order_release);
+      }
+    }
+    return rclcpp_action::CancelResponse::ACCEPT;
+  };
+
+  auto accepted_callback = [this](std::shared_ptr<GoalHandle> goal_handle)
+  {
+    auto request = std::make_unique<TrajectoryRequest>();
+    std::string error;
+    if (!request->trajectory.from_msg(
+          goal_handle->get_goal()->trajectory, joint_names_, interpolation_method_, error))
+    {
+      RCLCPP_ERROR(get_node()->get_logger(), "Rejected goal: %s", error.c_str());
+      auto result = std::make_shared<FollowJointTrajectory::Result>();
+      result->error_code = FollowJointTrajectory::Result::INVALID_GOAL;
+      result->error_string = error;
+      goal_handle->abort(result);
+      return;
+    }
+
+    // everything update() writes to is allocated here
+    auto result = std::make_shared<FollowJointTrajectory::Result>();
+    result->error_string.reserve(64);
+    auto feedback = std::make_shared<FollowJointTrajectory::Feedback>();
+    feedback->joint_names = joint_names_;
+    for (auto * point : {&feedback->desired, &feedback->actual, &feedback->error})
+    {
+      point->positions.assign(joint_names_.size(), 0.0);
+      point->velocities.assign(joint_names_.size(), 0.0);
+    }
+
+    auto goal = std::make_shared<RealtimeGoalHandle>(goal_handle, result, feedback);
+    auto cancel_requested = std::make_shared<std::atomic<bool>>(false);
+    goal->execute();
+    {
+      std::lock_guard<std::mutex> guard(goals_mutex_);
+      goals_.push_back({goal, cancel_requested});
+    }
+
+    RCLCPP_INFO(get_node()->get_logger(), "Accepted new goal.");
+    request->goal = goal;
+    request->cancel_requested = cancel_requested;
+    publish_request(std::move(request));
+  };
+
+  action_server_ = rclcpp_action::create_server<FollowJointTrajectory>(
+    get_node()->get_node_base_interface(), get_node()->get_node_clock_interface(),
+    get_node()->get_node_logging_interface(), get_node()->get_node_waitables_interface(),
+    std::string(get_node()->get_name()) + "/follow_joint_trajectory", goal_callback,
+    cancel_callback, accepted_callback);
+
+  // feedback and results requested by update() are sent from here
+  goal_monitor_timer_ = get_node()->create_wall_timer(
+    action_monitor_period_.to_chrono<std::chrono::nanoseconds>(), [this]() { monitor_goals(); });
+
   return CallbackReturn::SUCCESS;
 }
 
+void RobotController::publish_request(std::unique_ptr<TrajectoryRequest> request)
+{
+  auto dropped = traj_handoff_.publish(std::move(request));
+  if (dropped && dropped->goal)
+  {
+    auto & result = dropped->goal->preallocated_result_;
+    result->error_string = "Replaced by a newer request before execution.";
+    dropped->goal->setCanceled(result);
+  }
+}
+
+void RobotController::monitor_goals()
+{
+  std::lock_guard<std::mutex> guard(goals_mutex_);
+  for (const auto & accepted : goals_)
+  {
+    accepted.goal->runNonRealtime();
+  }
+  goals_.erase(
+    std::remove_if(
+      goals_.begin(), goals_.end(),
+      [](const AcceptedGoal & accepted) { return !accepted.goal->gh_->is_active(); }),
+    goals_.end());
+}
+
 controller_interface::CallbackReturn RobotController::on_activate(const rclcpp_lifecycle::State &)
 {
-  // clear out vectors in case of restart
-  joint_position_command_interface_.clear();
-  joint_velocity_command_interface_.clear();
-  joint_position_state_interface_.clear();
-  joint_velocity_state_interface_.clear();
+  // resolve the interfaces to the joint indices once, update() then only follows the pointers
+  joint_position_command_handles_.assign(joint_names_.size(), nullptr);
+  joint_velocity_command_handles_.assign(joint_names_.size(), nullptr);
+  joint_position_state_handles_.assign(joint_names_.size(), nullptr);
+  joint_velocity_state_handles_.assign(joint_names_.size(), nullptr);
+  failed_command_writes_ = 0;
+
+  auto assign = [this](auto & interface, auto & position_handles, auto & velocity_handles)
+  {
+    auto it = std::find(joint_names_.begin(), joint_names_.end(), interface.get_prefix_name());
+    if (it == joint_names_.end())
+    {
+      RCLCPP_ERROR(
+        get_node()->get_logger(), "Interface '%s' does not belong to a configured joint.",
+        interface.get_name().c_str());
+      return false;
+    }
+    const size_t joint = static_cast<size_t>(std::distance(joint_names_.begin(), it));
+    if (interface.get_interface_name() == hardware_interface::HW_IF_POSITION)
+    {
+      position_handles[joint] = &interface;
+    }
+    else if (interface.get_interface_name() == hardware_interface::HW_IF_VELOCITY)
+    {
+      velocity_handles[joint] = &interface;
+    }
+    else
+    {
+      RCLCPP_ERROR(
+        get_node()->get_logger(), "Interface type of '%s' is not supported.",
+        interface.get_name().c_str());
+      return false;
+    }
+    return true;
+  };
 
-  // assign command interfaces
   for (auto & interface : command_interfaces_)
   {
-    command_interface_map_[interface.get_interface_name()]->push_back(interface);
+    if (!assign(interface, joint_position_command_handles_, joint_velocity_command_handles_))
+    {
+      return CallbackReturn::ERROR;
+    }
   }
-
-  // assign state interfaces
   for (auto & interface : state_interfaces_)
   {
-    state_interface_map_[interface.get_interface_name()]->push_back(interface);
+    if (!assign(interface, joint_position_state_handles_, joint_velocity_state_handles_))
+    {
+      return CallbackReturn::ERROR;
+    }
   }
 
   return CallbackReturn::SUCCESS;
 }
 
-void interpolate_point(
-  const trajectory_msgs::msg::JointTrajectoryPoint & point_1,
-  const trajectory_msgs::msg::JointTrajectoryPoint & point_2,
-  trajectory_msgs::msg::JointTrajectoryPoint & point_interp, double delta)
+void RobotController::start_trajectory(
+  std::unique_ptr<const TrajectoryRequest> request, const rclcpp::Time & start_time, double splice)
+{
+  active_request_ = std::move(request);
+  trajectory_done_ = false;
+  start_time_ = start_time;
+  last_feedback_time_ = start_time;
+  segment_index_ = 0;
+
+  // point_interp_ still holds the last command, the transition into the trajectory starts there
+  const Trajectory & trajectory = active_request_->trajectory;
+  splice = std::min(splice, trajectory.duration());
+  blending_ = splice > 0.0;
+  if (blending_)
+  {
+    blend_.compute(
+      point_interp_.positions.data(), point_interp_.velocities.data(),
+      point_interp_.accelerations.data(), trajectory, splice);
+  }
+}
+
+void RobotController::handle_cancel_requests()
 {
-  for (size_t i = 0; i < point_1.positions.size(); i++)
+  if (queued_request_ && is_cancel_requested(*queued_request_))
   {
-    point_interp.positions[i] = delta * point_2.positions[i] + (1.0 - delta) * point_1.positions[i];
+    // tried again in the next cycle if no retire slot is free
+    traj_handoff_.retire(
+      queued_request_,
+      [](const TrajectoryRequest & canceled)
+      {
+        canceled.goal->preallocated_result_->error_string = "Canceled before execution.";
+        canceled.goal->setCanceled(canceled.goal->preallocated_result_);
+      });
   }
-  for (size_t i = 0; i < point_1.positions.size(); i++)
+  if (!trajectory_done_ && is_cancel_requested(*active_request_))
   {
-    point_interp.velocities[i] =
-      delta * point_2.velocities[i] + (1.0 - delta) * point_1.velocities[i];
+    const auto & goal = active_request_->goal;
+    goal->preallocated_result_->error_string = "Canceled during execution.";
+    goal->setCanceled(goal->preallocated_result_);
+
+    // hold the last commanded position
+    trajectory_done_ = true;
+    blending_ = false;
+    std::fill(point_interp_.velocities.begin(), point_interp_.velocities.end(), 0.0);
+    std::fill(point_interp_.accelerations.begin(), point_interp_.accelerations.end(), 0.0);
+    write_commands();
   }
 }
 
-void interpolate_trajectory_point(
-  const trajectory_msgs::msg::JointTrajectory & traj_msg, const rclcpp::Duration & cur_time,
-  trajectory_msgs::msg::JointTrajectoryPoint & point_interp, bool & reached_end)
+bool RobotController::sample_command(double time)
 {
-  double traj_len = static_cast<double>(traj_msg.points.size());
-  auto last_time = traj_msg.points.back().time_from_start;
-  double total_time = last_time.sec + last_time.nanosec * 1E-9;
-  double cur_time_sec = cur_time.seconds();
-  reached_end = (cur_time_sec >= total_time);
+  if (blending_ && time < blend_.duration())
+  {
+    blend_.sample(
+      time, point_interp_.positions.data(), point_interp_.velocities.data(),
+      point_interp_.accelerations.data());
+    return false;
+  }
+  blending_ = false;
+
+  return active_request_->trajectory.sample(
+    time, segment_index_, point_interp_.positions.data(), point_interp_.velocities.data(),
+    point_interp_.accelerations.data());
+}
 
-  // If we reached the end of the trajectory, set the velocities to zero.
-  if (reached_end)
+bool RobotController::update_stream(double period)
+{
+  const StreamState state = stream_.sample(
+    period, point_interp_.positions.data(), point_interp_.velocities.data(),
+    point_interp_.accelerations.data());
+  if (state == StreamState::IDLE)
   {
-    point_interp.positions = traj_msg.points.back().positions;
-    std::fill(point_interp.velocities.begin(), point_interp.velocities.end(), 0.0);
-    return;
+    return false;
   }
 
-  size_t ind =
-    static_cast<size_t>(cur_time_sec * (traj_len / total_time));  // Assumes evenly spaced points.
-  ind = std::min(ind, static_cast<size_t>(traj_len) - 2);
-  double delta = std::min(cur_time_sec - static_cast<double>(ind) * (total_time / traj_len), 1.0);
-  interpolate_point(traj_msg.points[ind], traj_msg.points[ind + 1], point_interp, delta);
+  // the stream takes over from the trajectory that is executed
+  if (!trajectory_done_)
+  {
+    if (active_request_->goal)
+    {
+      const auto & goal = active_request_->goal;
+      goal->preallocated_result_->error_string = "Replaced by a trajectory stream.";
+      goal->setCanceled(goal->preallocated_result_);
+    }
+    if (queued_request_ && queued_request_->goal)
+    {
+      const auto & goal = queued_request_->goal;
+      goal->preallocated_result_->error_string = "Replaced by a trajectory stream.";
+      goal->setCanceled(goal->preallocated_result_);
+    }
+    if (queued_request_ && traj_handoff_.retire(queued_request_.get()))
+    {
+      queued_request_.release();
+    }
+    trajectory_done_ = true;
+    blending_ = false;
+  }
+
+  if (state == StreamState::UNDERRUN)
+  {
+    RCLCPP_WARN_THROTTLE(
+      get_node()->get_logger(), *get_node()->get_clock(), 1000,
+      "Trajectory stream underrun, holding the last point (%zu underruns so far).",
+      stream_.underruns());
+  }
+  else if (state == StreamState::FINISHED)
+  {
+    RCLCPP_INFO(get_node()->get_logger(), "Trajectory stream execution complete.");
+  }
+
+  write_commands();
+  return true;
 }
 
-controller_interface::return_type RobotController::update(
-  const rclcpp::Time & time, const rclcpp::Duration & /*period*/)
+void RobotController::write_commands()
 {
-  if (new_msg_)
+  size_t failures = 0;
+  for (size_t i = 0; i < joint_names_.size(); i++)
   {
-    auto trajectory_msg_op = traj_msg_external_.try_get();
-    if (trajectory_msg_op.has_value())
+    if (auto * handle = joint_position_command_handles_[i])
+    {
+      failures += handle->set_value(point_interp_.positions[i]) ? 0 : 1;
+    }
+    if (auto * handle = joint_velocity_command_handles_[i])
     {
-      trajectory_msg_ = trajectory_msg_op.value();
-      start_time_ = time;
-      new_msg_ = false;
+      failures += handle->set_value(point_interp_.velocities[i]) ? 0 : 1;
     }
   }
+  if (failures > 0)
+  {
+    failed_command_writes_ += failures;
+    RCLCPP_ERROR_THROTTLE(
+      get_node()->get_logger(), *get_node()->get_clock(), 1000,
+      "Failed to set %zu command values so far.", failed_command_writes_);
+  }
+}
 
-  if (!trajectory_msg_.points.empty())
+void RobotController::update_feedback(const rclcpp::Time & time)
+{
+  const auto & goal = active_request_->goal;
+  if (!goal || time - last_feedback_time_ < action_monitor_period_)
   {
-    bool reached_end;
-    interpolate_trajectory_point(trajectory_msg_, time - start_time_, point_interp_, reached_end);
+    return;
+  }
+  last_feedback_time_ = time;
 
-    // If we have reached the end of the trajectory, reset it..
-    if (reached_end)
+  // the vectors were sized when the goal was accepted
+  auto & feedback = *goal->preallocated_feedback_;
+  feedback.header.stamp = time;
+  for (size_t i = 0; i < joint_names_.size(); i++)
+  {
+    feedback.desired.positions[i] = point_interp_.positions[i];
+    feedback.desired.velocities[i] = point_interp_.velocities[i];
+    if (joint_position_state_handles_[i])
     {
-      RCLCPP_INFO(get_node()->get_logger(), "Trajectory execution complete.");
-      trajectory_msg_.points.clear();
+      feedback.actual.positions[i] =
+        joint_position_state_handles_[i]->get_optional().value_or(feedback.actual.positions[i]);
+    }
+    if (joint_velocity_state_handles_[i])
+    {
+      feedback.actual.velocities[i] =
+        joint_velocity_state_handles_[i]->get_optional().value_or(feedback.actual.velocities[i]);
     }
+    feedback.error.positions[i] = feedback.desired.positions[i] - feedback.actual.positions[i];
+    feedback.error.velocities[i] = feedback.desired.velocities[i] - feedback.actual.velocities[i];
+  }
+  goal->setFeedback(goal->preallocated_feedback_);
+}
+
+controller_interface::return_type RobotController::update(
+  const rclcpp::Time & time, const rclcpp::Duration & period)
+{
+  // trajectories received during a stream wait in traj_handoff_ until it ends
+  if (update_stream(period.seconds()))
+  {
+    return controller_interface::return_type::OK;
+  }
 
-    for (size_t i = 0; i < joint_position_command_interface_.size(); i++)
+  // keep room for retiring the replaced request and, in append mode, the one that is executed
+  // when the queued request takes over
+  if (const TrajectoryRequest * taken = traj_handoff_.try_take(2))
+  {
+    std::unique_ptr<const TrajectoryRequest> request(taken);
+    if (is_cancel_requested(*request))
+    {
+      request->goal->preallocated_result_->error_string = "Canceled before execution.";
+      request->goal->setCanceled(request->goal->preallocated_result_);
+      traj_handoff_.retire(request.release());
+    }
+    else if (new_trajectory_mode_ == NewTrajectoryMode::APPEND && !trajectory_done_)
     {
-      if (!joint_position_command_interface_[i].get().set_value(point_interp_.positions[i]))
+      // a newer trajectory replaces one that is still waiting
+      if (queued_request_ && queued_request_->goal)
       {
-        RCLCPP_ERROR(get_node()->get_logger(), "Failed to set position value for index %ld", i);
+        const auto & goal = queued_request_->goal;
+        goal->preallocated_result_->error_string = "Replaced by a newer trajectory.";
+        goal->setCanceled(goal->preallocated_result_);
       }
+      traj_handoff_.retire(queued_request_.release());
+      queued_request_ = std::move(request);
     }
-    for (size_t i = 0; i < joint_velocity_command_interface_.size(); i++)
+    else
     {
-      if (!joint_velocity_command_interface_[i].get().set_value(point_interp_.velocities[i]))
+      if (!trajectory_done_ && active_request_->goal)
+      {
+        const auto & goal = active_request_->goal;
+        goal->preallocated_result_->error_string = "Replaced by a new trajectory.";
+        goal->setCanceled(goal->preallocated_result_);
+      }
+
+      // without a previous command there is nothing to transition from
+      double splice = 0.0;
+      if (active_request_ && new_trajectory_mode_ == NewTrajectoryMode::BLEND)
       {
-        RCLCPP_ERROR(get_node()->get_logger(), "Failed to set velocity value for index %ld", i);
+        splice = blend_duration_;
       }
+      else if (active_request_ && new_trajectory_mode_ == NewTrajectoryMode::APPEND)
+      {
+        splice = request->trajectory.time(0);
+      }
+      traj_handoff_.retire(active_request_.release());
+      start_trajectory(std::move(request), time, splice);
     }
   }
 
+  handle_cancel_requests();
+
+  if (!trajectory_done_)
+  {
+    bool reached_end = sample_command((time - start_time_).seconds());
+
+    // continue with the appended trajectory where the current one ended, moving from its last
+    // point to the first point of the appended one
+    if (reached_end && queued_request_)
+    {
+      const rclcpp::Time end_time =
+        start_time_ + rclcpp::Duration::from_seconds(active_request_->trajectory.duration());
+      const double splice = queued_request_->trajectory.time(0);
+      const bool retired = traj_handoff_.retire(
+        active_request_,
+        [](const TrajectoryRequest & finished)
+        {
+          if (finished.goal)
+          {
+            finished.goal->setSucceeded(finished.goal->preallocated_result_);
+          }
+        });
+      if (retired)
+      {
+        start_trajectory(std::move(queued_request_), end_time, splice);
+        reached_end = sample_command((time - start_time_).seconds());
+      }
+      else
+      {
+        // no retire slot until the producer reclaims one, hold the last point and try again in
+        // the next cycle without finishing the goal
+        reached_end = false;
+      }
+    }
+
+    // If we have reached the end of the trajectory, stop executing it. It is kept until the next
+    // one arrives, so that it is not freed in the realtime thread.
+    if (reached_end)
+    {
+      RCLCPP_INFO(get_node()->get_logger(), "Trajectory execution complete.");
+      trajectory_done_ = true;
+      if (active_request_->goal)
+      {
+        active_request_->goal->setSucceeded(active_request_->goal->preallocated_result_);
+      }
+    }
+    else
+    {
+      update_feedback(time);
+    }
+
+    write_commands();
+  }
+
   return controller_interface::return_type::OK;
 }
 
 controller_interface::CallbackReturn RobotController::on_deactivate(const rclcpp_lifecycle::State &)
 {
+  // update() is not running anymore, release the trajectories outside of the realtime loop. This
+  // also drops a request that was published but not taken yet, it would otherwise be executed
+  // after reactivation although its goal is aborted below.
+  traj_handoff_.publish(nullptr);
+  active_request_.reset();
+  queued_request_.reset();
+  trajectory_done_ = true;
+  blending_ = false;
+  stream_.clear();
+
+  // goals can't be executed anymore
+  std::lock_guard<std::mutex> guard(goals_mutex_);
+  for (const auto & accepted : goals_)
+  {
+    const auto & goal = accepted.goal;
+    goal->preallocated_result_->error_string = "Controller was deactivated.";
+    goal->setAborted(goal->preallocated_result_);
+    goal->runNonRealtime();
+  }
+  goals_.clear();
+
   return CallbackReturn::SUCCESS;
 }
 
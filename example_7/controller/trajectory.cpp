@@ -0,0 +1,430 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ros2_control_demo_example_7/trajectory.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+
+namespace ros2_control_demo_example_7
+{
+void compute_quintic(
+  const double * p_0, const double * v_0, const double * a_0, const double * p_1,
+  const double * v_1, const double * a_1, double T, size_t dof, double * coefficients)
+{
+  const double T2 = T * T;
+  const double T3 = T2 * T;
+  double * c_0 = coefficients;
+  double * c_1 = c_0 + dof;
+  double * c_2 = c_1 + dof;
+  double * c_3 = c_2 + dof;
+  double * c_4 = c_3 + dof;
+  double * c_5 = c_4 + dof;
+  for (size_t i = 0; i < dof; i++)
+  {
+    const double dp = p_1[i] - p_0[i];
+    c_0[i] = p_0[i];
+    c_1[i] = v_0[i];
+    c_2[i] = 0.5 * a_0[i];
+    c_3[i] =
+      (20.0 * dp - (8.0 * v_1[i] + 12.0 * v_0[i]) * T - (3.0 * a_0[i] - a_1[i]) * T2) / (2.0 * T3);
+    c_4[i] =
+      (-30.0 * dp + (14.0 * v_1[i] + 16.0 * v_0[i]) * T + (3.0 * a_0[i] - 2.0 * a_1[i]) * T2) /
+      (2.0 * T3 * T);
+    c_5[i] =
+      (12.0 * dp - 6.0 * (v_1[i] + v_0[i]) * T - (a_0[i] - a_1[i]) * T2) / (2.0 * T3 * T2);
+  }
+}
+
+void evaluate_polynomial(
+  const double * coefficients, size_t degree, size_t dof, double tau, double * positions,
+  double * velocities, double * accelerations)
+{
+  // Horner evaluation of the polynomial and its first two derivatives, the inner loops run over
+  // the contiguous coefficients of all joints
+  const double * c = coefficients + degree * dof;
+  std::copy(c, c + dof, positions);
+  std::fill(velocities, velocities + dof, 0.0);
+  std::fill(accelerations, accelerations + dof, 0.0);
+  for (size_t order = degree; order-- > 0;)
+  {
+    c = coefficients + order * dof;
+    for (size_t i = 0; i < dof; i++)
+    {
+      accelerations[i] = accelerations[i] * tau + velocities[i];
+      velocities[i] = velocities[i] * tau + positions[i];
+      positions[i] = positions[i] * tau + c[i];
+    }
+  }
+  for (size_t i = 0; i < dof; i++)
+  {
+    accelerations[i] *= 2.0;
+  }
+}
+
+void evaluate_cubic_hermite(
+  const double * p_0, const double * v_0, const double * p_1, const double * v_1, double T,
+  size_t dof, double tau, double * positions, double * velocities, double * accelerations)
+{
+  for (size_t i = 0; i < dof; i++)
+  {
+    const double c_2 = (3.0 * (p_1[i] - p_0[i]) - (2.0 * v_0[i] + v_1[i]) * T) / (T * T);
+    const double c_3 = (2.0 * (p_0[i] - p_1[i]) + (v_0[i] + v_1[i]) * T) / (T * T * T);
+    positions[i] = p_0[i] + tau * (v_0[i] + tau * (c_2 + tau * c_3));
+    velocities[i] = v_0[i] + tau * (2.0 * c_2 + 3.0 * c_3 * tau);
+    accelerations[i] = 2.0 * c_2 + 6.0 * c_3 * tau;
+  }
+}
+
+bool map_joint_columns(
+  const std::vector<std::string> & msg_joint_names, const std::vector<std::string> & joint_names,
+  std::vector<size_t> & columns, std::string & error)
+{
+  if (msg_joint_names.size() != joint_names.size())
+  {
+    error = "trajectory has " + std::to_string(msg_joint_names.size()) + " joints, expected " +
+            std::to_string(joint_names.size());
+    return false;
+  }
+
+  columns.resize(joint_names.size());
+  std::vector<bool> assigned(joint_names.size(), false);
+  for (size_t j = 0; j < msg_joint_names.size(); j++)
+  {
+    auto it = std::find(joint_names.begin(), joint_names.end(), msg_joint_names[j]);
+    if (it == joint_names.end())
+    {
+      error = "joint '" + msg_joint_names[j] + "' is not controlled";
+      return false;
+    }
+    columns[j] = static_cast<size_t>(std::distance(joint_names.begin(), it));
+    if (assigned[columns[j]])
+    {
+      error = "joint '" + msg_joint_names[j] + "' is given more than once";
+      return false;
+    }
+    assigned[columns[j]] = true;
+  }
+  return true;
+}
+
+double to_seconds(const builtin_interfaces::msg::Duration & duration)
+{
+  return static_cast<double>(duration.sec) + static_cast<double>(duration.nanosec) * 1E-9;
+}
+
+bool interpolation_method_from_string(const std::string & value, InterpolationMethod & method)
+{
+  if (value == "linear")
+  {
+    method = InterpolationMethod::LINEAR;
+    return true;
+  }
+  if (value == "splines")
+  {
+    method = InterpolationMethod::SPLINES;
+    return true;
+  }
+  return false;
+}
+
+bool Trajectory::from_msg(
+  const trajectory_msgs::msg::JointTrajectory & msg, const std::vector<std::string> & joint_names,
+  InterpolationMethod method, std::string & error)
+{
+  const auto & points = msg.points;
+  if (points.empty())
+  {
+    error = "trajectory has no points";
+    return false;
+  }
+
+  dof_ = joint_names.size();
+  std::vector<size_t> columns;
+  if (!map_joint_columns(msg.joint_names, joint_names, columns, error))
+  {
+    return false;
+  }
+
+  has_velocities_ = !points.front().velocities.empty();
+  has_accelerations_ = !points.front().accelerations.empty();
+
+  const size_t n = points.size();
+  times_.resize(n);
+  positions_.resize(n * dof_);
+  velocities_.assign(n * dof_, 0.0);
+  accelerations_.assign(has_accelerations_ ? n * dof_ : 0, 0.0);
+
+  for (size_t k = 0; k < n; k++)
+  {
+    const auto & point = points[k];
+    if (
+      point.positions.size() != dof_ ||
+      (has_velocities_ && point.velocities.size() != dof_) ||
+      (has_accelerations_ && point.accelerations.size() != dof_))
+    {
+      error = "point " + std::to_string(k) + " does not have a value for each of the " +
+              std::to_string(dof_) + " joints";
+      return false;
+    }
+
+    times_[k] = to_seconds(point.time_from_start);
+    if (k > 0 && times_[k] <= times_[k - 1])
+    {
+      error = "time_from_start of point " + std::to_string(k) + " is not increasing";
+      return false;
+    }
+
+    const size_t row = k * dof_;
+    for (size_t j = 0; j < dof_; j++)
+    {
+      positions_[row + columns[j]] = point.positions[j];
+    }
+    if (has_velocities_)
+    {
+      for (size_t j = 0; j < dof_; j++)
+      {
+        velocities_[row + columns[j]] = point.velocities[j];
+      }
+    }
+    if (has_accelerations_)
+    {
+      for (size_t j = 0; j < dof_; j++)
+      {
+        accelerations_[row + columns[j]] = point.accelerations[j];
+      }
+    }
+  }
+
+  size_ = n;
+  times_data_ = times_.data();
+  positions_data_ = positions_.data();
+  velocities_data_ = velocities_.data();
+  accelerations_data_ = accelerations_.data();
+  file_.reset();
+
+  degree_ = 0;
+  coefficients_.clear();
+  if (method == InterpolationMethod::SPLINES && has_accelerations_)
+  {
+    compute_quintic_coefficients();
+  }
+  else if (method == InterpolationMethod::SPLINES && has_velocities_)
+  {
+    compute_cubic_coefficients();
+  }
+
+  return true;
+}
+
+bool Trajectory::from_file(
+  std::shared_ptr<const MappedTrajectoryFile> file, const std::vector<std::string> & joint_names,
+  InterpolationMethod method, std::string & error)
+{
+  if (file->joint_names() != joint_names)
+  {
+    error = "the joints of the file are not the controlled joints in the same order";
+    return false;
+  }
+
+  if (method == InterpolationMethod::SPLINES && !file->has_velocities())
+  {
+    error = "spline interpolation needs velocities, the file has positions only";
+    return false;
+  }
+
+  size_ = file->header().num_points;
+  dof_ = joint_names.size();
+  has_velocities_ = file->has_velocities();
+  has_accelerations_ = false;
+
+  // the vectors stay empty, a file without velocities is interpolated linearly from the slopes
+  times_.clear();
+  positions_.clear();
+  velocities_.clear();
+  accelerations_.clear();
+  times_data_ = file->times();
+  positions_data_ = file->positions();
+  velocities_data_ = file->velocities();
+  accelerations_data_ = nullptr;
+  file_ = std::move(file);
+
+  coefficients_.clear();
+  degree_ = method == InterpolationMethod::SPLINES ? 3 : 0;
+  return true;
+}
+
+void Trajectory::compute_cubic_coefficients()
+{
+  degree_ = 3;
+  const size_t segments = size() > 1 ? size() - 1 : 0;
+  coefficients_.resize(segments * (degree_ + 1) * dof_);
+
+  for (size_t k = 0; k < segments; k++)
+  {
+    const double T = times_[k + 1] - times_[k];
+    const double * p_0 = positions(k);
+    const double * p_1 = positions(k + 1);
+    const double * v_0 = velocities(k);
+    const double * v_1 = velocities(k + 1);
+    double * c_0 = coefficients(k, 0);
+    double * c_1 = coefficients(k, 1);
+    double * c_2 = coefficients(k, 2);
+    double * c_3 = coefficients(k, 3);
+    for (size_t i = 0; i < dof_; i++)
+    {
+      c_0[i] = p_0[i];
+      c_1[i] = v_0[i];
+      c_2[i] = (3.0 * (p_1[i] - p_0[i]) - (2.0 * v_0[i] + v_1[i]) * T) / (T * T);
+      c_3[i] = (2.0 * (p_0[i] - p_1[i]) + (v_0[i] + v_1[i]) * T) / (T * T * T);
+    }
+  }
+}
+
+void Trajectory::compute_quintic_coefficients()
+{
+  degree_ = 5;
+  const size_t segments = size() > 1 ? size() - 1 : 0;
+  coefficients_.resize(segments * (degree_ + 1) * dof_);
+
+  for (size_t k = 0; k < segments; k++)
+  {
+    compute_quintic(
+      positions(k), velocities(k), accelerations(k), positions(k + 1), velocities(k + 1),
+      accelerations(k + 1), times_[k + 1] - times_[k], dof_, coefficients(k, 0));
+  }
+}
+
+size_t Trajectory::find_segment(double time, size_t cursor) const
+{
+  constexpr size_t max_linear_steps = 4;
+  const size_t last_segment = size_ - 2;
+
+  cursor = std::min(cursor, last_segment);
+  if (times_data_[cursor] <= time)
+  {
+    for (size_t step = 0; step < max_linear_steps; step++)
+    {
+      if (cursor == last_segment || time < times_data_[cursor + 1])
+      {
+        return cursor;
+      }
+      cursor++;
+    }
+  }
+
+  // first point with time_from_start > time, the segment starts one before it
+  const double * it = std::upper_bound(times_data_, times_data_ + size_, time);
+  size_t index = static_cast<size_t>(std::distance(times_data_, it));
+  index = index > 0 ? index - 1 : 0;
+  return std::min(index, last_segment);
+}
+
+bool Trajectory::sample(
+  double time, size_t & cursor, double * positions, double * velocities,
+  double * accelerations) const
+{
+  // If we reached the end of the trajectory, set the velocities to zero.
+  if (size() < 2 || time >= duration())
+  {
+    std::copy(this->positions(size() - 1), this->positions(size() - 1) + dof_, positions);
+    std::fill(velocities, velocities + dof_, 0.0);
+    std::fill(accelerations, accelerations + dof_, 0.0);
+    return true;
+  }
+
+  cursor = find_segment(time, cursor);
+  const double t_1 = times_data_[cursor];
+  const double dt = times_data_[cursor + 1] - t_1;
+
+  if (degree_ > 0 && coefficients_.empty())
+  {
+    evaluate_cubic_hermite(
+      this->positions(cursor), this->velocities(cursor), this->positions(cursor + 1),
+      this->velocities(cursor + 1), dt, dof_, std::clamp(time - t_1, 0.0, dt), positions,
+      velocities, accelerations);
+    return false;
+  }
+  if (degree_ > 0)
+  {
+    const double tau = std::clamp(time - t_1, 0.0, dt);
+    evaluate_polynomial(
+      coefficients(cursor, 0), degree_, dof_, tau, positions, velocities, accelerations);
+    return false;
+  }
+
+  const double delta = std::clamp((time - t_1) / dt, 0.0, 1.0);
+  const double * p_1 = this->positions(cursor);
+  const double * p_2 = this->positions(cursor + 1);
+  for (size_t i = 0; i < dof_; i++)
+  {
+    positions[i] = delta * p_2[i] + (1.0 - delta) * p_1[i];
+  }
+  std::fill(accelerations, accelerations + dof_, 0.0);
+
+  if (has_velocities_)
+  {
+    const double * v_1 = this->velocities(cursor);
+    const double * v_2 = this->velocities(cursor + 1);
+    for (size_t i = 0; i < dof_; i++)
+    {
+      velocities[i] = delta * v_2[i] + (1.0 - delta) * v_1[i];
+    }
+  }
+  else
+  {
+    // without commanded velocities use the slope of the segment
+    for (size_t i = 0; i < dof_; i++)
+    {
+      velocities[i] = (p_2[i] - p_1[i]) / dt;
+    }
+  }
+
+  return false;
+}
+
+void BlendSegment::resize(size_t dof)
+{
+  dof_ = dof;
+  duration_ = 0.0;
+  coefficients_.assign(6 * dof, 0.0);
+  target_positions_.assign(dof, 0.0);
+  target_velocities_.assign(dof, 0.0);
+  target_accelerations_.assign(dof, 0.0);
+}
+
+void BlendSegment::compute(
+  const double * positions, const double * velocities, const double * accelerations,
+  const Trajectory & target, double duration)
+{
+  size_t cursor = 0;
+  target.sample(
+    duration, cursor, target_positions_.data(), target_velocities_.data(),
+    target_accelerations_.data());
+  duration_ = duration;
+  compute_quintic(
+    positions, velocities, accelerations, target_positions_.data(), target_velocities_.data(),
+    target_accelerations_.data(), duration, dof_, coefficients_.data());
+}
+
+void BlendSegment::sample(
+  double time, double * positions, double * velocities, double * accelerations) const
+{
+  evaluate_polynomial(
+    coefficients_.data(), 5, dof_, std::clamp(time, 0.0, duration_), positions, velocities,
+    accelerations);
+}
+
+}  // namespace ros2_control_demo_example_7
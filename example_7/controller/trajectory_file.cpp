@@ -0,0 +1,290 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ros2_control_demo_example_7/trajectory_file.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace ros2_control_demo_example_7
+{
+namespace
+{
+uint64_t align(uint64_t offset)
+{
+  return (offset + TRAJECTORY_FILE_ALIGNMENT - 1) / TRAJECTORY_FILE_ALIGNMENT *
+         TRAJECTORY_FILE_ALIGNMENT;
+}
+}  // namespace
+
+TrajectoryFileHeader make_trajectory_file_header(
+  const std::vector<std::string> & joint_names, uint64_t num_points, bool has_velocities)
+{
+  TrajectoryFileHeader header{};
+  std::memcpy(header.magic, TRAJECTORY_FILE_MAGIC, sizeof(header.magic));
+  header.version = TRAJECTORY_FILE_VERSION;
+  header.flags = has_velocities ? TrajectoryFileHeader::HAS_VELOCITIES : 0;
+  header.num_points = num_points;
+  header.num_joints = joint_names.size();
+
+  header.names_offset = sizeof(TrajectoryFileHeader);
+  header.names_size = 0;
+  for (const auto & name : joint_names)
+  {
+    header.names_size += name.size() + 1;
+  }
+
+  const uint64_t array_size = num_points * joint_names.size() * sizeof(double);
+  header.times_offset = align(header.names_offset + header.names_size);
+  header.positions_offset = align(header.times_offset + num_points * sizeof(double));
+  header.velocities_offset = has_velocities ? align(header.positions_offset + array_size) : 0;
+  header.file_size = (has_velocities ? header.velocities_offset : header.positions_offset) +
+                     array_size;
+  return header;
+}
+
+TrajectoryFileWriter::~TrajectoryFileWriter()
+{
+  if (fd_ >= 0)
+  {
+    ::close(fd_);
+  }
+}
+
+bool TrajectoryFileWriter::open(
+  const std::string & filename, const std::vector<std::string> & joint_names,
+  uint64_t num_points, bool has_velocities, std::string & error)
+{
+  fd_ = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd_ < 0)
+  {
+    error = "can't create '" + filename + "': " + std::strerror(errno);
+    return false;
+  }
+
+  header_ = make_trajectory_file_header(joint_names, num_points, has_velocities);
+  failed_ = false;
+  std::string names;
+  names.reserve(header_.names_size);
+  for (const auto & name : joint_names)
+  {
+    names.append(name);
+    names.push_back('\0');
+  }
+
+  // size the file up front so that the points can be written in any order
+  if (
+    ::ftruncate(fd_, static_cast<off_t>(header_.file_size)) != 0 ||
+    !write_at(0, &header_, sizeof(header_)) ||
+    !write_at(header_.names_offset, names.data(), names.size()))
+  {
+    error = "can't write '" + filename + "': " + std::strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+bool TrajectoryFileWriter::write_points(
+  uint64_t first, uint64_t count, const double * times, const double * positions,
+  const double * velocities)
+{
+  if (first + count > header_.num_points)
+  {
+    failed_ = true;
+    return false;
+  }
+
+  const uint64_t row = header_.num_joints * sizeof(double);
+  bool ok = write_at(header_.times_offset + first * sizeof(double), times, count * sizeof(double));
+  ok = ok && write_at(header_.positions_offset + first * row, positions, count * row);
+  if (header_.flags & TrajectoryFileHeader::HAS_VELOCITIES)
+  {
+    ok = ok && write_at(header_.velocities_offset + first * row, velocities, count * row);
+  }
+  return ok;
+}
+
+bool TrajectoryFileWriter::close(std::string & error)
+{
+  if (fd_ < 0)
+  {
+    return !failed_;
+  }
+  if (::close(fd_) != 0)
+  {
+    failed_ = true;
+  }
+  fd_ = -1;
+  if (failed_)
+  {
+    error = "writing the trajectory file failed";
+  }
+  return !failed_;
+}
+
+bool TrajectoryFileWriter::write_at(uint64_t offset, const void * data, uint64_t size)
+{
+  // pwrite does not move a shared file position, so concurrent writes don't interfere
+  const char * bytes = static_cast<const char *>(data);
+  while (size > 0)
+  {
+    const ssize_t written = ::pwrite(fd_, bytes, size, static_cast<off_t>(offset));
+    if (written < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (written <= 0)
+    {
+      failed_ = true;
+      return false;
+    }
+    bytes += written;
+    offset += static_cast<uint64_t>(written);
+    size -= static_cast<uint64_t>(written);
+  }
+  return true;
+}
+
+MappedTrajectoryFile::~MappedTrajectoryFile()
+{
+  if (data_ != nullptr)
+  {
+    ::munmap(data_, size_);
+  }
+}
+
+bool MappedTrajectoryFile::open(const std::string & filename, bool populate, std::string & error)
+{
+  const int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    error = "can't open '" + filename + "': " + std::strerror(errno);
+    return false;
+  }
+
+  struct stat status;
+  if (::fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(header_)))
+  {
+    error = "'" + filename + "' is too small to be a trajectory file";
+    ::close(fd);
+    return false;
+  }
+
+  // the mapping keeps the file referenced, the descriptor is not needed anymore
+  size_ = static_cast<size_t>(status.st_size);
+  data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE | (populate ? MAP_POPULATE : 0), fd, 0);
+  ::close(fd);
+  if (data_ == MAP_FAILED)
+  {
+    data_ = nullptr;
+    error = "can't map '" + filename + "': " + std::strerror(errno);
+    return false;
+  }
+
+  std::memcpy(&header_, data_, sizeof(header_));
+  if (!validate(error))
+  {
+    error = "'" + filename + "' " + error;
+    return false;
+  }
+
+  advise(0, size_, MADV_WILLNEED);
+  return true;
+}
+
+bool MappedTrajectoryFile::validate(std::string & error)
+{
+  if (std::memcmp(header_.magic, TRAJECTORY_FILE_MAGIC, sizeof(header_.magic)) != 0)
+  {
+    error = "is not a trajectory file";
+    return false;
+  }
+  if (header_.version != TRAJECTORY_FILE_VERSION)
+  {
+    error = "has unsupported version " + std::to_string(header_.version);
+    return false;
+  }
+
+  // recompute the layout from the dimensions instead of trusting the offsets
+  const uint64_t max_values = size_ / sizeof(double);
+  if (
+    header_.num_points == 0 || header_.num_joints == 0 || header_.num_points > max_values ||
+    header_.num_joints > max_values / header_.num_points || header_.names_offset > size_ ||
+    header_.names_size == 0 || header_.names_size > size_ - header_.names_offset)
+  {
+    error = "has invalid dimensions";
+    return false;
+  }
+
+  const char * names = static_cast<const char *>(data_) + header_.names_offset;
+  const char * names_end = names + header_.names_size;
+  joint_names_.clear();
+  if (names_end[-1] != '\0')
+  {
+    error = "has invalid joint names";
+    return false;
+  }
+  for (const char * name = names; name < names_end; name += joint_names_.back().size() + 1)
+  {
+    joint_names_.emplace_back(name);
+  }
+  if (joint_names_.size() != header_.num_joints)
+  {
+    error = "has " + std::to_string(joint_names_.size()) + " joint names for " +
+            std::to_string(header_.num_joints) + " joints";
+    return false;
+  }
+
+  const auto expected =
+    make_trajectory_file_header(joint_names_, header_.num_points, has_velocities());
+  if (
+    header_.names_offset != expected.names_offset ||
+    header_.times_offset != expected.times_offset ||
+    header_.positions_offset != expected.positions_offset ||
+    header_.velocities_offset != expected.velocities_offset ||
+    header_.file_size != expected.file_size || size_ < expected.file_size)
+  {
+    error = "is truncated or has an invalid layout";
+    return false;
+  }
+
+  const double * t = times();
+  for (uint64_t k = 0; k < header_.num_points; k++)
+  {
+    if (!(t[k] >= 0.0) || (k > 0 && t[k] <= t[k - 1]))
+    {
+      error = "has a time_from_start at point " + std::to_string(k) + " that is not increasing";
+      return false;
+    }
+  }
+  return true;
+}
+
+void MappedTrajectoryFile::advise(uint64_t offset, uint64_t size, int advice) const
+{
+  // madvise works on whole pages
+  const uint64_t page = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+  const uint64_t begin = offset / page * page;
+  ::madvise(static_cast<char *>(data_) + begin, offset + size - begin, advice);
+}
+
+}  // namespace ros2_control_demo_example_7
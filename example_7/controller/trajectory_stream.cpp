@@ -0,0 +1,239 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ros2_control_demo_example_7/trajectory_stream.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace ros2_control_demo_example_7
+{
+void TrajectoryStream::resize(size_t capacity, size_t dof, InterpolationMethod method)
+{
+  std::lock_guard<std::mutex> guard(producer_mutex_);
+  capacity_ = capacity;
+  dof_ = dof;
+  method_ = method;
+  times_.assign(capacity, 0.0);
+  positions_.assign(capacity * dof, 0.0);
+  velocities_.assign(capacity * dof, 0.0);
+  has_velocities_.assign(capacity, 0);
+  columns_.reserve(dof);
+  write_.store(0, std::memory_order_relaxed);
+  read_.store(0, std::memory_order_relaxed);
+  stream_open_ = false;
+  running_ = false;
+  underrun_ = false;
+}
+
+bool TrajectoryStream::push(
+  const trajectory_msgs::msg::JointTrajectory & chunk,
+  const std::vector<std::string> & joint_names, std::string & error)
+{
+  std::lock_guard<std::mutex> guard(producer_mutex_);
+  const size_t write = write_.load(std::memory_order_relaxed);
+  const size_t free = capacity_ - (write - read_.load(std::memory_order_acquire));
+
+  if (chunk.points.empty())
+  {
+    if (!stream_open_)
+    {
+      return true;
+    }
+    if (free == 0)
+    {
+      error = "stream buffer is full, can't end the stream";
+      return false;
+    }
+    times_[slot(write)] = std::numeric_limits<double>::quiet_NaN();
+    write_.store(write + 1, std::memory_order_release);
+    stream_open_ = false;
+    return true;
+  }
+
+  if (!map_joint_columns(chunk.joint_names, joint_names, columns_, error))
+  {
+    return false;
+  }
+  const size_t n = chunk.points.size();
+  if (n > free)
+  {
+    error = "chunk of " + std::to_string(n) + " points does not fit into the " +
+            std::to_string(free) + " free points of the stream buffer";
+    return false;
+  }
+
+  // the slots behind write_ are not visible to the consumer until the chunk is complete
+  double last_time = stream_open_ ? last_time_ : -std::numeric_limits<double>::infinity();
+  for (size_t k = 0; k < n; k++)
+  {
+    const auto & point = chunk.points[k];
+    const bool has_velocities = !point.velocities.empty();
+    if (point.positions.size() != dof_ || (has_velocities && point.velocities.size() != dof_))
+    {
+      error = "point " + std::to_string(k) + " does not have a value for each of the " +
+              std::to_string(dof_) + " joints";
+      return false;
+    }
+
+    const double time = to_seconds(point.time_from_start);
+    if (time <= last_time)
+    {
+      error = "time_from_start of point " + std::to_string(k) + " does not continue the stream";
+      return false;
+    }
+    last_time = time;
+
+    const size_t s = slot(write + k);
+    times_[s] = time;
+    has_velocities_[s] = has_velocities;
+    double * positions = &positions_[s * dof_];
+    double * velocities = &velocities_[s * dof_];
+    for (size_t j = 0; j < dof_; j++)
+    {
+      positions[columns_[j]] = point.positions[j];
+      velocities[columns_[j]] = has_velocities ? point.velocities[j] : 0.0;
+    }
+  }
+
+  write_.store(write + n, std::memory_order_release);
+  last_time_ = last_time;
+  stream_open_ = true;
+  return true;
+}
+
+StreamState TrajectoryStream::sample(
+  double period, double * positions, double * velocities, double * accelerations)
+{
+  size_t read = read_.load(std::memory_order_relaxed);
+  const size_t write = write_.load(std::memory_order_acquire);
+
+  if (!running_)
+  {
+    // skip the end of streams without points
+    while (read != write && is_end_marker(read))
+    {
+      read++;
+    }
+    read_.store(read, std::memory_order_release);
+    if (read == write)
+    {
+      return StreamState::IDLE;
+    }
+    running_ = true;
+    underrun_ = false;
+    stream_time_ = 0.0;
+  }
+  else
+  {
+    stream_time_ += period;
+  }
+
+  // release the points of passed segments, the first point of the current segment is kept
+  while (write - read >= 2 && !is_end_marker(read + 1) && times_[slot(read + 1)] <= stream_time_)
+  {
+    read++;
+  }
+  read_.store(read, std::memory_order_release);
+
+  if (write - read >= 2 && !is_end_marker(read + 1))
+  {
+    interpolate(read, positions, velocities, accelerations);
+    underrun_ = false;
+    return StreamState::RUNNING;
+  }
+
+  // only the point at read is left, hold it
+  hold(read, positions, velocities, accelerations);
+  const double time = times_[slot(read)];
+  if (stream_time_ < time)
+  {
+    // the stream starts with a point after time 0
+    return StreamState::RUNNING;
+  }
+  if (write - read >= 2)
+  {
+    // the next slot is the end marker
+    read_.store(read + 2, std::memory_order_release);
+    running_ = false;
+    return StreamState::FINISHED;
+  }
+
+  // pause the stream clock until the next point arrives
+  stream_time_ = time;
+  if (!underrun_)
+  {
+    underrun_ = true;
+    underruns_++;
+  }
+  return StreamState::UNDERRUN;
+}
+
+void TrajectoryStream::clear()
+{
+  std::lock_guard<std::mutex> guard(producer_mutex_);
+  read_.store(write_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  stream_open_ = false;
+  running_ = false;
+  underrun_ = false;
+}
+
+bool TrajectoryStream::is_end_marker(size_t index) const
+{
+  return std::isnan(times_[slot(index)]);
+}
+
+void TrajectoryStream::interpolate(
+  size_t index, double * positions, double * velocities, double * accelerations) const
+{
+  const size_t s_0 = slot(index);
+  const size_t s_1 = slot(index + 1);
+  const double dt = times_[s_1] - times_[s_0];
+  const double tau = std::clamp(stream_time_ - times_[s_0], 0.0, dt);
+  const double * p_0 = &positions_[s_0 * dof_];
+  const double * p_1 = &positions_[s_1 * dof_];
+  const double * v_0 = &velocities_[s_0 * dof_];
+  const double * v_1 = &velocities_[s_1 * dof_];
+  const bool has_velocities = has_velocities_[s_0] && has_velocities_[s_1];
+
+  if (method_ == InterpolationMethod::SPLINES && has_velocities)
+  {
+    // the ring has no room for precomputed coefficients
+    evaluate_cubic_hermite(p_0, v_0, p_1, v_1, dt, dof_, tau, positions, velocities, accelerations);
+    return;
+  }
+
+  const double delta = tau / dt;
+  for (size_t i = 0; i < dof_; i++)
+  {
+    positions[i] = delta * p_1[i] + (1.0 - delta) * p_0[i];
+    // without commanded velocities use the slope of the segment
+    velocities[i] =
+      has_velocities ? delta * v_1[i] + (1.0 - delta) * v_0[i] : (p_1[i] - p_0[i]) / dt;
+    accelerations[i] = 0.0;
+  }
+}
+
+void TrajectoryStream::hold(
+  size_t index, double * positions, double * velocities, double * accelerations) const
+{
+  const double * p = &positions_[slot(index) * dof_];
+  std::copy(p, p + dof_, positions);
+  std::fill(velocities, velocities + dof_, 0.0);
+  std::fill(accelerations, accelerations + dof_, 0.0);
+}
+
+}  // namespace ros2_control_demo_example_7
@@ -24,6 +24,7 @@
 #include "hardware_interface/system_interface.hpp"
 #include "hardware_interface/types/hardware_interface_return_values.hpp"
 #include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "ros2_control_demo_utils/interface_handles.hpp"
 
 using hardware_interface::return_type;
 
@@ -44,6 +45,10 @@ public:
   return_type write(const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/) override;
 
 protected:
+  // joint interfaces looked up in on_configure(), in the order of the joints
+  std::vector<ros2_control_demo_utils::StateHandle> position_states_;
+  std::vector<ros2_control_demo_utils::StateHandle> velocity_states_;
+  std::vector<ros2_control_demo_utils::CommandHandle> velocity_commands_;
 };
 
 }  // namespace ros2_control_demo_example_7
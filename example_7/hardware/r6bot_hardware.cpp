@@ -16,6 +16,8 @@
 #include <string>
 #include <vector>
 
+#include "rclcpp/rclcpp.hpp"
+
 namespace ros2_control_demo_example_7
 {
 CallbackReturn RobotSystem::on_init(
@@ -44,6 +46,28 @@ CallbackReturn RobotSystem::on_configure(const rclcpp_lifecycle::State & /*previ
     set_state(name, 0.0);
   }
 
+  // read() accesses the joints through handles instead of by name
+  ros2_control_demo_utils::HandleResolver resolver;
+  resolver.add_states(joint_states_);
+  resolver.add_commands(joint_commands_);
+  position_states_.resize(info_.joints.size());
+  velocity_states_.resize(info_.joints.size());
+  velocity_commands_.resize(info_.joints.size());
+  for (std::size_t i = 0; i < info_.joints.size(); i++)
+  {
+    const auto & joint = info_.joints[i].name;
+    const auto name_pos = joint + "/" + hardware_interface::HW_IF_POSITION;
+    const auto name_vel = joint + "/" + hardware_interface::HW_IF_VELOCITY;
+    if (
+      !resolver.resolve_state(name_pos, position_states_[i]) ||
+      !resolver.resolve_state(name_vel, velocity_states_[i]) ||
+      !resolver.resolve_command(name_vel, velocity_commands_[i]))
+    {
+      RCLCPP_FATAL(get_logger(), "Failed to look up the interfaces of joint '%s'.", joint.c_str());
+      return CallbackReturn::ERROR;
+    }
+  }
+
   return CallbackReturn::SUCCESS;
 }
 
@@ -51,12 +75,11 @@ return_type RobotSystem::read(const rclcpp::Time & /*time*/, const rclcpp::Durat
 {
   // TODO(pac48) set sensor_states_ values from subscriber
 
-  for (std::size_t i = 0; i < info_.joints.size(); i++)
+  for (std::size_t i = 0; i < position_states_.size(); i++)
   {
-    const auto name_vel = info_.joints[i].name + "/" + hardware_interface::HW_IF_VELOCITY;
-    const auto name_pos = info_.joints[i].name + "/" + hardware_interface::HW_IF_POSITION;
-    set_state(name_vel, get_command(name_vel));
-    set_state(name_pos, get_state(name_pos) + get_state(name_vel) * period.seconds());
+    const double velocity = velocity_commands_[i].get();
+    velocity_states_[i].set(velocity);
+    position_states_[i].set(position_states_[i].get() + velocity * period.seconds());
   }
   return return_type::OK;
 }
@@ -0,0 +1,82 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include <kdl/chainfksolverpos_recursive.hpp>
+#include <kdl/tree.hpp>
+#include <kdl_parser/kdl_parser.hpp>
+
+#include "ros2_control_demo_example_7/trajectory_generator.hpp"
+
+using ros2_control_demo_example_7::EllipsePath;
+using ros2_control_demo_example_7::GeneratorOptions;
+using ros2_control_demo_example_7::TrajectoryGenerator;
+
+// Reports the throughput of TrajectoryGenerator on the ellipse of send_trajectory, traced as often
+// as needed for 10^5 to 10^7 samples. The points are discarded, so only the IK is measured.
+int main(int argc, char ** argv)
+{
+  if (argc < 2 || argc > 3)
+  {
+    std::fprintf(stderr, "usage: %s <robot.urdf> [max_samples]\n", argv[0]);
+    return 2;
+  }
+  const size_t max_samples = argc > 2 ? std::stoul(argv[2]) : 10000000;
+
+  KDL::Tree robot_tree;
+  KDL::Chain chain;
+  if (
+    !kdl_parser::treeFromFile(argv[1], robot_tree) ||
+    !robot_tree.getChain("base_link", "tool0", chain))
+  {
+    std::fprintf(stderr, "Can't read the chain from base_link to tool0 from '%s'.\n", argv[1]);
+    return 1;
+  }
+
+  KDL::JntArray seed(chain.getNrOfJoints());
+  KDL::Frame start;
+  KDL::ChainFkSolverPos_recursive(chain).JntToCart(seed, start);
+
+  auto discard = [](size_t, size_t, const double *, const double *, const double *) {};
+
+  std::printf("%10s %8s %12s %14s %8s\n", "samples", "threads", "time [s]", "points/s", "failed");
+  for (size_t threads : {size_t(1), size_t(0)})
+  {
+    GeneratorOptions options;
+    options.threads = threads;
+    TrajectoryGenerator generator(chain, options);
+
+    for (size_t samples = 100000; samples <= max_samples; samples *= 10)
+    {
+      // a single thread takes minutes for 10^7 samples, the trend is clear before that
+      if (generator.threads() == 1 && samples > 1000000)
+      {
+        break;
+      }
+
+      EllipsePath path(start, samples);
+      const auto begin = std::chrono::steady_clock::now();
+      const auto result = generator.generate(path, seed, discard);
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+      std::printf(
+        "%10zu %8zu %12.3f %14.0f %8zu\n", samples, generator.threads(), elapsed.count(),
+        static_cast<double>(result.points) / elapsed.count(), result.failed_points);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,132 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <kdl/tree.hpp>
+#include <kdl_parser/kdl_parser.hpp>
+
+#include "ros2_control_demo_example_7/trajectory_file.hpp"
+#include "ros2_control_demo_example_7/trajectory_generator.hpp"
+
+using ros2_control_demo_example_7::GeneratorOptions;
+using ros2_control_demo_example_7::PoseListPath;
+using ros2_control_demo_example_7::TrajectoryFileWriter;
+using ros2_control_demo_example_7::TrajectoryGenerator;
+
+namespace
+{
+void print_usage(const char * program)
+{
+  std::fprintf(
+    stderr,
+    "usage: %s <robot.urdf> <path.txt> <output.traj> [threads] [chunk_size]\n\n"
+    "Solves the IK of the Cartesian path in path.txt, one 'time x y z qx qy qz qw' sample per\n"
+    "line, for the chain from base_link to tool0 and writes a binary trajectory file.\n",
+    program);
+}
+
+/// Parses a positive decimal number, \return false for anything else, e.g. "0", "-1" or "4x"
+bool parse_count(const char * text, size_t & value)
+{
+  if (!std::isdigit(static_cast<unsigned char>(text[0])))
+  {
+    return false;
+  }
+  char * end = nullptr;
+  errno = 0;
+  const unsigned long long parsed = std::strtoull(text, &end, 10);
+  if (
+    *end != '\0' || errno == ERANGE || parsed == 0 ||
+    parsed > std::numeric_limits<size_t>::max())
+  {
+    return false;
+  }
+  value = static_cast<size_t>(parsed);
+  return true;
+}
+}  // namespace
+
+int main(int argc, char ** argv)
+{
+  GeneratorOptions options;
+  if (
+    argc < 4 || argc > 6 || (argc > 4 && !parse_count(argv[4], options.threads)) ||
+    (argc > 5 && !parse_count(argv[5], options.chunk_size)))
+  {
+    print_usage(argv[0]);
+    return 2;
+  }
+
+  // create kinematic chain
+  KDL::Tree robot_tree;
+  KDL::Chain chain;
+  if (
+    !kdl_parser::treeFromFile(argv[1], robot_tree) ||
+    !robot_tree.getChain("base_link", "tool0", chain))
+  {
+    std::fprintf(stderr, "Can't read the chain from base_link to tool0 from '%s'.\n", argv[1]);
+    return 1;
+  }
+
+  PoseListPath path;
+  std::string error;
+  if (!path.load(argv[2], error))
+  {
+    std::fprintf(stderr, "Can't load the path: %s\n", error.c_str());
+    return 1;
+  }
+
+  TrajectoryFileWriter writer;
+  if (!writer.open(
+        argv[3], ros2_control_demo_example_7::get_joint_names(chain), path.size(), true, error))
+  {
+    std::fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+
+  // the workers write their chunks straight into the file
+  auto sink = [&writer](
+                size_t first, size_t count, const double * times, const double * positions,
+                const double * velocities)
+  { writer.write_points(first, count, times, positions, velocities); };
+
+  TrajectoryGenerator generator(chain, options);
+  const auto start = std::chrono::steady_clock::now();
+  const auto result = generator.generate(path, KDL::JntArray(chain.getNrOfJoints()), sink);
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  if (!writer.close(error))
+  {
+    std::fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+
+  std::printf(
+    "Wrote %zu points in %.3f s with %zu threads (%.0f points/s).\n", result.points,
+    elapsed.count(), generator.threads(), static_cast<double>(result.points) / elapsed.count());
+  if (result.failed_points > 0)
+  {
+    std::fprintf(stderr, "IK did not converge for %zu points.\n", result.failed_points);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,144 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS2_CONTROL_DEMO_EXAMPLE_7__TRAJECTORY_GENERATOR_HPP_
+#define ROS2_CONTROL_DEMO_EXAMPLE_7__TRAJECTORY_GENERATOR_HPP_
+
+#include <stddef.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <kdl/chain.hpp>
+#include <kdl/frames.hpp>
+#include <kdl/jntarray.hpp>
+
+namespace ros2_control_demo_example_7
+{
+/// Cartesian path of the tool, sampled at increasing times. Read from several threads at once.
+class CartesianPath
+{
+public:
+  virtual ~CartesianPath() = default;
+
+  virtual size_t size() const = 0;
+  virtual double time(size_t sample) const = 0;
+  virtual KDL::Frame pose(size_t sample) const = 0;
+};
+
+/**
+ * Path loaded from a text file.
+ *
+ * Every line holds one sample as "time x y z qx qy qz qw": the time in seconds, the position of
+ * the tool in meters and its orientation as quaternion. Empty lines and lines starting with '#'
+ * are skipped, a file without any sample is rejected.
+ */
+class PoseListPath : public CartesianPath
+{
+public:
+  bool load(const std::string & filename, std::string & error);
+
+  size_t size() const override { return times_.size(); }
+  double time(size_t sample) const override { return times_[sample]; }
+  KDL::Frame pose(size_t sample) const override { return poses_[sample]; }
+
+private:
+  std::vector<double> times_;
+  std::vector<KDL::Frame> poses_;
+};
+
+/**
+ * The ellipse traced by send_trajectory, starting at \p start and repeated as often as needed to
+ * fill \p samples samples. Computed on the fly, so arbitrarily long paths take no memory.
+ */
+class EllipsePath : public CartesianPath
+{
+public:
+  EllipsePath(
+    const KDL::Frame & start, size_t samples, size_t samples_per_loop = 200,
+    double loop_duration = 3.0);
+
+  size_t size() const override { return samples_; }
+  double time(size_t sample) const override;
+  KDL::Frame pose(size_t sample) const override;
+
+private:
+  KDL::Frame start_;
+  size_t samples_;
+  double dt_;
+  double loop_duration_;
+};
+
+struct GeneratorOptions
+{
+  /// number of worker threads, 0 uses one per hardware thread
+  size_t threads = 0;
+  /// number of consecutive samples solved by one worker, each warm started from its predecessor
+  size_t chunk_size = 256;
+  /// tolerance and iteration limit of the position IK
+  double eps = 1E-5;
+  int max_iterations = 500;
+};
+
+struct GeneratorResult
+{
+  size_t points = 0;
+  /// samples for which the position IK did not converge, their best estimate is used
+  size_t failed_points = 0;
+};
+
+/**
+ * Receives the solved points [first, first + count): their times and positions and velocities
+ * of all joints, point by point. Called concurrently from the workers for disjoint ranges, in no
+ * particular order.
+ */
+using PointSink = std::function<void(
+  size_t first, size_t count, const double * times, const double * positions,
+  const double * velocities)>;
+
+/**
+ * Converts Cartesian paths into joint trajectories with a pool of worker threads.
+ *
+ * The path is cut into chunks of consecutive samples. The first sample of every chunk is solved
+ * serially, each from the solution of the previous chunk start, which keeps all chunks on the same
+ * IK branch. The chunks are then solved in parallel, every sample warm started from the solution
+ * of its predecessor, so the position IK typically converges in a few iterations. Joint
+ * velocities are the IK solution of the twist to the next sample.
+ *
+ * KDL solvers keep internal state, so every worker creates its own instances.
+ */
+class TrajectoryGenerator
+{
+public:
+  TrajectoryGenerator(const KDL::Chain & chain, const GeneratorOptions & options);
+
+  size_t dof() const { return chain_.getNrOfJoints(); }
+  size_t threads() const { return threads_; }
+
+  /// Solves \p path starting from the joint positions \p seed and passes the points to \p sink.
+  GeneratorResult generate(
+    const CartesianPath & path, const KDL::JntArray & seed, const PointSink & sink) const;
+
+private:
+  KDL::Chain chain_;
+  GeneratorOptions options_;
+  size_t threads_;
+};
+
+/// Names of the movable joints of \p chain, in the order of the joint arrays.
+std::vector<std::string> get_joint_names(const KDL::Chain & chain);
+
+}  // namespace ros2_control_demo_example_7
+
+#endif  // ROS2_CONTROL_DEMO_EXAMPLE_7__TRAJECTORY_GENERATOR_HPP_
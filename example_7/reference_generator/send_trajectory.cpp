@@ -13,7 +13,10 @@
 // limitations under the License.
 
 #define _USE_MATH_DEFINES
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <thread>
 
 #include <kdl/chainfksolverpos_recursive.hpp>
 #include <kdl/chainiksolvervel_pinv.hpp>
@@ -68,10 +71,20 @@ int main(int argc, char ** argv)
   int trajectory_len = 200;
   double dt = total_time / static_cast<double>(trajectory_len - 1);
 
-  for (int i = 0; i < trajectory_len; i++)
+  // the ellipse is traced repetitions times; with stream_chunk_size > 0 the points are generated
+  // and sent in chunks of that size, so long paths never have to be held in memory at once
+  node->declare_parameter("repetitions", 1);
+  node->declare_parameter("stream_chunk_size", 0);
+  node->declare_parameter("stream_lead_time", 1.0);
+  const auto repetitions = std::max<int64_t>(node->get_parameter("repetitions").as_int(), 1);
+  const auto stream_chunk_size = node->get_parameter("stream_chunk_size").as_int();
+  const double stream_lead_time = node->get_parameter("stream_lead_time").as_double();
+  const int64_t num_points = repetitions * (trajectory_len - 1) + 1;
+
+  auto compute_point = [&](int64_t i)
   {
     // set endpoint twist
-    double t = i / (static_cast<double>(trajectory_len - 1));
+    double t = static_cast<double>(i) / (static_cast<double>(trajectory_len - 1));
     twist.vel.x(2 * 0.3 * cos(2 * M_PI * t));
     twist.vel.y(-0.3 * sin(2 * M_PI * t));
 
@@ -95,31 +108,92 @@ int main(int argc, char ** argv)
     trajectory_point_msg.time_from_start.sec = static_cast<int>(time_point_sec);
     trajectory_point_msg.time_from_start.nanosec =
       static_cast<uint32_t>((time_point - time_point_sec) * 1E9);
-    trajectory_msg.points.push_back(trajectory_point_msg);
-  }
 
-  // send zero velocities in the end
-  auto & last_point_msg = trajectory_msg.points.back();
-  std::fill(last_point_msg.velocities.begin(), last_point_msg.velocities.end(), 0.0);
+    // send zero velocities in the end
+    if (i == num_points - 1)
+    {
+      auto & velocities = trajectory_point_msg.velocities;
+      std::fill(velocities.begin(), velocities.end(), 0.0);
+    }
+    return time_point;
+  };
+
+  auto wait_for_subscribers = [&node](const auto & publisher)
+  {
+    auto started = node->now();
+    while (publisher->get_subscription_count() == 0)
+    {
+      if (node->now() - started > rclcpp::Duration(10, 0))
+      {
+        RCLCPP_ERROR(
+          node->get_logger(), "No subscribers connected after waiting for 10 seconds. Exiting.");
+        return false;
+      }
+      RCLCPP_INFO(
+        node->get_logger(), "Waiting for subscribers to connect to topic %s",
+        publisher->get_topic_name());
+      rclcpp::sleep_for(std::chrono::milliseconds(500));
+    }
+    return true;
+  };
 
-  auto started = node->now();
-  while (pub->get_subscription_count() == 0)
+  if (stream_chunk_size <= 0)
   {
-    if (node->now() - started > rclcpp::Duration(10, 0))
+    for (int64_t i = 0; i < num_points; i++)
+    {
+      compute_point(i);
+      trajectory_msg.points.push_back(trajectory_point_msg);
+    }
+
+    if (!wait_for_subscribers(pub))
     {
-      RCLCPP_ERROR(
-        node->get_logger(), "No subscribers connected after waiting for 10 seconds. Exiting.");
       return 1;
     }
+
     RCLCPP_INFO(
-      node->get_logger(), "Waiting for subscribers to connect to topic %s", pub->get_topic_name());
-    rclcpp::sleep_for(std::chrono::milliseconds(500));
+      node->get_logger(), "Publishing trajectory with length %ld", trajectory_msg.points.size());
+
+    pub->publish(trajectory_msg);
   }
+  else
+  {
+    auto stream_pub = node->create_publisher<trajectory_msgs::msg::JointTrajectory>(
+      "/r6bot_controller/joint_trajectory_stream", 10);
+    if (!wait_for_subscribers(stream_pub))
+    {
+      return 1;
+    }
 
-  RCLCPP_INFO(
-    node->get_logger(), "Publishing trajectory with length %ld", trajectory_msg.points.size());
+    RCLCPP_INFO(
+      node->get_logger(), "Streaming trajectory with length %ld in chunks of %ld points",
+      num_points, stream_chunk_size);
+
+    // keep the controller at most stream_lead_time ahead of the points it executes, it starts
+    // executing when the first chunk arrives
+    const auto started = std::chrono::steady_clock::now();
+    trajectory_msg.points.reserve(static_cast<size_t>(stream_chunk_size));
+    for (int64_t i = 0; i < num_points;)
+    {
+      trajectory_msg.points.clear();
+      double chunk_start_time = 0.0;
+      for (int64_t k = 0; k < stream_chunk_size && i < num_points; k++, i++)
+      {
+        const double time_point = compute_point(i);
+        chunk_start_time = k == 0 ? time_point : chunk_start_time;
+        trajectory_msg.points.push_back(trajectory_point_msg);
+      }
+
+      std::this_thread::sleep_until(
+        started + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(chunk_start_time - stream_lead_time)));
+      stream_pub->publish(trajectory_msg);
+    }
 
-  pub->publish(trajectory_msg);
+    // a chunk without points ends the stream
+    trajectory_msg.points.clear();
+    stream_pub->publish(trajectory_msg);
+    RCLCPP_INFO(node->get_logger(), "Trajectory stream sent.");
+  }
 
   rclcpp::spin(node);
   rclcpp::shutdown();
@@ -0,0 +1,207 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#define _USE_MATH_DEFINES
+#include "ros2_control_demo_example_7/trajectory_generator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <kdl/chainiksolverpos_lma.hpp>
+#include <kdl/chainiksolvervel_pinv.hpp>
+
+namespace ros2_control_demo_example_7
+{
+bool PoseListPath::load(const std::string & filename, std::string & error)
+{
+  std::ifstream file(filename);
+  if (!file)
+  {
+    error = "can't open '" + filename + "'";
+    return false;
+  }
+
+  times_.clear();
+  poses_.clear();
+  std::string line;
+  size_t line_number = 0;
+  while (std::getline(file, line))
+  {
+    line_number++;
+    if (line.empty() || line[0] == '#')
+    {
+      continue;
+    }
+    std::istringstream values(line);
+    double t, x, y, z, qx, qy, qz, qw;
+    if (!(values >> t >> x >> y >> z >> qx >> qy >> qz >> qw))
+    {
+      error = "line " + std::to_string(line_number) + " is not 'time x y z qx qy qz qw'";
+      return false;
+    }
+    if (!times_.empty() && t <= times_.back())
+    {
+      error = "time of line " + std::to_string(line_number) + " is not increasing";
+      return false;
+    }
+    times_.push_back(t);
+    poses_.emplace_back(KDL::Rotation::Quaternion(qx, qy, qz, qw), KDL::Vector(x, y, z));
+  }
+  if (times_.empty())
+  {
+    error = "'" + filename + "' contains no samples";
+    return false;
+  }
+  return true;
+}
+
+EllipsePath::EllipsePath(
+  const KDL::Frame & start, size_t samples, size_t samples_per_loop, double loop_duration)
+: start_(start),
+  samples_(samples),
+  dt_(loop_duration / static_cast<double>(samples_per_loop - 1)),
+  loop_duration_(loop_duration)
+{
+}
+
+double EllipsePath::time(size_t sample) const { return static_cast<double>(sample) * dt_; }
+
+KDL::Frame EllipsePath::pose(size_t sample) const
+{
+  // integral of the tool velocity commanded by send_trajectory
+  const double phase = 2 * M_PI * time(sample) / loop_duration_;
+  const double scale = loop_duration_ / (2 * M_PI);
+  KDL::Frame pose = start_;
+  pose.p += KDL::Vector(2 * 0.3 * scale * sin(phase), 0.3 * scale * (cos(phase) - 1.0), 0.0);
+  return pose;
+}
+
+TrajectoryGenerator::TrajectoryGenerator(
+  const KDL::Chain & chain, const GeneratorOptions & options)
+: chain_(chain), options_(options)
+{
+  threads_ = options_.threads > 0 ? options_.threads : std::thread::hardware_concurrency();
+  threads_ = std::max<size_t>(threads_, 1);
+  options_.chunk_size = std::max<size_t>(options_.chunk_size, 1);
+}
+
+GeneratorResult TrajectoryGenerator::generate(
+  const CartesianPath & path, const KDL::JntArray & seed, const PointSink & sink) const
+{
+  const size_t n = path.size();
+  const size_t dof = chain_.getNrOfJoints();
+  const size_t chunk_size = options_.chunk_size;
+  const size_t chunks = (n + chunk_size - 1) / chunk_size;
+  std::atomic<size_t> failed_points{0};
+
+  // warm starts of the chunks, solved serially so that all chunks stay on the branch of the seed
+  std::vector<KDL::JntArray> chunk_starts(chunks, KDL::JntArray(static_cast<unsigned int>(dof)));
+  {
+    KDL::ChainIkSolverPos_LMA ik_pos(chain_, options_.eps, options_.max_iterations);
+    KDL::JntArray q = seed;
+    for (size_t c = 0; c < chunks; c++)
+    {
+      if (ik_pos.CartToJnt(q, path.pose(c * chunk_size), chunk_starts[c]) < 0)
+      {
+        failed_points++;
+      }
+      q = chunk_starts[c];
+    }
+  }
+
+  std::atomic<size_t> next_chunk{0};
+  auto work = [&]()
+  {
+    KDL::ChainIkSolverPos_LMA ik_pos(chain_, options_.eps, options_.max_iterations);
+    KDL::ChainIkSolverVel_pinv ik_vel(chain_);
+    KDL::JntArray q(static_cast<unsigned int>(dof));
+    KDL::JntArray q_init(static_cast<unsigned int>(dof));
+    KDL::JntArray q_dot(static_cast<unsigned int>(dof));
+    std::vector<double> times(chunk_size);
+    std::vector<double> positions(chunk_size * dof);
+    std::vector<double> velocities(chunk_size * dof);
+
+    for (size_t c = next_chunk++; c < chunks; c = next_chunk++)
+    {
+      const size_t first = c * chunk_size;
+      const size_t count = std::min(chunk_size, n - first);
+      KDL::Frame pose = path.pose(first);
+      for (size_t k = 0; k < count; k++)
+      {
+        const size_t sample = first + k;
+        if (k == 0)
+        {
+          q = chunk_starts[c];
+        }
+        else if (ik_pos.CartToJnt(q_init, pose, q) < 0)
+        {
+          failed_points++;
+        }
+        q_init = q;
+
+        // stop at the last sample, otherwise move towards the next one
+        times[k] = path.time(sample);
+        if (sample + 1 < n)
+        {
+          const KDL::Frame next_pose = path.pose(sample + 1);
+          ik_vel.CartToJnt(q, KDL::diff(pose, next_pose, path.time(sample + 1) - times[k]), q_dot);
+          pose = next_pose;
+        }
+        else
+        {
+          q_dot.data.setZero();
+        }
+
+        std::copy(q.data.data(), q.data.data() + dof, &positions[k * dof]);
+        std::copy(q_dot.data.data(), q_dot.data.data() + dof, &velocities[k * dof]);
+      }
+      sink(first, count, times.data(), positions.data(), velocities.data());
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < std::min(threads_, chunks); i++)
+  {
+    workers.emplace_back(work);
+  }
+  work();
+  for (auto & worker : workers)
+  {
+    worker.join();
+  }
+
+  return {n, failed_points.load()};
+}
+
+std::vector<std::string> get_joint_names(const KDL::Chain & chain)
+{
+  std::vector<std::string> joint_names;
+  for (unsigned int i = 0; i < chain.getNrOfSegments(); i++)
+  {
+    auto joint = chain.getSegment(i).getJoint();
+    if (joint.getType() != KDL::Joint::Fixed)
+    {
+      joint_names.push_back(joint.getName());
+    }
+  }
+  return joint_names;
+}
+
+}  // namespace ros2_control_demo_example_7
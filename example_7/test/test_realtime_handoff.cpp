@@ -0,0 +1,206 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ros2_control_demo_example_7/realtime_handoff.hpp"
+#include "ros2_control_demo_example_7/trajectory.hpp"
+
+using ros2_control_demo_example_7::InterpolationMethod;
+using ros2_control_demo_example_7::RealtimeHandoff;
+using ros2_control_demo_example_7::Trajectory;
+
+namespace
+{
+/// heap operations counted by the replaced global operators while counting is enabled
+std::atomic<bool> count_heap_operations{false};
+std::atomic<size_t> heap_operations{0};
+
+struct Counted
+{
+  explicit Counted(int & alive) : alive_(alive) { alive_++; }
+  ~Counted() { alive_--; }
+  int & alive_;
+};
+
+std::unique_ptr<Trajectory> make_trajectory(size_t points, size_t dof)
+{
+  trajectory_msgs::msg::JointTrajectory msg;
+  for (size_t i = 0; i < dof; i++)
+  {
+    msg.joint_names.push_back("joint_" + std::to_string(i + 1));
+  }
+  msg.points.resize(points);
+  for (size_t k = 0; k < points; k++)
+  {
+    auto & point = msg.points[k];
+    point.positions.assign(dof, 0.001 * static_cast<double>(k));
+    point.velocities.assign(dof, 1.0);
+    point.time_from_start.sec = static_cast<int32_t>(k / 1000);
+    point.time_from_start.nanosec = static_cast<uint32_t>((k % 1000) * 1000000);
+  }
+
+  auto trajectory = std::make_unique<Trajectory>();
+  std::string error;
+  EXPECT_TRUE(trajectory->from_msg(msg, msg.joint_names, InterpolationMethod::SPLINES, error))
+    << error;
+  return trajectory;
+}
+
+}  // namespace
+
+void * operator new(std::size_t size)
+{
+  if (count_heap_operations)
+  {
+    heap_operations++;
+  }
+  if (void * memory = std::malloc(size == 0 ? 1 : size))
+  {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void * memory) noexcept
+{
+  if (memory != nullptr && count_heap_operations)
+  {
+    heap_operations++;
+  }
+  std::free(memory);
+}
+
+void operator delete(void * memory, std::size_t) noexcept { operator delete(memory); }
+
+TEST(TestRealtimeHandoff, take_returns_latest_published)
+{
+  int alive = 0;
+  {
+    RealtimeHandoff<Counted> handoff;
+    EXPECT_EQ(handoff.try_take(), nullptr);
+
+    handoff.publish(std::make_unique<Counted>(alive));
+    handoff.publish(std::make_unique<Counted>(alive));
+    // the first one was never taken, the second publish returns it and it is dropped here
+    EXPECT_EQ(alive, 1);
+
+    Counted * taken = handoff.try_take();
+    ASSERT_NE(taken, nullptr);
+    EXPECT_EQ(handoff.try_take(), nullptr);
+
+    EXPECT_TRUE(handoff.retire(taken));
+    EXPECT_EQ(alive, 1);
+    handoff.reclaim();
+    EXPECT_EQ(alive, 0);
+
+    handoff.publish(std::make_unique<Counted>(alive));
+  }
+  // the pending object is deleted with the handoff
+  EXPECT_EQ(alive, 0);
+}
+
+TEST(TestRealtimeHandoff, take_waits_for_free_retire_slot)
+{
+  int alive = 0;
+  RealtimeHandoff<Counted, 1> handoff;
+
+  handoff.publish(std::make_unique<Counted>(alive));
+  Counted * first = handoff.try_take();
+  ASSERT_NE(first, nullptr);
+  handoff.publish(std::make_unique<Counted>(alive));
+  ASSERT_TRUE(handoff.retire(first));
+
+  // the only retire slot is occupied until the producer reclaims it
+  Counted other(alive);
+  EXPECT_FALSE(handoff.retire(&other));
+  EXPECT_EQ(handoff.try_take(), nullptr);
+
+  handoff.reclaim();
+  Counted * second = handoff.try_take();
+  ASSERT_NE(second, nullptr);
+  EXPECT_TRUE(handoff.retire(second));
+  handoff.reclaim();
+  EXPECT_EQ(alive, 1);
+}
+
+TEST(TestRealtimeHandoff, retire_with_callback_waits_for_free_retire_slot)
+{
+  int alive = 0;
+  int finished = 0;
+  RealtimeHandoff<Counted, 1> handoff;
+  auto on_retire = [&finished](const Counted &) { finished++; };
+
+  handoff.publish(std::make_unique<Counted>(alive));
+  ASSERT_TRUE(handoff.retire(handoff.try_take()));
+
+  // like the executed trajectory when the appended one takes over: nothing is finished or given
+  // away while the only retire slot is occupied
+  auto active = std::make_unique<Counted>(alive);
+  Counted * const object = active.get();
+  EXPECT_FALSE(handoff.retire(active, on_retire));
+  EXPECT_EQ(finished, 0);
+  EXPECT_EQ(active.get(), object);
+
+  handoff.reclaim();
+  EXPECT_TRUE(handoff.retire(active, on_retire));
+  EXPECT_EQ(finished, 1);
+  EXPECT_EQ(active, nullptr);
+  handoff.reclaim();
+  EXPECT_EQ(alive, 0);
+}
+
+TEST(TestRealtimeHandoff, switching_trajectories_does_not_touch_the_heap)
+{
+  constexpr size_t dof = 6;
+  RealtimeHandoff<const Trajectory> handoff;
+  std::unique_ptr<const Trajectory> current;
+  std::vector<double> positions(dof), velocities(dof), accelerations(dof);
+
+  for (const size_t points : {10, 100000, 10})
+  {
+    handoff.publish(make_trajectory(points, dof));
+
+    // what update() does on every cycle: take over a new trajectory, hand the previous one back to
+    // the non-realtime side and sample the current one
+    count_heap_operations = true;
+    const Trajectory * trajectory = handoff.try_take();
+    const bool retired = handoff.retire(current.release());
+    current.reset(trajectory);
+    size_t cursor = 0;
+    for (size_t c = 0; c < 5; c++)
+    {
+      current->sample(
+        0.001 * static_cast<double>(c), cursor, positions.data(), velocities.data(),
+        accelerations.data());
+    }
+    count_heap_operations = false;
+
+    ASSERT_NE(trajectory, nullptr);
+    EXPECT_TRUE(retired);
+    EXPECT_EQ(heap_operations, 0u) << "with " << points << " points";
+    heap_operations = 0;
+
+    // the previous trajectory is freed here, outside of the realtime path
+    handoff.reclaim();
+  }
+}
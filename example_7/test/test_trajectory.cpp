@@ -0,0 +1,249 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "ros2_control_demo_example_7/trajectory.hpp"
+
+using ros2_control_demo_example_7::BlendSegment;
+using ros2_control_demo_example_7::compute_quintic;
+using ros2_control_demo_example_7::evaluate_cubic_hermite;
+using ros2_control_demo_example_7::evaluate_polynomial;
+using ros2_control_demo_example_7::InterpolationMethod;
+using ros2_control_demo_example_7::Trajectory;
+
+namespace
+{
+constexpr double tolerance = 1e-9;
+
+/// one joint moving along p(t) = sin(t) with the exact velocities and, optionally, accelerations
+trajectory_msgs::msg::JointTrajectory make_sine_msg(size_t points, bool with_accelerations)
+{
+  trajectory_msgs::msg::JointTrajectory msg;
+  msg.joint_names = {"joint_1"};
+  msg.points.resize(points);
+  for (size_t k = 0; k < points; k++)
+  {
+    const double t = static_cast<double>(k);
+    auto & point = msg.points[k];
+    point.positions = {std::sin(t)};
+    point.velocities = {std::cos(t)};
+    if (with_accelerations)
+    {
+      point.accelerations = {-std::sin(t)};
+    }
+    point.time_from_start.sec = static_cast<int32_t>(k);
+  }
+  return msg;
+}
+
+struct State
+{
+  double p;
+  double v;
+  double a;
+};
+
+State sample(const Trajectory & trajectory, double time)
+{
+  State state;
+  size_t cursor = 0;
+  trajectory.sample(time, cursor, &state.p, &state.v, &state.a);
+  return state;
+}
+}  // namespace
+
+TEST(TestTrajectory, find_segment_at_boundaries)
+{
+  Trajectory trajectory;
+  std::string error;
+  auto msg = make_sine_msg(5, false);
+  ASSERT_TRUE(trajectory.from_msg(msg, msg.joint_names, InterpolationMethod::LINEAR, error));
+
+  EXPECT_EQ(trajectory.find_segment(-1.0, 0), 0u);
+  EXPECT_EQ(trajectory.find_segment(0.0, 0), 0u);
+  EXPECT_EQ(trajectory.find_segment(0.5, 0), 0u);
+  // a point belongs to the segment starting at it
+  EXPECT_EQ(trajectory.find_segment(1.0, 0), 1u);
+  EXPECT_EQ(trajectory.find_segment(3.5, 3), 3u);
+  // the end and beyond stay in the last segment
+  EXPECT_EQ(trajectory.find_segment(4.0, 0), 3u);
+  EXPECT_EQ(trajectory.find_segment(10.0, 3), 3u);
+}
+
+TEST(TestTrajectory, find_segment_falls_back_to_binary_search)
+{
+  Trajectory trajectory;
+  std::string error;
+  auto msg = make_sine_msg(100, false);
+  ASSERT_TRUE(trajectory.from_msg(msg, msg.joint_names, InterpolationMethod::LINEAR, error));
+
+  // further ahead than the linear steps cover
+  EXPECT_EQ(trajectory.find_segment(50.5, 0), 50u);
+  EXPECT_EQ(trajectory.find_segment(51.0, 50), 51u);
+  // backwards
+  EXPECT_EQ(trajectory.find_segment(2.5, 50), 2u);
+  EXPECT_EQ(trajectory.find_segment(0.0, 98), 0u);
+  // a cursor out of range
+  EXPECT_EQ(trajectory.find_segment(1.5, 1000), 1u);
+}
+
+TEST(TestTrajectory, columns_follow_the_controlled_joints)
+{
+  trajectory_msgs::msg::JointTrajectory msg;
+  msg.joint_names = {"joint_2", "joint_1"};
+  msg.points.resize(2);
+  msg.points[0].positions = {2.0, 1.0};
+  msg.points[1].positions = {4.0, 3.0};
+  msg.points[1].time_from_start.sec = 2;
+
+  Trajectory trajectory;
+  std::string error;
+  const std::vector<std::string> joint_names = {"joint_1", "joint_2"};
+  ASSERT_TRUE(trajectory.from_msg(msg, joint_names, InterpolationMethod::LINEAR, error)) << error;
+  EXPECT_EQ(trajectory.size(), 2u);
+  EXPECT_EQ(trajectory.dof(), 2u);
+  EXPECT_DOUBLE_EQ(trajectory.duration(), 2.0);
+  EXPECT_EQ(trajectory.positions(1)[0], 3.0);
+  EXPECT_EQ(trajectory.positions(1)[1], 4.0);
+
+  double p[2], v[2], a[2];
+  size_t cursor = 0;
+  EXPECT_FALSE(trajectory.sample(0.5, cursor, p, v, a));
+  EXPECT_DOUBLE_EQ(p[0], 1.5);
+  EXPECT_DOUBLE_EQ(p[1], 2.5);
+  // at the end the last positions are held
+  EXPECT_TRUE(trajectory.sample(3.0, cursor, p, v, a));
+  EXPECT_EQ(p[0], 3.0);
+  EXPECT_EQ(p[1], 4.0);
+  EXPECT_EQ(v[0], 0.0);
+
+  msg.points[1].time_from_start.sec = 0;
+  EXPECT_FALSE(trajectory.from_msg(msg, joint_names, InterpolationMethod::LINEAR, error));
+  msg.joint_names = {"joint_2", "joint_3"};
+  EXPECT_FALSE(trajectory.from_msg(msg, joint_names, InterpolationMethod::LINEAR, error));
+}
+
+TEST(TestTrajectory, quintic_matches_both_end_states)
+{
+  constexpr size_t dof = 2;
+  const double p_0[dof] = {0.5, -1.0};
+  const double v_0[dof] = {0.1, 2.0};
+  const double a_0[dof] = {-0.3, 0.0};
+  const double p_1[dof] = {1.5, 3.0};
+  const double v_1[dof] = {0.0, -1.0};
+  const double a_1[dof] = {0.7, 4.0};
+  constexpr double T = 1.5;
+
+  double coefficients[6 * dof];
+  compute_quintic(p_0, v_0, a_0, p_1, v_1, a_1, T, dof, coefficients);
+
+  double p[dof], v[dof], a[dof];
+  evaluate_polynomial(coefficients, 5, dof, 0.0, p, v, a);
+  for (size_t j = 0; j < dof; j++)
+  {
+    EXPECT_NEAR(p[j], p_0[j], tolerance);
+    EXPECT_NEAR(v[j], v_0[j], tolerance);
+    EXPECT_NEAR(a[j], a_0[j], tolerance);
+  }
+  evaluate_polynomial(coefficients, 5, dof, T, p, v, a);
+  for (size_t j = 0; j < dof; j++)
+  {
+    EXPECT_NEAR(p[j], p_1[j], tolerance);
+    EXPECT_NEAR(v[j], v_1[j], tolerance);
+    EXPECT_NEAR(a[j], a_1[j], tolerance);
+  }
+}
+
+TEST(TestTrajectory, cubic_hermite_matches_both_end_states)
+{
+  const double p_0 = 0.5, v_0 = -0.2, p_1 = 2.0, v_1 = 1.0;
+  constexpr double T = 0.75;
+
+  double p, v, a;
+  evaluate_cubic_hermite(&p_0, &v_0, &p_1, &v_1, T, 1, 0.0, &p, &v, &a);
+  EXPECT_NEAR(p, p_0, tolerance);
+  EXPECT_NEAR(v, v_0, tolerance);
+  evaluate_cubic_hermite(&p_0, &v_0, &p_1, &v_1, T, 1, T, &p, &v, &a);
+  EXPECT_NEAR(p, p_1, tolerance);
+  EXPECT_NEAR(v, v_1, tolerance);
+}
+
+TEST(TestTrajectory, splines_are_continuous_at_the_points)
+{
+  constexpr double epsilon = 1e-7;
+
+  for (const bool with_accelerations : {false, true})
+  {
+    Trajectory trajectory;
+    std::string error;
+    auto msg = make_sine_msg(6, with_accelerations);
+    ASSERT_TRUE(trajectory.from_msg(msg, msg.joint_names, InterpolationMethod::SPLINES, error))
+      << error;
+    EXPECT_EQ(trajectory.spline_degree(), with_accelerations ? 5u : 3u);
+
+    for (size_t k = 1; k + 1 < msg.points.size(); k++)
+    {
+      const double t = static_cast<double>(k);
+      const State at = sample(trajectory, t);
+      EXPECT_NEAR(at.p, std::sin(t), tolerance);
+      EXPECT_NEAR(at.v, std::cos(t), tolerance);
+
+      const State before = sample(trajectory, t - epsilon);
+      const State after = sample(trajectory, t + epsilon);
+      EXPECT_NEAR(before.p, after.p, 1e-6);
+      EXPECT_NEAR(before.v, after.v, 1e-5);
+      if (with_accelerations)
+      {
+        EXPECT_NEAR(at.a, -std::sin(t), tolerance);
+        EXPECT_NEAR(before.a, after.a, 1e-4);
+      }
+    }
+  }
+}
+
+TEST(TestTrajectory, blend_segment_joins_current_state_and_target)
+{
+  Trajectory target;
+  std::string error;
+  auto msg = make_sine_msg(4, true);
+  ASSERT_TRUE(target.from_msg(msg, msg.joint_names, InterpolationMethod::SPLINES, error));
+
+  BlendSegment blend;
+  blend.resize(1);
+  const State start{2.0, -0.5, 1.0};
+  constexpr double duration = 1.5;
+  blend.compute(&start.p, &start.v, &start.a, target, duration);
+  EXPECT_EQ(blend.duration(), duration);
+
+  State state;
+  blend.sample(0.0, &state.p, &state.v, &state.a);
+  EXPECT_NEAR(state.p, start.p, tolerance);
+  EXPECT_NEAR(state.v, start.v, tolerance);
+  EXPECT_NEAR(state.a, start.a, tolerance);
+
+  // the target takes over where the blend ends, also if it is sampled later than that
+  const State expected = sample(target, duration);
+  for (const double time : {duration, duration + 1.0})
+  {
+    blend.sample(time, &state.p, &state.v, &state.a);
+    EXPECT_NEAR(state.p, expected.p, tolerance);
+    EXPECT_NEAR(state.v, expected.v, tolerance);
+    EXPECT_NEAR(state.a, expected.a, tolerance);
+  }
+}
@@ -0,0 +1,127 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ros2_control_demo_example_7/trajectory.hpp"
+#include "ros2_control_demo_example_7/trajectory_file.hpp"
+
+using ros2_control_demo_example_7::InterpolationMethod;
+using ros2_control_demo_example_7::MappedTrajectoryFile;
+using ros2_control_demo_example_7::Trajectory;
+using ros2_control_demo_example_7::TrajectoryFileWriter;
+
+namespace
+{
+const std::vector<std::string> joint_names = {"joint_1", "joint_2"};
+constexpr size_t num_points = 5;
+
+class TestTrajectoryFile : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    filename_ = ::testing::TempDir() + "test_trajectory_file_" + std::to_string(getpid()) + ".bin";
+    for (size_t k = 0; k < num_points; k++)
+    {
+      times_.push_back(0.5 * static_cast<double>(k));
+      for (size_t j = 0; j < joint_names.size(); j++)
+      {
+        positions_.push_back(static_cast<double>(k) + 0.1 * static_cast<double>(j));
+        velocities_.push_back(-static_cast<double>(k) - 0.1 * static_cast<double>(j));
+      }
+    }
+  }
+
+  void TearDown() override { std::remove(filename_.c_str()); }
+
+  /// writes the points in two ranges, the second one first
+  void write(bool has_velocities)
+  {
+    TrajectoryFileWriter writer;
+    std::string error;
+    ASSERT_TRUE(writer.open(filename_, joint_names, num_points, has_velocities, error)) << error;
+    const size_t dof = joint_names.size();
+    ASSERT_TRUE(writer.write_points(
+      2, num_points - 2, &times_[2], &positions_[2 * dof], &velocities_[2 * dof]));
+    ASSERT_TRUE(writer.write_points(0, 2, &times_[0], &positions_[0], &velocities_[0]));
+    ASSERT_TRUE(writer.close(error)) << error;
+  }
+
+  std::string filename_;
+  std::vector<double> times_;
+  std::vector<double> positions_;
+  std::vector<double> velocities_;
+};
+}  // namespace
+
+TEST_F(TestTrajectoryFile, round_trip)
+{
+  write(true);
+
+  MappedTrajectoryFile file;
+  std::string error;
+  ASSERT_TRUE(file.open(filename_, false, error)) << error;
+  EXPECT_EQ(file.header().num_points, num_points);
+  EXPECT_EQ(file.joint_names(), joint_names);
+  ASSERT_TRUE(file.has_velocities());
+  EXPECT_EQ(std::vector<double>(file.times(), file.times() + num_points), times_);
+  EXPECT_EQ(
+    std::vector<double>(file.positions(), file.positions() + positions_.size()), positions_);
+  EXPECT_EQ(
+    std::vector<double>(file.velocities(), file.velocities() + velocities_.size()), velocities_);
+}
+
+TEST_F(TestTrajectoryFile, positions_only_file_is_executed_linearly)
+{
+  write(false);
+
+  auto file = std::make_shared<MappedTrajectoryFile>();
+  std::string error;
+  ASSERT_TRUE(file->open(filename_, true, error)) << error;
+  EXPECT_FALSE(file->has_velocities());
+  EXPECT_EQ(file->velocities(), nullptr);
+  EXPECT_EQ(
+    std::vector<double>(file->positions(), file->positions() + positions_.size()), positions_);
+
+  Trajectory trajectory;
+  EXPECT_FALSE(trajectory.from_file(file, joint_names, InterpolationMethod::SPLINES, error));
+  ASSERT_TRUE(trajectory.from_file(file, joint_names, InterpolationMethod::LINEAR, error))
+    << error;
+  EXPECT_EQ(trajectory.size(), num_points);
+
+  double p[2], v[2], a[2];
+  size_t cursor = 0;
+  trajectory.sample(0.75, cursor, p, v, a);
+  EXPECT_DOUBLE_EQ(p[0], 1.5);
+  EXPECT_DOUBLE_EQ(p[1], 1.6);
+}
+
+TEST_F(TestTrajectoryFile, rejects_truncated_file)
+{
+  write(true);
+  ASSERT_EQ(truncate(filename_.c_str(), 64), 0);
+
+  MappedTrajectoryFile file;
+  std::string error;
+  EXPECT_FALSE(file.open(filename_, false, error));
+  EXPECT_FALSE(error.empty());
+}
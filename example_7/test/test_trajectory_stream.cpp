@@ -0,0 +1,95 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "ros2_control_demo_example_7/trajectory_stream.hpp"
+
+using ros2_control_demo_example_7::InterpolationMethod;
+using ros2_control_demo_example_7::StreamState;
+using ros2_control_demo_example_7::TrajectoryStream;
+
+namespace
+{
+const std::vector<std::string> joint_names = {"joint_1"};
+
+/// chunk of points of one joint, times in seconds; without points it ends the stream
+trajectory_msgs::msg::JointTrajectory make_chunk(
+  const std::vector<double> & times, const std::vector<double> & positions)
+{
+  trajectory_msgs::msg::JointTrajectory chunk;
+  chunk.joint_names = joint_names;
+  chunk.points.resize(times.size());
+  for (size_t k = 0; k < times.size(); k++)
+  {
+    chunk.points[k].positions = {positions[k]};
+    chunk.points[k].time_from_start.sec = static_cast<int32_t>(times[k]);
+    chunk.points[k].time_from_start.nanosec =
+      static_cast<uint32_t>((times[k] - static_cast<int32_t>(times[k])) * 1E9);
+  }
+  return chunk;
+}
+}  // namespace
+
+TEST(TestTrajectoryStream, holds_the_last_point_on_underrun_and_finishes)
+{
+  TrajectoryStream stream;
+  stream.resize(8, 1, InterpolationMethod::LINEAR);
+  std::string error;
+  double p = 0.0, v = 0.0, a = 0.0;
+
+  EXPECT_EQ(stream.sample(0.25, &p, &v, &a), StreamState::IDLE);
+
+  ASSERT_TRUE(stream.push(make_chunk({0.0, 1.0}, {0.0, 1.0}), joint_names, error)) << error;
+  EXPECT_EQ(stream.sample(0.25, &p, &v, &a), StreamState::RUNNING);
+  EXPECT_DOUBLE_EQ(p, 0.0);
+  EXPECT_EQ(stream.sample(0.5, &p, &v, &a), StreamState::RUNNING);
+  EXPECT_DOUBLE_EQ(p, 0.5);
+
+  // the next chunk is late: the last point is held and the stream clock pauses, counted once
+  for (int cycle = 0; cycle < 3; cycle++)
+  {
+    EXPECT_EQ(stream.sample(0.5, &p, &v, &a), StreamState::UNDERRUN);
+    EXPECT_DOUBLE_EQ(p, 1.0);
+    EXPECT_DOUBLE_EQ(v, 0.0);
+  }
+  EXPECT_EQ(stream.underruns(), 1u);
+
+  // the stream continues where it paused
+  ASSERT_TRUE(stream.push(make_chunk({2.0}, {3.0}), joint_names, error)) << error;
+  EXPECT_EQ(stream.sample(0.5, &p, &v, &a), StreamState::RUNNING);
+  EXPECT_DOUBLE_EQ(p, 2.0);
+
+  // a chunk without points ends the stream
+  ASSERT_TRUE(stream.push(make_chunk({}, {}), joint_names, error)) << error;
+  EXPECT_EQ(stream.sample(0.5, &p, &v, &a), StreamState::FINISHED);
+  EXPECT_DOUBLE_EQ(p, 3.0);
+  EXPECT_EQ(stream.sample(0.5, &p, &v, &a), StreamState::IDLE);
+  EXPECT_EQ(stream.underruns(), 1u);
+}
+
+TEST(TestTrajectoryStream, rejects_chunks_that_do_not_continue_or_fit)
+{
+  TrajectoryStream stream;
+  stream.resize(3, 1, InterpolationMethod::LINEAR);
+  std::string error;
+
+  ASSERT_TRUE(stream.push(make_chunk({0.0, 1.0}, {0.0, 1.0}), joint_names, error)) << error;
+  EXPECT_FALSE(stream.push(make_chunk({1.0}, {2.0}), joint_names, error));
+  EXPECT_FALSE(stream.push(make_chunk({2.0, 3.0}, {2.0, 3.0}), joint_names, error));
+  EXPECT_TRUE(stream.push(make_chunk({2.0}, {2.0}), joint_names, error)) << error;
+}
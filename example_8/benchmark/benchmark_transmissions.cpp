@@ -0,0 +1,185 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "ros2_control_demo_example_8/transmission_engine.hpp"
+#include "transmission_interface/differential_transmission_loader.hpp"
+#include "transmission_interface/four_bar_linkage_transmission_loader.hpp"
+#include "transmission_interface/simple_transmission_loader.hpp"
+
+using ros2_control_demo_example_8::TransmissionEngine;
+
+namespace
+{
+constexpr size_t WARMUP_CYCLES = 1000;
+constexpr const char * QUANTITY_NAMES[] = {
+  hardware_interface::HW_IF_POSITION, hardware_interface::HW_IF_VELOCITY,
+  hardware_interface::HW_IF_EFFORT};
+
+/// Three simple transmissions for every differential and every four-bar linkage transmission.
+std::vector<hardware_interface::TransmissionInfo> make_infos(size_t count)
+{
+  std::vector<hardware_interface::TransmissionInfo> infos;
+  for (size_t i = 0; i < count; i++)
+  {
+    hardware_interface::TransmissionInfo info;
+    info.name = "transmission" + std::to_string(i);
+    const size_t kind = i % 5;
+    info.type = kind < 3   ? "transmission_interface/SimpleTransmission"
+                : kind < 4 ? "transmission_interface/DifferentialTransmission"
+                           : "transmission_interface/FourBarLinkageTransmission";
+    for (size_t j = 0; j < (kind < 3 ? 1u : 2u); j++)
+    {
+      hardware_interface::JointInfo joint;
+      joint.name = info.name + "_joint" + std::to_string(j);
+      joint.mechanical_reduction = 2.0 + static_cast<double>(j);
+      joint.offset = 0.1;
+      info.joints.push_back(joint);
+      hardware_interface::ActuatorInfo actuator;
+      actuator.name = info.name + "_actuator" + std::to_string(j);
+      actuator.mechanical_reduction = 1.5;
+      info.actuators.push_back(actuator);
+    }
+    infos.push_back(info);
+  }
+  return infos;
+}
+
+std::shared_ptr<transmission_interface::Transmission> load(
+  const hardware_interface::TransmissionInfo & info)
+{
+  if (info.type == "transmission_interface/DifferentialTransmission")
+  {
+    return transmission_interface::DifferentialTransmissionLoader().load(info);
+  }
+  if (info.type == "transmission_interface/FourBarLinkageTransmission")
+  {
+    return transmission_interface::FourBarLinkageTransmissionLoader().load(info);
+  }
+  return transmission_interface::SimpleTransmissionLoader().load(info);
+}
+
+/// Median time in nanoseconds of \p count calls of \p cycle.
+template <typename Cycle>
+double measure(size_t count, Cycle && cycle)
+{
+  std::vector<double> times;
+  times.reserve(count);
+  for (size_t i = 0; i < WARMUP_CYCLES + count; i++)
+  {
+    const auto begin = std::chrono::steady_clock::now();
+    cycle();
+    const std::chrono::duration<double, std::nano> time = std::chrono::steady_clock::now() - begin;
+    if (i >= WARMUP_CYCLES)
+    {
+      times.push_back(time.count());
+    }
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+}  // namespace
+
+// Time of mapping position, velocity and effort from the actuators to the joints and back, once
+// with a virtual call per transmission_interface::Transmission and once with the batched passes
+// of the TransmissionEngine.
+int main(int argc, char ** argv)
+{
+  const size_t count = argc > 2 ? std::stoul(argv[2]) : 10000;
+
+  std::printf(
+    "%14s %8s %20s %16s\n", "transmissions", "joints", "per transmission [ns]", "batched [ns]");
+  const std::vector<size_t> sizes =
+    argc > 1 ? std::vector<size_t>{std::stoul(argv[1])} : std::vector<size_t>{10, 100, 1000};
+  for (const size_t size : sizes)
+  {
+    const auto infos = make_infos(size);
+    TransmissionEngine engine;
+    for (const auto & info : infos)
+    {
+      engine.add(info);
+    }
+
+    // the handles point straight into the arrays of the engine, so no values are copied
+    std::array<std::vector<double>, TransmissionEngine::NUM_QUANTITIES> joints, actuators;
+    std::vector<std::shared_ptr<transmission_interface::Transmission>> transmissions;
+    for (size_t q = 0; q < TransmissionEngine::NUM_QUANTITIES; q++)
+    {
+      joints[q].assign(engine.num_joints(), 0.0);
+      actuators[q].assign(engine.num_actuators(), 1.0);
+    }
+    for (size_t t = 0; t < infos.size(); t++)
+    {
+      std::vector<transmission_interface::JointHandle> joint_handles;
+      std::vector<transmission_interface::ActuatorHandle> actuator_handles;
+      for (size_t q = 0; q < TransmissionEngine::NUM_QUANTITIES; q++)
+      {
+        for (const size_t joint : engine.transmissions()[t].joints)
+        {
+          joint_handles.emplace_back(
+            engine.joint_names()[joint], QUANTITY_NAMES[q], &joints[q][joint]);
+        }
+        for (const size_t actuator : engine.transmissions()[t].actuators)
+        {
+          actuator_handles.emplace_back(
+            engine.actuator_names()[actuator], QUANTITY_NAMES[q], &actuators[q][actuator]);
+        }
+      }
+      transmissions.push_back(load(infos[t]));
+      transmissions.back()->configure(joint_handles, actuator_handles);
+    }
+
+    const double per_transmission = measure(
+      count,
+      [&]()
+      {
+        for (const auto & transmission : transmissions)
+        {
+          transmission->actuator_to_joint();
+        }
+        for (const auto & transmission : transmissions)
+        {
+          transmission->joint_to_actuator();
+        }
+      });
+
+    const double batched = measure(
+      count,
+      [&]()
+      {
+        for (size_t q = 0; q < TransmissionEngine::NUM_QUANTITIES; q++)
+        {
+          engine.actuator_to_joint(
+            static_cast<TransmissionEngine::Quantity>(q), actuators[q].data(), joints[q].data());
+        }
+        for (size_t q = 0; q < TransmissionEngine::NUM_QUANTITIES; q++)
+        {
+          engine.joint_to_actuator(
+            static_cast<TransmissionEngine::Quantity>(q), joints[q].data(), actuators[q].data());
+        }
+      });
+
+    std::printf(
+      "%14zu %8zu %20.0f %16.0f\n", size, engine.num_joints(), per_transmission, batched);
+  }
+  return 0;
+}
@@ -15,6 +15,7 @@
 #ifndef ROS2_CONTROL_DEMO_EXAMPLE_8__RRBOT_TRANSMISSIONS_SYSTEM_POSITION_ONLY_HPP_
 #define ROS2_CONTROL_DEMO_EXAMPLE_8__RRBOT_TRANSMISSIONS_SYSTEM_POSITION_ONLY_HPP_
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
@@ -28,7 +29,9 @@
 #include "rclcpp/logger.hpp"
 #include "rclcpp/macros.hpp"
 #include "rclcpp_lifecycle/state.hpp"
-#include "transmission_interface/transmission.hpp"
+#include "ros2_control_demo_example_8/transmission_engine.hpp"
+#include "ros2_control_demo_utils/interface_handles.hpp"
+#include "ros2_control_demo_utils/realtime_logger.hpp"
 
 namespace ros2_control_demo_example_8
 {
@@ -54,25 +57,35 @@ public:
     const rclcpp::Time & time, const rclcpp::Duration & period) override;
 
 private:
+  /**
+   * Logs the values of all transmissions unless \p throttle holds them back, realtime safe.
+   *
+   * Every transmission gets a record of its own, so any number of them fits.
+   */
+  void log_transmissions(
+    ros2_control_demo_utils::LogThrottle & throttle, const char * title,
+    const std::vector<double> & joint_values, const std::vector<double> & actuator_values,
+    const char * arrow);
+
   // parameters for the RRBot simulation
   double actuator_slowdown_;
 
-  // transmissions
-  std::vector<std::shared_ptr<transmission_interface::Transmission>> transmissions_;
+  ros2_control_demo_utils::RealtimeLogger rt_logger_;
+  ros2_control_demo_utils::LogThrottle read_log_throttle_{std::chrono::milliseconds(500)};
+  ros2_control_demo_utils::LogThrottle write_log_throttle_{std::chrono::milliseconds(500)};
 
-  struct InterfaceData
-  {
-    explicit InterfaceData(const std::string & name);
+  // transmissions
+  TransmissionEngine transmissions_;
 
-    std::string name_;
-    double command_;
-    double state_;
+  // positions of the joints and actuators, numbered like in transmissions_
+  std::vector<double> joint_positions_;
+  std::vector<double> joint_position_commands_;
+  std::vector<double> actuator_positions_;
+  std::vector<double> actuator_position_commands_;
 
-    // this is the "sink" that will be part of the transmission Joint/Actuator handles
-    double transmission_passthrough_;
-  };
-  std::vector<InterfaceData> joint_interfaces_;
-  std::vector<InterfaceData> actuator_interfaces_;
+  // position interfaces of the joints, looked up in on_configure()
+  std::vector<ros2_control_demo_utils::StateHandle> joint_state_handles_;
+  std::vector<ros2_control_demo_utils::CommandHandle> joint_command_handles_;
 };
 
 }  // namespace ros2_control_demo_example_8
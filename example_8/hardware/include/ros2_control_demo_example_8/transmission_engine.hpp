@@ -0,0 +1,115 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS2_CONTROL_DEMO_EXAMPLE_8__TRANSMISSION_ENGINE_HPP_
+#define ROS2_CONTROL_DEMO_EXAMPLE_8__TRANSMISSION_ENGINE_HPP_
+
+#include <stddef.h>
+#include <array>
+#include <string>
+#include <vector>
+
+#include "hardware_interface/hardware_info.hpp"
+
+namespace ros2_control_demo_example_8
+{
+/**
+ * Maps the values of all actuators of a component to the values of its joints and back.
+ *
+ * Every transmission is compiled into an affine map per quantity and direction when it is added,
+ * by probing its transmission_interface::Transmission with unit vectors. The engine numbers joints
+ * and actuators itself: simple transmissions come first and in the same order, so the joint and
+ * the actuator of one share their index, followed by the pairs of joints and actuators of
+ * differential and four-bar linkage transmissions. The maps are applied in one vectorized pass
+ * over the simple transmissions and one batched 2x2 matrix-vector pass over the others, without
+ * a virtual call per transmission.
+ */
+class TransmissionEngine
+{
+public:
+  enum class Quantity
+  {
+    POSITION,
+    VELOCITY,
+    EFFORT,
+  };
+  static constexpr size_t NUM_QUANTITIES = 3;
+
+  /// Joints and actuators of one transmission as indices into the arrays of the engine.
+  struct TransmissionIndex
+  {
+    std::vector<size_t> joints;
+    std::vector<size_t> actuators;
+  };
+
+  /**
+   * Loads the transmission described by \p info, not realtime safe.
+   *
+   * \throws transmission_interface::TransmissionInterfaceException if the transmission is invalid
+   * or its type is not supported
+   */
+  void add(const hardware_interface::TransmissionInfo & info);
+
+  size_t num_joints() const { return joint_names_.size(); }
+  size_t num_actuators() const { return actuator_names_.size(); }
+  /// Number of simple transmissions, their joints and actuators have the indices below.
+  size_t num_simple() const { return actuator_to_joint_[0].scales.size(); }
+  /// Number of two-joint transmissions, their joints and actuators follow the simple ones.
+  size_t num_coupled() const { return actuator_to_joint_[0].m00.size(); }
+
+  const std::vector<std::string> & joint_names() const { return joint_names_; }
+  const std::vector<std::string> & actuator_names() const { return actuator_names_; }
+
+  /// Joints and actuators of each transmission, in the order they were added.
+  const std::vector<TransmissionIndex> & transmissions() const { return index_; }
+  /// Index into transmissions() of the transmission driving joint \p joint.
+  size_t joint_transmission(size_t joint) const { return joint_transmissions_[joint]; }
+  /// Index into transmissions() of the transmission driven by actuator \p actuator.
+  size_t actuator_transmission(size_t actuator) const { return actuator_transmissions_[actuator]; }
+
+  /// Computes the num_joints() values of the joints, realtime safe.
+  void actuator_to_joint(Quantity quantity, const double * actuator_values, double * joint_values)
+    const;
+
+  /// Computes the num_actuators() values of the actuators, realtime safe.
+  void joint_to_actuator(Quantity quantity, const double * joint_values, double * actuator_values)
+    const;
+
+private:
+  /// y = A x + b of all transmissions for one quantity and direction.
+  struct AffineMaps
+  {
+    // simple transmissions: y[i] = scales[i] * x[i] + offsets[i]
+    std::vector<double> scales;
+    std::vector<double> offsets;
+    // coupled transmission k maps x[s + 2k], x[s + 2k + 1] with a row-major 2x2 matrix
+    std::vector<double> m00, m01, m10, m11;
+    std::vector<double> b0, b1;
+  };
+
+  static void apply(const AffineMaps & maps, const double * x, double * y);
+
+  std::vector<std::string> joint_names_;
+  std::vector<std::string> actuator_names_;
+  std::vector<TransmissionIndex> index_;
+  std::vector<size_t> joint_transmissions_;
+  std::vector<size_t> actuator_transmissions_;
+
+  std::array<AffineMaps, NUM_QUANTITIES> actuator_to_joint_;
+  std::array<AffineMaps, NUM_QUANTITIES> joint_to_actuator_;
+};
+
+}  // namespace ros2_control_demo_example_8
+
+#endif  // ROS2_CONTROL_DEMO_EXAMPLE_8__TRANSMISSION_ENGINE_HPP_
@@ -14,27 +14,21 @@
 
 #include "ros2_control_demo_example_8/rrbot_transmissions_system_position_only.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
-#include <limits>
 #include <memory>
-#include <numeric>
-#include <sstream>
 #include <vector>
 
 #include "hardware_interface/lexical_casts.hpp"
 #include "hardware_interface/types/hardware_interface_type_values.hpp"
 #include "rclcpp/clock.hpp"
 #include "rclcpp/logging.hpp"
-#include "transmission_interface/simple_transmission_loader.hpp"
-#include "transmission_interface/transmission.hpp"
 #include "transmission_interface/transmission_interface_exception.hpp"
 
 namespace ros2_control_demo_example_8
 {
 
-constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
-
 hardware_interface::CallbackReturn RRBotTransmissionsSystemPositionOnlyHardware::on_init(
   const hardware_interface::HardwareComponentInterfaceParams & params)
 {
@@ -47,47 +41,15 @@ hardware_interface::CallbackReturn RRBotTransmissionsSystemPositionOnlyHardware:
     return hardware_interface::CallbackReturn::ERROR;
   }
 
-  actuator_slowdown_ = hardware_interface::stod(info_.hardware_parameters["actuator_slowdown"]);
-
-  const auto num_joints = std::accumulate(
-    info_.transmissions.begin(), info_.transmissions.end(), 0ul,
-    [](const auto & acc, const auto & trans_info) { return acc + trans_info.joints.size(); });
-
-  const auto num_actuators = std::accumulate(
-    info_.transmissions.begin(), info_.transmissions.end(), 0ul,
-    [](const auto & acc, const auto & trans_info) { return acc + trans_info.actuators.size(); });
-
-  // reserve the space needed for joint and actuator data structures
-  joint_interfaces_.reserve(num_joints);
-  actuator_interfaces_.reserve(num_actuators);
+  // log messages of read() and write() are formatted outside of the realtime loop, with room for
+  // a title and a record per transmission of both
+  rt_logger_.configure(get_logger(), std::max<size_t>(64, 2 * (info_.transmissions.size() + 1)));
 
-  // create transmissions, joint and actuator handles
-  auto transmission_loader = transmission_interface::SimpleTransmissionLoader();
+  actuator_slowdown_ = hardware_interface::stod(info_.hardware_parameters["actuator_slowdown"]);
 
+  // compile the transmissions into the tables of the engine
   for (const auto & transmission_info : info_.transmissions)
   {
-    // only simple transmissions are supported in this demo
-    if (transmission_info.type != "transmission_interface/SimpleTransmission")
-    {
-      RCLCPP_FATAL(
-        get_logger(), "Transmission '%s' of type '%s' not supported in this demo",
-        transmission_info.name.c_str(), transmission_info.type.c_str());
-      return hardware_interface::CallbackReturn::ERROR;
-    }
-
-    std::shared_ptr<transmission_interface::Transmission> transmission;
-    try
-    {
-      transmission = transmission_loader.load(transmission_info);
-    }
-    catch (const transmission_interface::TransmissionInterfaceException & exc)
-    {
-      RCLCPP_FATAL(
-        get_logger(), "Error while loading %s: %s", transmission_info.name.c_str(), exc.what());
-      return hardware_interface::CallbackReturn::ERROR;
-    }
-
-    std::vector<transmission_interface::JointHandle> joint_handles;
     for (const auto & joint_info : transmission_info.joints)
     {
       // this demo supports only one interface per joint
@@ -101,46 +63,25 @@ hardware_interface::CallbackReturn RRBotTransmissionsSystemPositionOnlyHardware:
           joint_info.name.c_str());
         return hardware_interface::CallbackReturn::ERROR;
       }
-
-      const auto joint_interface =
-        joint_interfaces_.insert(joint_interfaces_.end(), InterfaceData(joint_info.name));
-
-      transmission_interface::JointHandle joint_handle(
-        joint_info.name, hardware_interface::HW_IF_POSITION,
-        &joint_interface->transmission_passthrough_);
-      joint_handles.push_back(joint_handle);
     }
 
-    std::vector<transmission_interface::ActuatorHandle> actuator_handles;
-    for (const auto & actuator_info : transmission_info.actuators)
-    {
-      // no check for actuators types
-
-      const auto actuator_interface =
-        actuator_interfaces_.insert(actuator_interfaces_.end(), InterfaceData(actuator_info.name));
-      transmission_interface::ActuatorHandle actuator_handle(
-        actuator_info.name, hardware_interface::HW_IF_POSITION,
-        &actuator_interface->transmission_passthrough_);
-      actuator_handles.push_back(actuator_handle);
-    }
-
-    /// @note no need to store the joint and actuator handles, the transmission
-    /// will keep whatever info it needs after is done with them
-
     try
     {
-      transmission->configure(joint_handles, actuator_handles);
+      transmissions_.add(transmission_info);
     }
     catch (const transmission_interface::TransmissionInterfaceException & exc)
     {
       RCLCPP_FATAL(
-        get_logger(), "Error while configuring %s: %s", transmission_info.name.c_str(), exc.what());
+        get_logger(), "Error while loading %s: %s", transmission_info.name.c_str(), exc.what());
       return hardware_interface::CallbackReturn::ERROR;
     }
-
-    transmissions_.push_back(transmission);
   }
 
+  joint_positions_.resize(transmissions_.num_joints());
+  joint_position_commands_.resize(transmissions_.num_joints());
+  actuator_positions_.resize(transmissions_.num_actuators());
+  actuator_position_commands_.resize(transmissions_.num_actuators());
+
   RCLCPP_INFO(get_logger(), "Initialization successful");
 
   return hardware_interface::CallbackReturn::SUCCESS;
@@ -151,18 +92,10 @@ hardware_interface::CallbackReturn RRBotTransmissionsSystemPositionOnlyHardware:
 {
   RCLCPP_INFO(get_logger(), "Configuring...");
 
-  auto reset_interfaces = [](std::vector<InterfaceData> & interfaces)
-  {
-    for (auto & interface_data : interfaces)
-    {
-      interface_data.command_ = 0.0;
-      interface_data.state_ = 0.0;
-      interface_data.transmission_passthrough_ = kNaN;
-    }
-  };
-
-  reset_interfaces(joint_interfaces_);
-  reset_interfaces(actuator_interfaces_);
+  joint_positions_.assign(joint_positions_.size(), 0.0);
+  joint_position_commands_.assign(joint_position_commands_.size(), 0.0);
+  actuator_positions_.assign(actuator_positions_.size(), 0.0);
+  actuator_position_commands_.assign(actuator_position_commands_.size(), 0.0);
 
   // reset values always when configuring hardware
   for (const auto & [name, descr] : joint_state_interfaces_)
@@ -174,6 +107,24 @@ hardware_interface::CallbackReturn RRBotTransmissionsSystemPositionOnlyHardware:
     set_command(name, 0.0);
   }
 
+  // look up the interfaces once instead of by name in every read() and write()
+  ros2_control_demo_utils::HandleResolver resolver;
+  resolver.add_states(joint_states_);
+  resolver.add_commands(joint_commands_);
+  joint_state_handles_.resize(transmissions_.num_joints());
+  joint_command_handles_.resize(transmissions_.num_joints());
+  for (size_t i = 0; i < transmissions_.num_joints(); i++)
+  {
+    const auto name = transmissions_.joint_names()[i] + "/" + hardware_interface::HW_IF_POSITION;
+    if (
+      !resolver.resolve_state(name, joint_state_handles_[i]) ||
+      !resolver.resolve_command(name, joint_command_handles_[i]))
+    {
+      RCLCPP_FATAL(get_logger(), "Failed to look up the interfaces of '%s'.", name.c_str());
+      return hardware_interface::CallbackReturn::ERROR;
+    }
+  }
+
   RCLCPP_INFO(get_logger(), "Configuration successful");
 
   return hardware_interface::CallbackReturn::SUCCESS;
@@ -207,54 +158,18 @@ hardware_interface::CallbackReturn RRBotTransmissionsSystemPositionOnlyHardware:
 hardware_interface::return_type RRBotTransmissionsSystemPositionOnlyHardware::read(
   const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
 {
-  // actuator: state -> transmission
-  std::for_each(
-    actuator_interfaces_.begin(), actuator_interfaces_.end(), [](auto & actuator_interface)
-    { actuator_interface.transmission_passthrough_ = actuator_interface.state_; });
-
-  // transmission: actuator -> joint
-  std::for_each(
-    transmissions_.begin(), transmissions_.end(),
-    [](auto & transmission) { transmission->actuator_to_joint(); });
-
-  // joint: transmission -> state
-  std::for_each(
-    joint_interfaces_.begin(), joint_interfaces_.end(), [](auto & joint_interface)
-    { joint_interface.state_ = joint_interface.transmission_passthrough_; });
-
-  // log state data
-  std::stringstream ss;
-  ss << "State data:";
-  for (const auto & transmission_info : info_.transmissions)
-  {
-    // again, this only for simple transmissions, we know there is only one joint
-    const auto joint_interface_is_transmission = std::find_if(
-      joint_interfaces_.cbegin(), joint_interfaces_.cend(), [&](const auto & joint_interface)
-      { return joint_interface.name_ == transmission_info.joints[0].name; });
-
-    const auto actuator_interface_is_transmission = std::find_if(
-      actuator_interfaces_.cbegin(), actuator_interfaces_.cend(),
-      [&](const auto & actuator_interface)
-      { return actuator_interface.name_ == transmission_info.actuators[0].name; });
-
-    const auto & reduction = transmission_info.joints[0].mechanical_reduction;
-
-    ss << std::endl
-       << "\t" << joint_interface_is_transmission->name_ << ": "
-       << joint_interface_is_transmission->state_ << " <-- " << transmission_info.name
-       << "(R=" << reduction << ") <-- " << actuator_interface_is_transmission->name_ << ": "
-       << actuator_interface_is_transmission->state_;
-  }
-  RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 500, "%s", ss.str().c_str());
+  // transmission: actuator -> joint, all transmissions in one batched pass
+  transmissions_.actuator_to_joint(
+    TransmissionEngine::Quantity::POSITION, actuator_positions_.data(), joint_positions_.data());
+
+  log_transmissions(
+    read_log_throttle_, "State data:", joint_positions_, actuator_positions_, "<--");
 
   // update internal storage from resource_manager
-  std::for_each(
-    joint_interfaces_.begin(), joint_interfaces_.end(),
-    [this](auto & joint_interface)
-    {
-      set_state(
-        joint_interface.name_ + "/" + hardware_interface::HW_IF_POSITION, joint_interface.state_);
-    });
+  for (size_t i = 0; i < joint_positions_.size(); i++)
+  {
+    joint_state_handles_[i].set(joint_positions_[i]);
+  }
 
   return hardware_interface::return_type::OK;
 }
@@ -263,70 +178,79 @@ hardware_interface::return_type RRBotTransmissionsSystemPositionOnlyHardware::wr
   const rclcpp::Time & /*time*/, const rclcpp::Duration & /*period*/)
 {
   // update internal storage from resource_manager
-  std::for_each(
-    joint_interfaces_.begin(), joint_interfaces_.end(),
-    [this](auto & joint_interface)
-    {
-      joint_interface.command_ =
-        get_command(joint_interface.name_ + "/" + hardware_interface::HW_IF_POSITION);
-    });
-
-  // joint: command -> transmission
-  std::for_each(
-    joint_interfaces_.begin(), joint_interfaces_.end(), [](auto & joint_interface)
-    { joint_interface.transmission_passthrough_ = joint_interface.command_; });
-
-  // transmission: joint -> actuator
-  std::for_each(
-    transmissions_.begin(), transmissions_.end(),
-    [](auto & transmission) { transmission->joint_to_actuator(); });
+  for (size_t i = 0; i < joint_position_commands_.size(); i++)
+  {
+    joint_position_commands_[i] = joint_command_handles_[i].get();
+  }
 
-  // actuator: transmission -> command
-  std::for_each(
-    actuator_interfaces_.begin(), actuator_interfaces_.end(), [](auto & actuator_interface)
-    { actuator_interface.command_ = actuator_interface.transmission_passthrough_; });
+  // transmission: joint -> actuator, all transmissions in one batched pass
+  transmissions_.joint_to_actuator(
+    TransmissionEngine::Quantity::POSITION, joint_position_commands_.data(),
+    actuator_position_commands_.data());
 
   // simulate motor motion
-  std::for_each(
-    actuator_interfaces_.begin(), actuator_interfaces_.end(),
-    [&](auto & actuator_interface)
-    {
-      actuator_interface.state_ =
-        actuator_interface.state_ +
-        (actuator_interface.command_ - actuator_interface.state_) / actuator_slowdown_;
-    });
-
-  // log command data
-  std::stringstream ss;
-  ss << "Command data:";
-  for (const auto & transmission_info : info_.transmissions)
+  for (size_t i = 0; i < actuator_positions_.size(); i++)
   {
-    // again, this only for simple transmissions, we know there is only one joint
-    const auto joint_interface_is_transmission = std::find_if(
-      joint_interfaces_.cbegin(), joint_interfaces_.cend(), [&](const auto & joint_interface)
-      { return joint_interface.name_ == transmission_info.joints[0].name; });
-
-    const auto actuator_interface_is_transmission = std::find_if(
-      actuator_interfaces_.cbegin(), actuator_interfaces_.cend(),
-      [&](const auto & actuator_interface)
-      { return actuator_interface.name_ == transmission_info.actuators[0].name; });
-
-    const auto & reduction = transmission_info.joints[0].mechanical_reduction;
-
-    ss << std::endl
-       << "\t" << joint_interface_is_transmission->name_ << ": "
-       << joint_interface_is_transmission->command_ << " --> " << transmission_info.name
-       << "(R=" << reduction << ") --> " << actuator_interface_is_transmission->name_ << ": "
-       << actuator_interface_is_transmission->command_;
+    actuator_positions_[i] += (actuator_position_commands_[i] - actuator_positions_[i]) /
+                              actuator_slowdown_;
   }
-  RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 500, "%s", ss.str().c_str());
+
+  log_transmissions(
+    write_log_throttle_, "Command data:", joint_position_commands_, actuator_position_commands_,
+    "-->");
 
   return hardware_interface::return_type::OK;
 }
 
-RRBotTransmissionsSystemPositionOnlyHardware::InterfaceData::InterfaceData(const std::string & name)
-: name_(name), command_(kNaN), state_(kNaN), transmission_passthrough_(kNaN)
+void RRBotTransmissionsSystemPositionOnlyHardware::log_transmissions(
+  ros2_control_demo_utils::LogThrottle & throttle, const char * title,
+  const std::vector<double> & joint_values, const std::vector<double> & actuator_values,
+  const char * arrow)
 {
+  // the work is skipped while the records are throttled
+  if (!throttle.ready())
+  {
+    return;
+  }
+  rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO).append("%s", title);
+
+  // indices from the table of the transmissions, no lookups by name
+  const auto & joint_names = transmissions_.joint_names();
+  const auto & actuator_names = transmissions_.actuator_names();
+  const auto & transmissions = transmissions_.transmissions();
+  for (size_t i = 0; i < transmissions.size(); i++)
+  {
+    auto record = rt_logger_.record(ros2_control_demo_utils::LogSeverity::INFO);
+    if (!record)
+    {
+      // the ring is full, the following records would be dropped as well
+      return;
+    }
+    const auto & transmission_info = info_.transmissions[i];
+    const auto & joints = transmissions[i].joints;
+    const auto & actuators = transmissions[i].actuators;
+    if (joints.size() == 1 && actuators.size() == 1)
+    {
+      record.append(
+        "\t%s: %g %s %s", joint_names[joints[0]].c_str(), joint_values[joints[0]], arrow,
+        transmission_info.name.c_str());
+      record.append(
+        "(R=%g) %s %s: %g", transmission_info.joints[0].mechanical_reduction, arrow,
+        actuator_names[actuators[0]].c_str(), actuator_values[actuators[0]]);
+      continue;
+    }
+
+    record.append("\t");
+    for (const size_t joint : joints)
+    {
+      record.append("%s: %g ", joint_names[joint].c_str(), joint_values[joint]);
+    }
+    record.append("%s %s %s", arrow, transmission_info.name.c_str(), arrow);
+    for (const size_t actuator : actuators)
+    {
+      record.append(" %s: %g", actuator_names[actuator].c_str(), actuator_values[actuator]);
+    }
+  }
 }
 
 }  // namespace ros2_control_demo_example_8
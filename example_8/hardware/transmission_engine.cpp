@@ -0,0 +1,255 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ros2_control_demo_example_8/transmission_engine.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "transmission_interface/differential_transmission_loader.hpp"
+#include "transmission_interface/four_bar_linkage_transmission_loader.hpp"
+#include "transmission_interface/simple_transmission_loader.hpp"
+#include "transmission_interface/transmission.hpp"
+#include "transmission_interface/transmission_interface_exception.hpp"
+
+namespace ros2_control_demo_example_8
+{
+namespace
+{
+constexpr const char * QUANTITY_NAMES[TransmissionEngine::NUM_QUANTITIES] = {
+  hardware_interface::HW_IF_POSITION, hardware_interface::HW_IF_VELOCITY,
+  hardware_interface::HW_IF_EFFORT};
+
+std::shared_ptr<transmission_interface::Transmission> load(
+  const hardware_interface::TransmissionInfo & info)
+{
+  if (info.type == "transmission_interface/SimpleTransmission")
+  {
+    if (info.joints.size() != 1 || info.actuators.size() != 1)
+    {
+      throw transmission_interface::TransmissionInterfaceException(
+        "Simple transmission needs exactly one joint and one actuator");
+    }
+    return transmission_interface::SimpleTransmissionLoader().load(info);
+  }
+  if (info.type == "transmission_interface/DifferentialTransmission")
+  {
+    return transmission_interface::DifferentialTransmissionLoader().load(info);
+  }
+  if (info.type == "transmission_interface/FourBarLinkageTransmission")
+  {
+    return transmission_interface::FourBarLinkageTransmissionLoader().load(info);
+  }
+  throw transmission_interface::TransmissionInterfaceException(
+    "Transmission type '" + info.type + "' not supported");
+}
+
+/// y = matrix x + offset of one quantity and direction of a transmission, matrix is row-major.
+struct Affine
+{
+  std::vector<double> matrix;
+  std::vector<double> offset;
+};
+
+/**
+ * Finds the affine maps of a linear transmission by applying it to the zero vector, which gives
+ * the offsets, and to each unit vector, which gives a column of the matrix plus the offsets.
+ */
+class TransmissionProbe
+{
+public:
+  TransmissionProbe(
+    transmission_interface::Transmission & transmission,
+    const hardware_interface::TransmissionInfo & info)
+  : transmission_(transmission)
+  {
+    std::vector<transmission_interface::JointHandle> joint_handles;
+    std::vector<transmission_interface::ActuatorHandle> actuator_handles;
+    for (size_t q = 0; q < TransmissionEngine::NUM_QUANTITIES; q++)
+    {
+      // the handles point into the values, they must not be reallocated afterwards
+      joints_[q].resize(info.joints.size());
+      actuators_[q].resize(info.actuators.size());
+      for (size_t i = 0; i < info.joints.size(); i++)
+      {
+        joint_handles.emplace_back(info.joints[i].name, QUANTITY_NAMES[q], &joints_[q][i]);
+      }
+      for (size_t i = 0; i < info.actuators.size(); i++)
+      {
+        actuator_handles.emplace_back(info.actuators[i].name, QUANTITY_NAMES[q], &actuators_[q][i]);
+      }
+    }
+    transmission_.configure(joint_handles, actuator_handles);
+  }
+
+  Affine actuator_to_joint(size_t quantity)
+  {
+    return probe(
+      actuators_[quantity], joints_[quantity], [this]() { transmission_.actuator_to_joint(); });
+  }
+
+  Affine joint_to_actuator(size_t quantity)
+  {
+    return probe(
+      joints_[quantity], actuators_[quantity], [this]() { transmission_.joint_to_actuator(); });
+  }
+
+private:
+  template <typename Map>
+  static Affine probe(std::vector<double> & x, const std::vector<double> & y, Map && map)
+  {
+    Affine affine;
+    x.assign(x.size(), 0.0);
+    map();
+    affine.offset = y;
+    affine.matrix.resize(y.size() * x.size());
+    for (size_t column = 0; column < x.size(); column++)
+    {
+      x.assign(x.size(), 0.0);
+      x[column] = 1.0;
+      map();
+      for (size_t row = 0; row < y.size(); row++)
+      {
+        affine.matrix[row * x.size() + column] = y[row] - affine.offset[row];
+      }
+    }
+    return affine;
+  }
+
+  transmission_interface::Transmission & transmission_;
+  std::array<std::vector<double>, TransmissionEngine::NUM_QUANTITIES> joints_;
+  std::array<std::vector<double>, TransmissionEngine::NUM_QUANTITIES> actuators_;
+};
+
+void simple_map(
+  size_t n, const double * __restrict scales, const double * __restrict offsets,
+  const double * __restrict x, double * __restrict y)
+{
+  for (size_t i = 0; i < n; i++)
+  {
+    y[i] = scales[i] * x[i] + offsets[i];
+  }
+}
+
+void coupled_map(
+  size_t n, const double * __restrict m00, const double * __restrict m01,
+  const double * __restrict m10, const double * __restrict m11, const double * __restrict b0,
+  const double * __restrict b1, const double * __restrict x, double * __restrict y)
+{
+  for (size_t k = 0; k < n; k++)
+  {
+    const double x0 = x[2 * k];
+    const double x1 = x[2 * k + 1];
+    y[2 * k] = m00[k] * x0 + m01[k] * x1 + b0[k];
+    y[2 * k + 1] = m10[k] * x0 + m11[k] * x1 + b1[k];
+  }
+}
+}  // namespace
+
+void TransmissionEngine::add(const hardware_interface::TransmissionInfo & info)
+{
+  const bool simple = info.joints.size() == 1 && info.actuators.size() == 1;
+  if (!simple && !(info.joints.size() == 2 && info.actuators.size() == 2))
+  {
+    throw transmission_interface::TransmissionInterfaceException(
+      "Transmission needs one or two joints and as many actuators");
+  }
+  const auto transmission = load(info);
+  TransmissionProbe probe(*transmission, info);
+
+  // the maps of each quantity and direction go into the tables of the engine
+  const auto append = [simple](AffineMaps & maps, const Affine & affine)
+  {
+    if (simple)
+    {
+      maps.scales.push_back(affine.matrix[0]);
+      maps.offsets.push_back(affine.offset[0]);
+      return;
+    }
+    maps.m00.push_back(affine.matrix[0]);
+    maps.m01.push_back(affine.matrix[1]);
+    maps.m10.push_back(affine.matrix[2]);
+    maps.m11.push_back(affine.matrix[3]);
+    maps.b0.push_back(affine.offset[0]);
+    maps.b1.push_back(affine.offset[1]);
+  };
+  for (size_t q = 0; q < NUM_QUANTITIES; q++)
+  {
+    append(actuator_to_joint_[q], probe.actuator_to_joint(q));
+    append(joint_to_actuator_[q], probe.joint_to_actuator(q));
+  }
+
+  if (simple)
+  {
+    // insert behind the other simple transmissions, in front of the coupled ones
+    const size_t index = num_simple() - 1;
+    for (auto & transmission_index : index_)
+    {
+      for (auto & joint : transmission_index.joints)
+      {
+        joint += joint >= index ? 1 : 0;
+      }
+      for (auto & actuator : transmission_index.actuators)
+      {
+        actuator += actuator >= index ? 1 : 0;
+      }
+    }
+    index_.push_back({{index}, {index}});
+    joint_names_.insert(joint_names_.begin() + index, info.joints[0].name);
+    actuator_names_.insert(actuator_names_.begin() + index, info.actuators[0].name);
+    joint_transmissions_.insert(joint_transmissions_.begin() + index, index_.size() - 1);
+    actuator_transmissions_.insert(actuator_transmissions_.begin() + index, index_.size() - 1);
+    return;
+  }
+
+  TransmissionIndex transmission_index;
+  for (const auto & joint_info : info.joints)
+  {
+    transmission_index.joints.push_back(joint_names_.size());
+    joint_names_.push_back(joint_info.name);
+    joint_transmissions_.push_back(index_.size());
+  }
+  for (const auto & actuator_info : info.actuators)
+  {
+    transmission_index.actuators.push_back(actuator_names_.size());
+    actuator_names_.push_back(actuator_info.name);
+    actuator_transmissions_.push_back(index_.size());
+  }
+  index_.push_back(transmission_index);
+}
+
+void TransmissionEngine::actuator_to_joint(
+  Quantity quantity, const double * actuator_values, double * joint_values) const
+{
+  apply(actuator_to_joint_[static_cast<size_t>(quantity)], actuator_values, joint_values);
+}
+
+void TransmissionEngine::joint_to_actuator(
+  Quantity quantity, const double * joint_values, double * actuator_values) const
+{
+  apply(joint_to_actuator_[static_cast<size_t>(quantity)], joint_values, actuator_values);
+}
+
+void TransmissionEngine::apply(const AffineMaps & maps, const double * x, double * y)
+{
+  const size_t n = maps.scales.size();
+  simple_map(n, maps.scales.data(), maps.offsets.data(), x, y);
+  coupled_map(
+    maps.m00.size(), maps.m00.data(), maps.m01.data(), maps.m10.data(), maps.m11.data(),
+    maps.b0.data(), maps.b1.data(), x + n, y + n);
+}
+
+}  // namespace ros2_control_demo_example_8
@@ -0,0 +1,223 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "ros2_control_demo_example_8/transmission_engine.hpp"
+#include "transmission_interface/differential_transmission_loader.hpp"
+#include "transmission_interface/four_bar_linkage_transmission_loader.hpp"
+#include "transmission_interface/simple_transmission_loader.hpp"
+#include "transmission_interface/transmission_interface_exception.hpp"
+
+using ros2_control_demo_example_8::TransmissionEngine;
+
+namespace
+{
+constexpr TransmissionEngine::Quantity QUANTITIES[] = {
+  TransmissionEngine::Quantity::POSITION, TransmissionEngine::Quantity::VELOCITY,
+  TransmissionEngine::Quantity::EFFORT};
+constexpr const char * QUANTITY_NAMES[] = {
+  hardware_interface::HW_IF_POSITION, hardware_interface::HW_IF_VELOCITY,
+  hardware_interface::HW_IF_EFFORT};
+
+hardware_interface::TransmissionInfo make_info(
+  const std::string & name, const std::string & type, const std::vector<double> & reductions,
+  const std::vector<double> & offsets)
+{
+  hardware_interface::TransmissionInfo info;
+  info.name = name;
+  info.type = "transmission_interface/" + type;
+  for (size_t i = 0; i < reductions.size(); i++)
+  {
+    hardware_interface::JointInfo joint;
+    joint.name = name + "_joint" + std::to_string(i);
+    joint.mechanical_reduction = reductions[i];
+    joint.offset = offsets[i];
+    info.joints.push_back(joint);
+    hardware_interface::ActuatorInfo actuator;
+    actuator.name = name + "_actuator" + std::to_string(i);
+    actuator.mechanical_reduction = 1.5 + static_cast<double>(i);
+    info.actuators.push_back(actuator);
+  }
+  return info;
+}
+
+std::shared_ptr<transmission_interface::Transmission> load(
+  const hardware_interface::TransmissionInfo & info)
+{
+  if (info.type == "transmission_interface/DifferentialTransmission")
+  {
+    return transmission_interface::DifferentialTransmissionLoader().load(info);
+  }
+  if (info.type == "transmission_interface/FourBarLinkageTransmission")
+  {
+    return transmission_interface::FourBarLinkageTransmissionLoader().load(info);
+  }
+  return transmission_interface::SimpleTransmissionLoader().load(info);
+}
+
+// what the transmission of the transmission_interface computes from \p input of one quantity
+std::vector<double> reference(
+  const hardware_interface::TransmissionInfo & info, size_t quantity, bool actuator_to_joint,
+  const std::vector<double> & input)
+{
+  std::array<std::vector<double>, 3> joints;
+  std::array<std::vector<double>, 3> actuators;
+  std::vector<transmission_interface::JointHandle> joint_handles;
+  std::vector<transmission_interface::ActuatorHandle> actuator_handles;
+  for (size_t q = 0; q < 3; q++)
+  {
+    joints[q].resize(info.joints.size());
+    actuators[q].resize(info.actuators.size());
+    for (size_t i = 0; i < info.joints.size(); i++)
+    {
+      joint_handles.emplace_back(info.joints[i].name, QUANTITY_NAMES[q], &joints[q][i]);
+      actuator_handles.emplace_back(info.actuators[i].name, QUANTITY_NAMES[q], &actuators[q][i]);
+    }
+  }
+  const auto transmission = load(info);
+  transmission->configure(joint_handles, actuator_handles);
+  if (actuator_to_joint)
+  {
+    actuators[quantity] = input;
+    transmission->actuator_to_joint();
+    return joints[quantity];
+  }
+  joints[quantity] = input;
+  transmission->joint_to_actuator();
+  return actuators[quantity];
+}
+
+// picks the values of the joints or actuators at \p indices
+std::vector<double> pick(const std::vector<double> & values, const std::vector<size_t> & indices)
+{
+  std::vector<double> picked;
+  for (const size_t index : indices)
+  {
+    picked.push_back(values[index]);
+  }
+  return picked;
+}
+
+// compares every quantity in both directions with the transmission_interface
+void expect_matches_reference(
+  const TransmissionEngine & engine,
+  const std::vector<hardware_interface::TransmissionInfo> & infos)
+{
+  std::vector<double> inputs(engine.num_actuators());
+  for (size_t i = 0; i < inputs.size(); i++)
+  {
+    inputs[i] = 0.7 * static_cast<double>(i) - 2.0;
+  }
+  std::vector<double> outputs(engine.num_joints());
+  for (size_t q = 0; q < 3; q++)
+  {
+    engine.actuator_to_joint(QUANTITIES[q], inputs.data(), outputs.data());
+    for (size_t t = 0; t < infos.size(); t++)
+    {
+      const auto & index = engine.transmissions()[t];
+      const auto expected = reference(infos[t], q, true, pick(inputs, index.actuators));
+      const auto actual = pick(outputs, index.joints);
+      for (size_t i = 0; i < expected.size(); i++)
+      {
+        EXPECT_NEAR(actual[i], expected[i], 1e-12) << infos[t].name << " " << QUANTITY_NAMES[q];
+      }
+    }
+
+    engine.joint_to_actuator(QUANTITIES[q], inputs.data(), outputs.data());
+    for (size_t t = 0; t < infos.size(); t++)
+    {
+      const auto & index = engine.transmissions()[t];
+      const auto expected = reference(infos[t], q, false, pick(inputs, index.joints));
+      const auto actual = pick(outputs, index.actuators);
+      for (size_t i = 0; i < expected.size(); i++)
+      {
+        EXPECT_NEAR(actual[i], expected[i], 1e-12) << infos[t].name << " " << QUANTITY_NAMES[q];
+      }
+    }
+  }
+}
+}  // namespace
+
+TEST(TestTransmissionEngine, matches_simple_transmissions)
+{
+  TransmissionEngine engine;
+  std::vector<hardware_interface::TransmissionInfo> infos;
+  const std::vector<double> reductions = {2.0, -0.5, 100.0, 3.0, 7.0};
+  for (size_t i = 0; i < reductions.size(); i++)
+  {
+    infos.push_back(make_info(
+      "simple" + std::to_string(i), "SimpleTransmission", {reductions[i]},
+      {0.1 * static_cast<double>(i)}));
+    engine.add(infos.back());
+  }
+  ASSERT_EQ(engine.num_simple(), reductions.size());
+  ASSERT_EQ(engine.num_joints(), reductions.size());
+  expect_matches_reference(engine, infos);
+}
+
+TEST(TestTransmissionEngine, matches_coupled_transmissions)
+{
+  TransmissionEngine engine;
+  const std::vector<hardware_interface::TransmissionInfo> infos = {
+    make_info("wrist", "DifferentialTransmission", {2.0, 4.0}, {0.0, 0.5}),
+    make_info("elbow", "SimpleTransmission", {10.0}, {0.0}),
+    make_info("gripper", "FourBarLinkageTransmission", {3.0, -1.5}, {0.25, 0.0})};
+  for (const auto & info : infos)
+  {
+    engine.add(info);
+  }
+
+  // the simple transmission comes first, even though it was added later
+  ASSERT_EQ(engine.num_simple(), 1u);
+  ASSERT_EQ(engine.num_coupled(), 2u);
+  ASSERT_EQ(engine.num_joints(), 5u);
+  EXPECT_EQ(engine.joint_names()[0], "elbow_joint0");
+  EXPECT_EQ(engine.joint_names()[1], "wrist_joint0");
+  EXPECT_EQ(engine.actuator_names()[4], "gripper_actuator1");
+
+  // the index table follows the renumbering
+  ASSERT_EQ(engine.transmissions().size(), 3u);
+  EXPECT_EQ(engine.transmissions()[0].joints, (std::vector<size_t>{1, 2}));
+  EXPECT_EQ(engine.transmissions()[0].actuators, (std::vector<size_t>{1, 2}));
+  EXPECT_EQ(engine.transmissions()[1].joints, (std::vector<size_t>{0}));
+  EXPECT_EQ(engine.transmissions()[2].joints, (std::vector<size_t>{3, 4}));
+  EXPECT_EQ(engine.joint_transmission(0), 1u);
+  EXPECT_EQ(engine.joint_transmission(2), 0u);
+  EXPECT_EQ(engine.actuator_transmission(3), 2u);
+
+  expect_matches_reference(engine, infos);
+}
+
+TEST(TestTransmissionEngine, rejects_invalid_transmissions)
+{
+  TransmissionEngine engine;
+  EXPECT_THROW(
+    engine.add(make_info("gear", "CustomTransmission", {1.0}, {0.0})),
+    transmission_interface::TransmissionInterfaceException);
+  EXPECT_THROW(
+    engine.add(make_info("gear", "SimpleTransmission", {1.0, 1.0}, {0.0, 0.0})),
+    transmission_interface::TransmissionInterfaceException);
+  EXPECT_THROW(
+    engine.add(make_info("gear", "DifferentialTransmission", {1.0}, {0.0})),
+    transmission_interface::TransmissionInterfaceException);
+  EXPECT_EQ(engine.num_joints(), 0u);
+  EXPECT_EQ(engine.num_actuators(), 0u);
+}
@@ -0,0 +1,172 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "hardware_interface/handle.hpp"
+#include "hardware_interface/hardware_info.hpp"
+#include "hardware_interface/types/hardware_interface_type_values.hpp"
+#include "ros2_control_demo_utils/interface_handles.hpp"
+
+using hardware_interface::CommandInterface;
+using hardware_interface::StateInterface;
+using ros2_control_demo_utils::CommandHandle;
+using ros2_control_demo_utils::HandleResolver;
+using ros2_control_demo_utils::StateHandle;
+
+namespace
+{
+constexpr double SLOWDOWN = 50.0;
+
+template <typename InterfaceT>
+std::shared_ptr<InterfaceT> make_interface(const std::string & joint_name)
+{
+  hardware_interface::InterfaceInfo info;
+  info.name = hardware_interface::HW_IF_POSITION;
+  info.initial_value = "0.0";
+  info.data_type = "double";
+  return std::make_shared<InterfaceT>(hardware_interface::InterfaceDescription(joint_name, info));
+}
+
+/// The string-keyed accessors of a hardware component, i.e. a hash lookup per access.
+class NamedInterfaces
+{
+public:
+  NamedInterfaces(
+    const std::vector<StateInterface::SharedPtr> & states,
+    const std::vector<CommandInterface::SharedPtr> & commands)
+  {
+    for (const auto & state : states)
+    {
+      states_[state->get_name()] = state;
+    }
+    for (const auto & command : commands)
+    {
+      commands_[command->get_name()] = command;
+    }
+  }
+
+  double get_state(const std::string & name) const { return lookup(states_, name); }
+  double get_command(const std::string & name) const { return lookup(commands_, name); }
+  void set_state(const std::string & name, double value)
+  {
+    const auto it = states_.find(name);
+    if (it == states_.end())
+    {
+      throw std::runtime_error("unknown state interface " + name);
+    }
+    std::ignore = it->second->set_value(value);
+  }
+
+private:
+  template <typename MapT>
+  static double lookup(const MapT & interfaces, const std::string & name)
+  {
+    const auto it = interfaces.find(name);
+    if (it == interfaces.end())
+    {
+      throw std::runtime_error("unknown interface " + name);
+    }
+    return it->second->get_optional().value_or(0.0);
+  }
+
+  std::unordered_map<std::string, StateInterface::SharedPtr> states_;
+  std::unordered_map<std::string, CommandInterface::SharedPtr> commands_;
+};
+
+template <typename CycleT>
+double nanoseconds_per_cycle(size_t cycles, CycleT cycle)
+{
+  const auto begin = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < cycles; i++)
+  {
+    cycle();
+  }
+  const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+  return elapsed.count() / static_cast<double>(cycles);
+}
+}  // namespace
+
+// Compares one read() of a first-order position plant, as in the RRBot examples, through the
+// string-keyed get_state()/set_state() path and through handles resolved once.
+int main(int argc, char ** argv)
+{
+  const size_t cycles = argc > 1 ? std::stoul(argv[1]) : 10000;
+
+  std::printf("%8s %16s %16s %10s\n", "joints", "names [ns/cyc]", "handles [ns/cyc]", "speedup");
+  for (size_t num_joints : {size_t(6), size_t(64), size_t(512)})
+  {
+    std::vector<std::string> joint_names;
+    std::vector<StateInterface::SharedPtr> states;
+    std::vector<CommandInterface::SharedPtr> commands;
+    for (size_t i = 0; i < num_joints; i++)
+    {
+      joint_names.push_back("joint" + std::to_string(i + 1));
+      states.push_back(make_interface<StateInterface>(joint_names.back()));
+      commands.push_back(make_interface<CommandInterface>(joint_names.back()));
+      std::ignore = commands.back()->set_value(1.0);
+    }
+
+    NamedInterfaces named(states, commands);
+    const double by_name = nanoseconds_per_cycle(
+      cycles,
+      [&]()
+      {
+        for (const auto & joint_name : joint_names)
+        {
+          const auto name = joint_name + "/" + hardware_interface::HW_IF_POSITION;
+          const double state = named.get_state(name);
+          named.set_state(name, state + (named.get_command(name) - state) / SLOWDOWN);
+        }
+      });
+
+    HandleResolver resolver;
+    resolver.add_states(states);
+    resolver.add_commands(commands);
+    std::vector<StateHandle> state_handles(num_joints);
+    std::vector<CommandHandle> command_handles(num_joints);
+    for (size_t i = 0; i < num_joints; i++)
+    {
+      const auto name = joint_names[i] + "/" + hardware_interface::HW_IF_POSITION;
+      if (
+        !resolver.resolve_state(name, state_handles[i]) ||
+        !resolver.resolve_command(name, command_handles[i]))
+      {
+        std::fprintf(stderr, "Can't resolve '%s'.\n", name.c_str());
+        return 1;
+      }
+    }
+    const double by_handle = nanoseconds_per_cycle(
+      cycles,
+      [&]()
+      {
+        for (size_t i = 0; i < num_joints; i++)
+        {
+          const double state = state_handles[i].get();
+          std::ignore = state_handles[i].set(state + (command_handles[i].get() - state) / SLOWDOWN);
+        }
+      });
+
+    std::printf(
+      "%8zu %16.0f %16.0f %10.1f\n", num_joints, by_name, by_handle, by_name / by_handle);
+  }
+  return 0;
+}
@@ -0,0 +1,186 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS2_CONTROL_DEMO_UTILS__CYCLE_INSTRUMENTATION_HPP_
+#define ROS2_CONTROL_DEMO_UTILS__CYCLE_INSTRUMENTATION_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "hardware_interface/hardware_info.hpp"
+#include "ros2_control_demo_utils/interface_handles.hpp"
+
+namespace ros2_control_demo_utils
+{
+/**
+ * Histogram of durations in nanoseconds with the log-linear buckets of HdrHistogram.
+ *
+ * Each power of two is split into SUB_BUCKETS buckets, so a value is known to about 3 %. Values
+ * up to 2^MAX_VALUE_BITS ns (about 68 s) fit into the fixed number of buckets, larger values are
+ * counted in the last one.
+ *
+ * One thread records without locks or allocations, any thread may read concurrently and sees
+ * each counter either before or after a concurrent update.
+ */
+class LatencyHistogram
+{
+public:
+  static constexpr unsigned SUB_BUCKET_BITS = 5;
+  static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+  static constexpr unsigned MAX_VALUE_BITS = 36;
+  static constexpr size_t NUM_BUCKETS = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+  /// Adds \p nanoseconds, realtime safe. Only one thread may record.
+  void record(uint64_t nanoseconds);
+
+  /// Forgets all values, must not run concurrently with record().
+  void reset();
+
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+  /// \return 0 if nothing was recorded
+  uint64_t min() const;
+  uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+  /**
+   * Values that \p quantiles of all values don't exceed, e.g. 0.99 for p99, in one pass.
+   *
+   * \p quantiles have to be ascending. The values are the upper bounds of their buckets, clamped
+   * to max(). Realtime safe but proportional to NUM_BUCKETS.
+   */
+  void values_at_quantiles(const double * quantiles, uint64_t * values, size_t size) const;
+
+  static size_t bucket_index(uint64_t value);
+  static uint64_t bucket_upper_bound(size_t index);
+
+private:
+  std::array<std::atomic<uint64_t>, NUM_BUCKETS> counts_{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> min_{UINT64_MAX};
+  std::atomic<uint64_t> max_{0};
+};
+
+/// Summary of one histogram in seconds.
+struct LatencySummary
+{
+  uint64_t count = 0;
+  double min = 0.0;
+  double max = 0.0;
+  double p99 = 0.0;
+  double p99_9 = 0.0;
+};
+
+/**
+ * Measures read() and write() of a hardware component.
+ *
+ * A component keeps one as a member and times read() and write() with the scoped timers:
+ *
+ * \code
+ *   hardware_interface::return_type MyHardware::read(...)
+ *   {
+ *     const auto timer = instrumentation_.time_read();
+ *     ...
+ *   }
+ * \endcode
+ *
+ * Durations are taken from the monotonic steady clock and recorded in histograms of how long
+ * read() and write() take and of the period jitter, i.e. how far the time between two read()
+ * calls is off the period of the rate given to configure(). Their minimum, maximum, p99 and
+ * p99.9 in seconds are exported as state interfaces "<prefix>/read_duration_p99" etc., which
+ * are refreshed at most every 100 ms after write(). All of them are also available to other
+ * threads through summary(), e.g. for diagnostics.
+ */
+class CycleInstrumentation
+{
+public:
+  enum Metric : size_t
+  {
+    READ_DURATION,
+    WRITE_DURATION,
+    PERIOD_JITTER,
+    NUM_METRICS,
+  };
+
+  /// Stops timing when destroyed.
+  class ScopedTimer
+  {
+  public:
+    ScopedTimer(CycleInstrumentation & instrumentation, Metric metric);
+    ~ScopedTimer();
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer & operator=(const ScopedTimer &) = delete;
+
+  private:
+    CycleInstrumentation & instrumentation_;
+    Metric metric_;
+    std::chrono::steady_clock::time_point begin_;
+  };
+
+  /**
+   * Sets \p prefix of the state interfaces, e.g. the name of the component, and the rate of
+   * read() and write() in Hz, e.g. rw_rate of the hardware info. Without a rate, the jitter is
+   * not measured. Not realtime safe.
+   */
+  void configure(const std::string & prefix, double rate);
+
+  /// The state interfaces to return from export_unlisted_state_interface_descriptions().
+  std::vector<hardware_interface::InterfaceDescription> state_interface_descriptions() const;
+
+  /// Looks up the exported state interfaces, e.g. from unlisted_states_, in on_configure().
+  bool resolve_state_interfaces(const HandleResolver & resolver);
+
+  /// Forgets all measurements, e.g. in on_activate().
+  void reset();
+
+  /// Times read() until the returned timer is destroyed, realtime safe.
+  ScopedTimer time_read() { return ScopedTimer(*this, READ_DURATION); }
+
+  /// Times write() until the returned timer is destroyed, realtime safe.
+  ScopedTimer time_write() { return ScopedTimer(*this, WRITE_DURATION); }
+
+  const LatencyHistogram & histogram(Metric metric) const { return histograms_[metric]; }
+
+  /// Thread safe summary of \p metric.
+  LatencySummary summary(Metric metric) const;
+
+  /// Name of \p metric in the state interfaces, e.g. "read_duration".
+  static const char * metric_name(Metric metric);
+
+  /// Expected period in seconds, 0 if configured without a rate.
+  double expected_period() const { return std::chrono::duration<double>(period_).count(); }
+
+private:
+  void begin(Metric metric, std::chrono::steady_clock::time_point now);
+  void end(Metric metric, std::chrono::steady_clock::time_point begin);
+  void export_state_interfaces(std::chrono::steady_clock::time_point now);
+
+  std::string prefix_;
+  std::chrono::steady_clock::duration period_{0};
+  std::array<LatencyHistogram, NUM_METRICS> histograms_;
+  std::chrono::steady_clock::time_point previous_read_{};
+  std::chrono::steady_clock::time_point next_export_{};
+
+  // min, max, p99 and p99.9 of each metric
+  static constexpr size_t NUM_STATISTICS = 4;
+  std::array<StateHandle, NUM_METRICS * NUM_STATISTICS> state_handles_;
+  bool has_state_handles_ = false;
+};
+
+}  // namespace ros2_control_demo_utils
+
+#endif  // ROS2_CONTROL_DEMO_UTILS__CYCLE_INSTRUMENTATION_HPP_
@@ -0,0 +1,103 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS2_CONTROL_DEMO_UTILS__INTERFACE_HANDLES_HPP_
+#define ROS2_CONTROL_DEMO_UTILS__INTERFACE_HANDLES_HPP_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "hardware_interface/handle.hpp"
+
+namespace ros2_control_demo_utils
+{
+/**
+ * State or command interface of a hardware component that was looked up once by name.
+ *
+ * get_state() and set_state() of a hardware component build the interface name and hash it in
+ * every call. A handle refers to the interface directly, so reading and writing it in read() and
+ * write() costs no more than the lock of the interface itself.
+ */
+template <typename InterfaceT>
+class InterfaceHandle
+{
+public:
+  InterfaceHandle() = default;
+  explicit InterfaceHandle(InterfaceT * interface)
+  : interface_(interface), last_value_(interface->get_optional().value_or(0.0))
+  {
+  }
+
+  bool valid() const { return interface_ != nullptr; }
+  const std::string & name() const { return interface_->get_name(); }
+
+  /// Returns the value, or the value read last if another thread holds the interface.
+  double get() const
+  {
+    const auto value = interface_->get_optional();
+    if (value)
+    {
+      last_value_ = *value;
+    }
+    return last_value_;
+  }
+
+  /// Sets the value, returns false if another thread holds the interface.
+  bool set(double value)
+  {
+    last_value_ = value;
+    return interface_->set_value(value);
+  }
+
+private:
+  InterfaceT * interface_ = nullptr;
+  mutable double last_value_ = 0.0;
+};
+
+using StateHandle = InterfaceHandle<hardware_interface::StateInterface>;
+using CommandHandle = InterfaceHandle<hardware_interface::CommandInterface>;
+
+/**
+ * Looks up the interfaces exported by a hardware component by their full names, e.g.
+ * "joint1/position".
+ *
+ * The interfaces are exported when the component is loaded, so the handles are resolved in
+ * on_configure(). Nothing here is realtime safe. The handles stay valid as long as the component
+ * holds the exported interfaces.
+ */
+class HandleResolver
+{
+public:
+  /// Indexes \p states, e.g. joint_states_ or sensor_states_ of the component.
+  void add_states(const std::vector<hardware_interface::StateInterface::SharedPtr> & states);
+
+  /// Indexes \p commands, e.g. joint_commands_ or gpio_commands_ of the component.
+  void add_commands(const std::vector<hardware_interface::CommandInterface::SharedPtr> & commands);
+
+  /// \return false if there is no state interface \p name
+  bool resolve_state(const std::string & name, StateHandle & handle) const;
+
+  /// \return false if there is no command interface \p name
+  bool resolve_command(const std::string & name, CommandHandle & handle) const;
+
+private:
+  std::unordered_map<std::string, hardware_interface::StateInterface *> states_;
+  std::unordered_map<std::string, hardware_interface::CommandInterface *> commands_;
+};
+
+}  // namespace ros2_control_demo_utils
+
+#endif  // ROS2_CONTROL_DEMO_UTILS__INTERFACE_HANDLES_HPP_
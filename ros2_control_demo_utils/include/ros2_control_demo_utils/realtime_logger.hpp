@@ -0,0 +1,246 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS2_CONTROL_DEMO_UTILS__REALTIME_LOGGER_HPP_
+#define ROS2_CONTROL_DEMO_UTILS__REALTIME_LOGGER_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "rclcpp/logger.hpp"
+
+namespace ros2_control_demo_utils
+{
+enum class LogSeverity : uint8_t
+{
+  DEBUG,
+  INFO,
+  WARN,
+  ERROR,
+  FATAL,
+};
+
+/// Argument of a log message, stored by value until the message is formatted.
+struct LogArg
+{
+  enum class Type : uint8_t
+  {
+    INTEGER,
+    FLOATING,
+    STRING,
+  };
+
+  Type type;
+  union
+  {
+    int64_t integer;
+    double floating;
+    /// has to stay valid until the record is formatted, e.g. a literal or a joint name
+    const char * string;
+  };
+};
+
+/**
+ * Unformatted log message: a sequence of printf-style format strings with their arguments.
+ *
+ * The format strings are not copied and have to be literals.
+ */
+struct LogRecord
+{
+  static constexpr size_t MAX_SEGMENTS = 16;
+  static constexpr size_t MAX_ARGS = 4;
+
+  struct Segment
+  {
+    const char * format;
+    uint8_t num_args;
+    LogArg args[MAX_ARGS];
+  };
+
+  LogSeverity severity = LogSeverity::INFO;
+  uint8_t num_segments = 0;
+  /// set if segments did not fit and were dropped
+  bool truncated = false;
+  Segment segments[MAX_SEGMENTS];
+};
+
+/// Formats \p record like printf would, supports the conversions d, i, u, x, f, e, g and s.
+std::string format_record(const LogRecord & record);
+
+/**
+ * Rate limit of a log statement, the equivalent of RCLCPP_*_THROTTLE.
+ *
+ * The decision is made before anything is formatted or even recorded.
+ */
+class LogThrottle
+{
+public:
+  explicit LogThrottle(std::chrono::milliseconds period) : period_(period) {}
+
+  /// Returns true at most once per period.
+  bool ready(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now())
+  {
+    if (now < next_)
+    {
+      return false;
+    }
+    next_ = now + period_;
+    return true;
+  }
+
+private:
+  std::chrono::steady_clock::duration period_;
+  std::chrono::steady_clock::time_point next_{};
+};
+
+/**
+ * Logging for read() and write() of hardware components and other realtime code.
+ *
+ * Records are written into a preallocated single-producer single-consumer ring. Formatting and
+ * the actual logging happen in a drain thread shared by all loggers of the process, so the
+ * producer never allocates, formats or blocks. When the ring is full, records are dropped and
+ * counted.
+ *
+ * A record is only reserved in the ring when it is committed, so at most one RecordBuilder of a
+ * logger may be alive at a time. Commit or discard() a record before starting the next one.
+ *
+ * \code
+ * if (auto record = rt_logger_.record(LogSeverity::INFO, read_log_throttle_))
+ * {
+ *   record.append("Reading states:");
+ *   record.append("\n\t%.2f for joint '%s'", value, name.c_str());
+ * }  // committed here
+ * \endcode
+ */
+class RealtimeLogger
+{
+public:
+  /// Record under construction, committed to the ring when it goes out of scope.
+  class RecordBuilder
+  {
+  public:
+    RecordBuilder(const RecordBuilder &) = delete;
+    RecordBuilder & operator=(const RecordBuilder &) = delete;
+    RecordBuilder(RecordBuilder && other) noexcept;
+    ~RecordBuilder();
+
+    /// false if the record was throttled or the ring is full, appending is a no-op then
+    explicit operator bool() const { return record_ != nullptr; }
+
+    /// Drops the record instead of committing it, e.g. when leaving a cycle early.
+    void discard() { record_ = nullptr; }
+
+    /// Adds \p format with up to LogRecord::MAX_ARGS numbers or C strings.
+    template <typename... Args>
+    void append(const char * format, Args... args)
+    {
+      static_assert(sizeof...(Args) <= LogRecord::MAX_ARGS, "too many arguments");
+      if (record_ == nullptr)
+      {
+        return;
+      }
+      if (record_->num_segments == LogRecord::MAX_SEGMENTS)
+      {
+        record_->truncated = true;
+        return;
+      }
+      auto & segment = record_->segments[record_->num_segments++];
+      segment.format = format;
+      segment.num_args = 0;
+      (store(segment.args[segment.num_args++], args), ...);
+    }
+
+  private:
+    friend class RealtimeLogger;
+    RecordBuilder(RealtimeLogger * logger, LogRecord * record) : logger_(logger), record_(record)
+    {
+    }
+
+    template <typename T>
+    static void store(LogArg & arg, T value)
+    {
+      if constexpr (std::is_floating_point_v<T>)
+      {
+        arg.type = LogArg::Type::FLOATING;
+        arg.floating = static_cast<double>(value);
+      }
+      else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+      {
+        arg.type = LogArg::Type::INTEGER;
+        arg.integer = static_cast<int64_t>(value);
+      }
+      else
+      {
+        static_assert(
+          std::is_same_v<T, const char *> || std::is_same_v<T, char *>,
+          "only numbers and C strings can be logged");
+        arg.type = LogArg::Type::STRING;
+        arg.string = value;
+      }
+    }
+
+    RealtimeLogger * logger_;
+    LogRecord * record_;
+  };
+
+  RealtimeLogger() = default;
+  RealtimeLogger(const RealtimeLogger &) = delete;
+  RealtimeLogger & operator=(const RealtimeLogger &) = delete;
+  /// Formats the remaining records and detaches from the drain thread.
+  ~RealtimeLogger();
+
+  /**
+   * Allocates the ring for \p capacity records and attaches to the drain thread, not realtime safe.
+   *
+   * Records are logged to \p logger.
+   */
+  void configure(const rclcpp::Logger & logger, size_t capacity = 64);
+
+  /// Starts a record, realtime safe. Check the result before appending, and commit or discard the
+  /// record of before first.
+  RecordBuilder record(LogSeverity severity);
+
+  /// Starts a record unless \p throttle suppresses it, realtime safe.
+  RecordBuilder record(LogSeverity severity, LogThrottle & throttle)
+  {
+    return throttle.ready() ? record(severity) : RecordBuilder(this, nullptr);
+  }
+
+  /// Formats and logs all committed records, not realtime safe. Called by the drain thread.
+  void drain();
+
+  /// number of records dropped because the ring was full
+  size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+  void commit();
+  void detach();
+
+  rclcpp::Logger logger_ = rclcpp::get_logger("realtime_logger");
+  std::vector<LogRecord> ring_;
+  std::atomic<size_t> write_{0};
+  std::atomic<size_t> read_{0};
+  std::atomic<size_t> dropped_{0};
+  size_t reported_dropped_ = 0;
+  bool attached_ = false;
+};
+
+}  // namespace ros2_control_demo_utils
+
+#endif  // ROS2_CONTROL_DEMO_UTILS__REALTIME_LOGGER_HPP_
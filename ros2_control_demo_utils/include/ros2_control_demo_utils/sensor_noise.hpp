@@ -0,0 +1,81 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS2_CONTROL_DEMO_UTILS__SENSOR_NOISE_HPP_
+#define ROS2_CONTROL_DEMO_UTILS__SENSOR_NOISE_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace ros2_control_demo_utils
+{
+/// Noise of one channel of a simulated sensor, all zero for a perfect sensor.
+struct NoiseModel
+{
+  /// standard deviation of the white Gaussian noise
+  double stddev = 0.0;
+  /// standard deviation of the random walk of the bias after one second
+  double bias_drift = 0.0;
+  /// resolution the measurement is rounded to, 0 for a continuous measurement
+  double resolution = 0.0;
+};
+
+/**
+ * Noise of the channels of simulated sensors, e.g. the six axes of a force-torque sensor.
+ *
+ * The random numbers are counter-based: the n-th Gaussian sample of a channel is a hash of the
+ * seed, the channel and n. Nothing is reseeded, the same seed always produces the same
+ * measurements, and the channels don't depend on each other, so a batch of samples for all
+ * channels is computed in loops over contiguous arrays that the compiler vectorizes.
+ */
+class SensorNoise
+{
+public:
+  /// Number of channels of a wrench: force x, y, z and torque x, y, z.
+  static constexpr size_t WRENCH_SIZE = 6;
+
+  /// Allocates \p num_channels perfect channels and restarts at \p seed, not realtime safe.
+  void configure(size_t num_channels, uint64_t seed);
+
+  /// Sets the noise of \p channel and resets its bias.
+  void set_model(size_t channel, const NoiseModel & model);
+
+  size_t size() const { return stddevs_.size(); }
+  const double * biases() const { return biases_.data(); }
+
+  /**
+   * Turns the true values of all channels in \p values into measurements, realtime safe.
+   *
+   * The biases drift for \p dt seconds before they are added.
+   */
+  void apply(double * values, double dt);
+
+private:
+  uint64_t seed_ = 0;
+  uint64_t counter_ = 0;
+
+  std::vector<double> stddevs_;
+  std::vector<double> bias_drifts_;
+  std::vector<double> resolutions_;
+  std::vector<double> biases_;
+
+  // two Gaussian samples per channel of the current batch
+  std::vector<double> white_noise_;
+  std::vector<double> drift_noise_;
+};
+
+}  // namespace ros2_control_demo_utils
+
+#endif  // ROS2_CONTROL_DEMO_UTILS__SENSOR_NOISE_HPP_
@@ -0,0 +1,87 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS2_CONTROL_DEMO_UTILS__SIMULATED_ACTUATOR_BANK_HPP_
+#define ROS2_CONTROL_DEMO_UTILS__SIMULATED_ACTUATOR_BANK_HPP_
+
+#include <stddef.h>
+#include <vector>
+
+#include "ros2_control_demo_utils/interface_handles.hpp"
+
+namespace ros2_control_demo_utils
+{
+enum class ActuatorModel
+{
+  /// the position follows the command with a first-order lag, velocity and acceleration are zero
+  POSITION,
+  /// the velocity is the command, the position integrates it
+  VELOCITY,
+  /// the acceleration is the command, velocity and position integrate it
+  ACCELERATION,
+};
+
+/**
+ * Simulated actuators of a mock hardware component.
+ *
+ * Commands, positions, velocities and accelerations of all joints are stored in one contiguous
+ * array each. The model of a joint only selects coefficients of one common update, so step()
+ * is a single loop without branches that the compiler vectorizes.
+ *
+ * All models are slowed down by the same factor like the RRBot examples: the lag of the position
+ * model closes 1 / slowdown of the error per step, the integrators integrate period / slowdown.
+ */
+class SimulatedActuatorBank
+{
+public:
+  /// Allocates \p num_joints actuators of \p model at rest at zero, not realtime safe.
+  void resize(size_t num_joints, double slowdown, ActuatorModel model = ActuatorModel::POSITION);
+
+  /// Changes the model of \p joint, the state of the joint is kept.
+  void set_model(size_t joint, ActuatorModel model);
+
+  size_t size() const { return commands_.size(); }
+
+  double * commands() { return commands_.data(); }
+  const double * commands() const { return commands_.data(); }
+  const double * positions() const { return positions_.data(); }
+  const double * velocities() const { return velocities_.data(); }
+  const double * accelerations() const { return accelerations_.data(); }
+
+  /// Advances all actuators by \p period seconds.
+  void step(double period);
+
+  /// Copies the commands from \p handles, one per joint.
+  void read_commands(const std::vector<CommandHandle> & handles);
+
+  /// Copies the positions to \p handles, one per joint.
+  void write_positions(std::vector<StateHandle> & handles) const;
+
+private:
+  double slowdown_ = 1.0;
+  std::vector<double> commands_;
+  std::vector<double> positions_;
+  std::vector<double> velocities_;
+  std::vector<double> accelerations_;
+
+  // coefficients selecting the model of each joint
+  std::vector<double> lag_gains_;
+  std::vector<double> velocity_selects_;
+  std::vector<double> acceleration_selects_;
+  std::vector<double> integrate_selects_;
+};
+
+}  // namespace ros2_control_demo_utils
+
+#endif  // ROS2_CONTROL_DEMO_UTILS__SIMULATED_ACTUATOR_BANK_HPP_
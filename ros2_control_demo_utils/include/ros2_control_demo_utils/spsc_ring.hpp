@@ -0,0 +1,108 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ROS2_CONTROL_DEMO_UTILS__SPSC_RING_HPP_
+#define ROS2_CONTROL_DEMO_UTILS__SPSC_RING_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+namespace ros2_control_demo_utils
+{
+/**
+ * Lock-free ring buffer from one producer thread to one consumer thread.
+ *
+ * Every element pushed is popped exactly once and in order, none is torn. If the consumer falls
+ * behind and the ring is full, new elements are dropped and counted instead of overwriting ones
+ * the consumer may be reading. push() and pop() are wait-free and don't allocate, so both ends
+ * may be realtime threads, e.g. a thread receiving from a socket and read() of a hardware
+ * component.
+ */
+template <typename T>
+class SpscRing
+{
+public:
+  /// Allocates room for at least \p capacity elements, not thread safe.
+  explicit SpscRing(size_t capacity = 1024) { reset(capacity); }
+
+  /// Reallocates and empties the ring, no thread may push or pop meanwhile.
+  void reset(size_t capacity)
+  {
+    size_t size = 2;
+    while (size < capacity + 1)
+    {
+      size *= 2;
+    }
+    elements_.assign(size, T{});
+    mask_ = size - 1;
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+    dropped_.store(0, std::memory_order_relaxed);
+  }
+
+  /// Appends \p element, producer only. \return false if the ring is full and it was dropped
+  bool push(const T & element)
+  {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t next = (tail + 1) & mask_;
+    if (next == head_.load(std::memory_order_acquire))
+    {
+      dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    elements_[tail] = element;
+    tail_.store(next, std::memory_order_release);
+    return true;
+  }
+
+  /// Takes the oldest element, consumer only. \return false if the ring is empty
+  bool pop(T & element)
+  {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+    element = elements_[head];
+    head_.store((head + 1) & mask_, std::memory_order_release);
+    return true;
+  }
+
+  /// Number of elements the ring holds, exact only for the producer or consumer.
+  size_t size() const
+  {
+    return (tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire)) & mask_;
+  }
+
+  bool empty() const { return size() == 0; }
+  size_t capacity() const { return mask_; }
+
+  /// Number of elements dropped by push() because the ring was full.
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+  std::vector<T> elements_;
+  size_t mask_ = 0;
+
+  // each index is written by one thread only, keep them on separate cache lines
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+  std::atomic<uint64_t> dropped_{0};
+};
+
+}  // namespace ros2_control_demo_utils
+
+#endif  // ROS2_CONTROL_DEMO_UTILS__SPSC_RING_HPP_
@@ -0,0 +1,266 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ros2_control_demo_utils/cycle_instrumentation.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace ros2_control_demo_utils
+{
+namespace
+{
+constexpr std::chrono::milliseconds EXPORT_PERIOD(100);
+constexpr double QUANTILES[] = {0.99, 0.999};
+constexpr const char * STATISTIC_NAMES[] = {"min", "max", "p99", "p99_9"};
+
+/// Index of the highest set bit, \p value must not be 0.
+unsigned highest_bit(uint64_t value)
+{
+  unsigned bit = 0;
+  for (unsigned shift = 32; shift > 0; shift /= 2)
+  {
+    if (value >> shift)
+    {
+      value >>= shift;
+      bit += shift;
+    }
+  }
+  return bit;
+}
+
+uint64_t nanoseconds(std::chrono::steady_clock::duration duration)
+{
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+
+double seconds(uint64_t nanoseconds) { return static_cast<double>(nanoseconds) * 1e-9; }
+
+void increment(std::atomic<uint64_t> & counter)
+{
+  // single writer, so a plain load and store suffice and avoid a locked instruction
+  counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+}  // namespace
+
+size_t LatencyHistogram::bucket_index(uint64_t value)
+{
+  if (value < 2 * SUB_BUCKETS)
+  {
+    return static_cast<size_t>(value);
+  }
+  const unsigned shift = highest_bit(value) - SUB_BUCKET_BITS;
+  // value >> shift is in [SUB_BUCKETS, 2 * SUB_BUCKETS)
+  const size_t index = shift * SUB_BUCKETS + static_cast<size_t>(value >> shift);
+  return std::min(index, NUM_BUCKETS - 1);
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(size_t index)
+{
+  if (index < 2 * SUB_BUCKETS)
+  {
+    return index;
+  }
+  const unsigned shift = static_cast<unsigned>(index / SUB_BUCKETS) - 1;
+  const uint64_t lower_bound = static_cast<uint64_t>(index % SUB_BUCKETS + SUB_BUCKETS) << shift;
+  return lower_bound + (uint64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds)
+{
+  increment(counts_[bucket_index(nanoseconds)]);
+  increment(count_);
+  if (nanoseconds < min_.load(std::memory_order_relaxed))
+  {
+    min_.store(nanoseconds, std::memory_order_relaxed);
+  }
+  if (nanoseconds > max_.load(std::memory_order_relaxed))
+  {
+    max_.store(nanoseconds, std::memory_order_relaxed);
+  }
+}
+
+void LatencyHistogram::reset()
+{
+  for (auto & count : counts_)
+  {
+    count.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  min_.store(UINT64_MAX, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::min() const
+{
+  const uint64_t min = min_.load(std::memory_order_relaxed);
+  return min == UINT64_MAX ? 0 : min;
+}
+
+void LatencyHistogram::values_at_quantiles(
+  const double * quantiles, uint64_t * values, size_t size) const
+{
+  const uint64_t count = this->count();
+  const uint64_t max = this->max();
+  size_t next = 0;
+  uint64_t seen = 0;
+  for (size_t index = 0; index < NUM_BUCKETS && next < size; index++)
+  {
+    seen += counts_[index].load(std::memory_order_relaxed);
+    while (
+      next < size && static_cast<double>(seen) >= quantiles[next] * static_cast<double>(count))
+    {
+      values[next++] = std::min(bucket_upper_bound(index), max);
+    }
+  }
+  // counters read while they were updated may not add up to count
+  for (; next < size; next++)
+  {
+    values[next] = max;
+  }
+}
+
+CycleInstrumentation::ScopedTimer::ScopedTimer(
+  CycleInstrumentation & instrumentation, Metric metric)
+: instrumentation_(instrumentation), metric_(metric), begin_(std::chrono::steady_clock::now())
+{
+  instrumentation_.begin(metric_, begin_);
+}
+
+CycleInstrumentation::ScopedTimer::~ScopedTimer() { instrumentation_.end(metric_, begin_); }
+
+void CycleInstrumentation::configure(const std::string & prefix, double rate)
+{
+  prefix_ = prefix;
+  period_ = rate > 0.0 ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                           std::chrono::duration<double>(1.0 / rate))
+                       : std::chrono::steady_clock::duration(0);
+}
+
+std::vector<hardware_interface::InterfaceDescription>
+CycleInstrumentation::state_interface_descriptions() const
+{
+  std::vector<hardware_interface::InterfaceDescription> descriptions;
+  for (size_t metric = 0; metric < NUM_METRICS; metric++)
+  {
+    for (const char * statistic : STATISTIC_NAMES)
+    {
+      hardware_interface::InterfaceInfo info;
+      info.name = std::string(metric_name(static_cast<Metric>(metric))) + "_" + statistic;
+      info.initial_value = "0.0";
+      info.data_type = "double";
+      descriptions.emplace_back(prefix_, info);
+    }
+  }
+  return descriptions;
+}
+
+bool CycleInstrumentation::resolve_state_interfaces(const HandleResolver & resolver)
+{
+  const auto descriptions = state_interface_descriptions();
+  for (size_t i = 0; i < descriptions.size(); i++)
+  {
+    const auto name = descriptions[i].prefix_name + "/" + descriptions[i].interface_info.name;
+    if (!resolver.resolve_state(name, state_handles_[i]))
+    {
+      has_state_handles_ = false;
+      return false;
+    }
+  }
+  has_state_handles_ = true;
+  return true;
+}
+
+void CycleInstrumentation::reset()
+{
+  for (auto & histogram : histograms_)
+  {
+    histogram.reset();
+  }
+  previous_read_ = {};
+  next_export_ = {};
+}
+
+LatencySummary CycleInstrumentation::summary(Metric metric) const
+{
+  const auto & histogram = histograms_[metric];
+  uint64_t quantiles[2];
+  histogram.values_at_quantiles(QUANTILES, quantiles, 2);
+
+  LatencySummary summary;
+  summary.count = histogram.count();
+  summary.min = seconds(histogram.min());
+  summary.max = seconds(histogram.max());
+  summary.p99 = seconds(quantiles[0]);
+  summary.p99_9 = seconds(quantiles[1]);
+  return summary;
+}
+
+const char * CycleInstrumentation::metric_name(Metric metric)
+{
+  switch (metric)
+  {
+    case READ_DURATION:
+      return "read_duration";
+    case WRITE_DURATION:
+      return "write_duration";
+    case PERIOD_JITTER:
+      return "period_jitter";
+    default:
+      return "unknown";
+  }
+}
+
+void CycleInstrumentation::begin(Metric metric, std::chrono::steady_clock::time_point now)
+{
+  if (metric != READ_DURATION)
+  {
+    return;
+  }
+  if (period_.count() > 0 && previous_read_ != std::chrono::steady_clock::time_point{})
+  {
+    const auto period = now - previous_read_;
+    const auto jitter = period > period_ ? period - period_ : period_ - period;
+    histograms_[PERIOD_JITTER].record(nanoseconds(jitter));
+  }
+  previous_read_ = now;
+}
+
+void CycleInstrumentation::end(Metric metric, std::chrono::steady_clock::time_point begin)
+{
+  const auto now = std::chrono::steady_clock::now();
+  histograms_[metric].record(nanoseconds(now - begin));
+  if (metric == WRITE_DURATION && has_state_handles_ && now >= next_export_)
+  {
+    export_state_interfaces(now);
+  }
+}
+
+void CycleInstrumentation::export_state_interfaces(std::chrono::steady_clock::time_point now)
+{
+  next_export_ = now + EXPORT_PERIOD;
+  for (size_t metric = 0; metric < NUM_METRICS; metric++)
+  {
+    const auto summary = this->summary(static_cast<Metric>(metric));
+    const double values[NUM_STATISTICS] = {summary.min, summary.max, summary.p99, summary.p99_9};
+    for (size_t statistic = 0; statistic < NUM_STATISTICS; statistic++)
+    {
+      state_handles_[metric * NUM_STATISTICS + statistic].set(values[statistic]);
+    }
+  }
+}
+
+}  // namespace ros2_control_demo_utils
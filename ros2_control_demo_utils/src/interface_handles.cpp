@@ -0,0 +1,59 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ros2_control_demo_utils/interface_handles.hpp"
+
+namespace ros2_control_demo_utils
+{
+void HandleResolver::add_states(
+  const std::vector<hardware_interface::StateInterface::SharedPtr> & states)
+{
+  for (const auto & state : states)
+  {
+    states_[state->get_name()] = state.get();
+  }
+}
+
+void HandleResolver::add_commands(
+  const std::vector<hardware_interface::CommandInterface::SharedPtr> & commands)
+{
+  for (const auto & command : commands)
+  {
+    commands_[command->get_name()] = command.get();
+  }
+}
+
+bool HandleResolver::resolve_state(const std::string & name, StateHandle & handle) const
+{
+  const auto it = states_.find(name);
+  if (it == states_.end())
+  {
+    return false;
+  }
+  handle = StateHandle(it->second);
+  return true;
+}
+
+bool HandleResolver::resolve_command(const std::string & name, CommandHandle & handle) const
+{
+  const auto it = commands_.find(name);
+  if (it == commands_.end())
+  {
+    return false;
+  }
+  handle = CommandHandle(it->second);
+  return true;
+}
+
+}  // namespace ros2_control_demo_utils
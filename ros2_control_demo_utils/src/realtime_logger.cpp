@@ -0,0 +1,318 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ros2_control_demo_utils/realtime_logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "rclcpp/logging.hpp"
+
+namespace ros2_control_demo_utils
+{
+namespace
+{
+/// Appends one conversion, \p spec is e.g. "%.2f", with \p arg converted to what it expects.
+void format_arg(std::string & out, const std::string & spec, const LogArg * arg)
+{
+  char buffer[128];
+  int length = 0;
+  const char conversion = spec.back();
+  if (arg == nullptr)
+  {
+    out += "<missing>";
+    return;
+  }
+
+  auto as_double = [arg]()
+  {
+    return arg->type == LogArg::Type::FLOATING ? arg->floating
+                                                : static_cast<double>(arg->integer);
+  };
+  auto as_integer = [arg]()
+  {
+    return arg->type == LogArg::Type::INTEGER ? static_cast<long long>(arg->integer)
+                                               : static_cast<long long>(arg->floating);
+  };
+
+  // replace length modifiers of the original format by the type the value is stored as
+  std::string flags = spec.substr(0, spec.find_first_of("hlLzjt", 1));
+  flags = flags.substr(0, std::min(flags.size(), spec.size() - 1));
+  switch (conversion)
+  {
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+      length =
+        std::snprintf(buffer, sizeof(buffer), (flags + conversion).c_str(), as_double());
+      break;
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'x':
+    case 'X':
+      length =
+        std::snprintf(buffer, sizeof(buffer), (flags + "ll" + conversion).c_str(), as_integer());
+      break;
+    case 's':
+      if (arg->type == LogArg::Type::STRING)
+      {
+        out += arg->string != nullptr ? arg->string : "(null)";
+        return;
+      }
+      length = std::snprintf(buffer, sizeof(buffer), "%g", as_double());
+      break;
+    default:
+      out += spec;
+      return;
+  }
+  const int max_length = static_cast<int>(sizeof(buffer)) - 1;
+  out.append(buffer, static_cast<size_t>(std::clamp(length, 0, max_length)));
+}
+
+/// Thread that formats the records of all attached loggers.
+class LogDrain
+{
+public:
+  static LogDrain & instance()
+  {
+    static LogDrain drain;
+    return drain;
+  }
+
+  ~LogDrain()
+  {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable())
+    {
+      thread_.join();
+    }
+  }
+
+  void attach(RealtimeLogger * logger)
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    loggers_.push_back(logger);
+    if (!thread_.joinable())
+    {
+      stop_ = false;
+      thread_ = std::thread([this]() { run(); });
+    }
+  }
+
+  void detach(RealtimeLogger * logger)
+  {
+    std::thread thread;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      loggers_.erase(std::remove(loggers_.begin(), loggers_.end(), logger), loggers_.end());
+      if (!loggers_.empty())
+      {
+        return;
+      }
+      // stop with the last logger, the code of the thread may be unloaded with the plugin
+      stop_ = true;
+      thread = std::move(thread_);
+    }
+    wake_.notify_all();
+    if (thread.joinable())
+    {
+      thread.join();
+    }
+  }
+
+private:
+  void run()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_)
+    {
+      for (auto * logger : loggers_)
+      {
+        logger->drain();
+      }
+      wake_.wait_for(lock, std::chrono::milliseconds(20), [this]() { return stop_; });
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::vector<RealtimeLogger *> loggers_;
+  std::thread thread_;
+  bool stop_ = false;
+};
+}  // namespace
+
+std::string format_record(const LogRecord & record)
+{
+  std::string out;
+  for (size_t s = 0; s < record.num_segments; s++)
+  {
+    const auto & segment = record.segments[s];
+    size_t next_arg = 0;
+    for (const char * c = segment.format; *c != '\0'; c++)
+    {
+      if (*c != '%')
+      {
+        out.push_back(*c);
+        continue;
+      }
+      if (c[1] == '%')
+      {
+        out.push_back('%');
+        c++;
+        continue;
+      }
+
+      // a conversion runs up to its conversion character
+      const char * end = c + 1;
+      while (*end != '\0' && std::strchr("diuxXfFeEgGs", *end) == nullptr)
+      {
+        end++;
+      }
+      if (*end == '\0')
+      {
+        out.append(c);
+        break;
+      }
+      const LogArg * arg = next_arg < segment.num_args ? &segment.args[next_arg++] : nullptr;
+      format_arg(out, std::string(c, end + 1), arg);
+      c = end;
+    }
+  }
+  if (record.truncated)
+  {
+    out += " [truncated]";
+  }
+  return out;
+}
+
+RealtimeLogger::RecordBuilder::RecordBuilder(RecordBuilder && other) noexcept
+: logger_(other.logger_), record_(other.record_)
+{
+  other.record_ = nullptr;
+}
+
+RealtimeLogger::RecordBuilder::~RecordBuilder()
+{
+  if (record_ != nullptr)
+  {
+    logger_->commit();
+  }
+}
+
+RealtimeLogger::~RealtimeLogger()
+{
+  detach();
+  drain();
+}
+
+void RealtimeLogger::configure(const rclcpp::Logger & logger, size_t capacity)
+{
+  detach();
+  drain();
+  logger_ = logger;
+  ring_.resize(std::max<size_t>(capacity, 1));
+  write_.store(0, std::memory_order_relaxed);
+  read_.store(0, std::memory_order_relaxed);
+  LogDrain::instance().attach(this);
+  attached_ = true;
+}
+
+RealtimeLogger::RecordBuilder RealtimeLogger::record(LogSeverity severity)
+{
+  const size_t write = write_.load(std::memory_order_relaxed);
+  if (ring_.empty() || write - read_.load(std::memory_order_acquire) >= ring_.size())
+  {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return RecordBuilder(this, nullptr);
+  }
+
+  LogRecord & record = ring_[write % ring_.size()];
+  record.severity = severity;
+  record.num_segments = 0;
+  record.truncated = false;
+  return RecordBuilder(this, &record);
+}
+
+void RealtimeLogger::commit()
+{
+  write_.store(write_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void RealtimeLogger::drain()
+{
+  size_t read = read_.load(std::memory_order_relaxed);
+  const size_t write = write_.load(std::memory_order_acquire);
+  for (; read != write; read++)
+  {
+    const LogRecord & record = ring_[read % ring_.size()];
+    const std::string message = format_record(record);
+    switch (record.severity)
+    {
+      case LogSeverity::DEBUG:
+        RCLCPP_DEBUG(logger_, "%s", message.c_str());
+        break;
+      case LogSeverity::INFO:
+        RCLCPP_INFO(logger_, "%s", message.c_str());
+        break;
+      case LogSeverity::WARN:
+        RCLCPP_WARN(logger_, "%s", message.c_str());
+        break;
+      case LogSeverity::ERROR:
+        RCLCPP_ERROR(logger_, "%s", message.c_str());
+        break;
+      case LogSeverity::FATAL:
+        RCLCPP_FATAL(logger_, "%s", message.c_str());
+        break;
+    }
+    // release the slot only after formatting, the producer overwrites it afterwards
+    read_.store(read + 1, std::memory_order_release);
+  }
+
+  const size_t dropped = dropped_.load(std::memory_order_relaxed);
+  if (dropped != reported_dropped_)
+  {
+    RCLCPP_WARN(
+      logger_, "Dropped %zu realtime log records, the ring is full.", dropped - reported_dropped_);
+    reported_dropped_ = dropped;
+  }
+}
+
+void RealtimeLogger::detach()
+{
+  if (attached_)
+  {
+    LogDrain::instance().detach(this);
+    attached_ = false;
+  }
+}
+
+}  // namespace ros2_control_demo_utils
@@ -0,0 +1,110 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ros2_control_demo_utils/sensor_noise.hpp"
+
+#include <cmath>
+
+namespace ros2_control_demo_utils
+{
+namespace
+{
+constexpr double TWO_PI = 6.283185307179586;
+
+/// Finalizer of SplitMix64, a bijection that mixes all bits of \p x.
+uint64_t mix(uint64_t x)
+{
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/// Two uniform numbers in (0, 1) per channel from 31 bits of the hash each, so the logarithm of
+/// them is finite and the conversion to double is a signed one that vectorizes.
+void uniform_pairs(size_t n, uint64_t key, double * __restrict first, double * __restrict second)
+{
+  for (size_t i = 0; i < n; i++)
+  {
+    const uint64_t bits = mix(key + 0x9e3779b97f4a7c15ULL * (i + 1));
+    first[i] = (static_cast<double>(static_cast<int32_t>(bits >> 33)) + 0.5) * 0x1p-31;
+    second[i] = (static_cast<double>(static_cast<int32_t>(bits & 0x7fffffffULL)) + 0.5) * 0x1p-31;
+  }
+}
+
+/// Turns the uniform pairs into two independent standard normal samples with Box-Muller.
+void box_muller(size_t n, double * __restrict first, double * __restrict second)
+{
+  for (size_t i = 0; i < n; i++)
+  {
+    const double radius = std::sqrt(-2.0 * std::log(first[i]));
+    const double angle = TWO_PI * second[i];
+    first[i] = radius * std::cos(angle);
+    second[i] = radius * std::sin(angle);
+  }
+}
+
+void add_noise(
+  size_t n, double sqrt_dt, const double * __restrict stddev,
+  const double * __restrict bias_drift, const double * __restrict white_noise,
+  const double * __restrict drift_noise, double * __restrict bias, double * __restrict values)
+{
+  for (size_t i = 0; i < n; i++)
+  {
+    bias[i] += bias_drift[i] * sqrt_dt * drift_noise[i];
+    values[i] += bias[i] + stddev[i] * white_noise[i];
+  }
+}
+}  // namespace
+
+void SensorNoise::configure(size_t num_channels, uint64_t seed)
+{
+  seed_ = seed;
+  counter_ = 0;
+  stddevs_.assign(num_channels, 0.0);
+  bias_drifts_.assign(num_channels, 0.0);
+  resolutions_.assign(num_channels, 0.0);
+  biases_.assign(num_channels, 0.0);
+  white_noise_.assign(num_channels, 0.0);
+  drift_noise_.assign(num_channels, 0.0);
+}
+
+void SensorNoise::set_model(size_t channel, const NoiseModel & model)
+{
+  stddevs_[channel] = model.stddev;
+  bias_drifts_[channel] = model.bias_drift;
+  resolutions_[channel] = model.resolution;
+  biases_[channel] = 0.0;
+}
+
+void SensorNoise::apply(double * values, double dt)
+{
+  const size_t n = size();
+  // a different key for every batch, the channel is added to it in uniform_pairs()
+  const uint64_t key = mix(seed_ ^ mix(++counter_));
+  uniform_pairs(n, key, white_noise_.data(), drift_noise_.data());
+  box_muller(n, white_noise_.data(), drift_noise_.data());
+  add_noise(
+    n, std::sqrt(dt), stddevs_.data(), bias_drifts_.data(), white_noise_.data(),
+    drift_noise_.data(), biases_.data(), values);
+
+  for (size_t i = 0; i < n; i++)
+  {
+    if (resolutions_[i] > 0.0)
+    {
+      values[i] = std::round(values[i] / resolutions_[i]) * resolutions_[i];
+    }
+  }
+}
+
+}  // namespace ros2_control_demo_utils
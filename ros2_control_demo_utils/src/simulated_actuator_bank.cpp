@@ -0,0 +1,90 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ros2_control_demo_utils/simulated_actuator_bank.hpp"
+
+namespace ros2_control_demo_utils
+{
+namespace
+{
+// restrict tells the compiler that the arrays don't overlap, so the loop is vectorized without
+// checking that at runtime
+void step_actuators(
+  size_t n, double h, const double * __restrict command, const double * __restrict lag_gain,
+  const double * __restrict velocity_select, const double * __restrict acceleration_select,
+  const double * __restrict integrate_select, double * __restrict position,
+  double * __restrict velocity, double * __restrict acceleration)
+{
+  for (size_t i = 0; i < n; i++)
+  {
+    const double a = acceleration_select[i] * command[i];
+    const double v =
+      velocity_select[i] * command[i] + acceleration_select[i] * (velocity[i] + a * h);
+    position[i] += lag_gain[i] * (command[i] - position[i]) + integrate_select[i] * v * h;
+    velocity[i] = v;
+    acceleration[i] = a;
+  }
+}
+}  // namespace
+
+void SimulatedActuatorBank::resize(size_t num_joints, double slowdown, ActuatorModel model)
+{
+  slowdown_ = slowdown;
+  commands_.assign(num_joints, 0.0);
+  positions_.assign(num_joints, 0.0);
+  velocities_.assign(num_joints, 0.0);
+  accelerations_.assign(num_joints, 0.0);
+  lag_gains_.resize(num_joints);
+  velocity_selects_.resize(num_joints);
+  acceleration_selects_.resize(num_joints);
+  integrate_selects_.resize(num_joints);
+  for (size_t i = 0; i < num_joints; i++)
+  {
+    set_model(i, model);
+  }
+}
+
+void SimulatedActuatorBank::set_model(size_t joint, ActuatorModel model)
+{
+  lag_gains_[joint] = model == ActuatorModel::POSITION ? 1.0 / slowdown_ : 0.0;
+  velocity_selects_[joint] = model == ActuatorModel::VELOCITY ? 1.0 : 0.0;
+  acceleration_selects_[joint] = model == ActuatorModel::ACCELERATION ? 1.0 : 0.0;
+  integrate_selects_[joint] = model == ActuatorModel::POSITION ? 0.0 : 1.0;
+}
+
+void SimulatedActuatorBank::step(double period)
+{
+  step_actuators(
+    commands_.size(), period / slowdown_, commands_.data(), lag_gains_.data(),
+    velocity_selects_.data(), acceleration_selects_.data(), integrate_selects_.data(),
+    positions_.data(), velocities_.data(), accelerations_.data());
+}
+
+void SimulatedActuatorBank::read_commands(const std::vector<CommandHandle> & handles)
+{
+  for (size_t i = 0; i < handles.size(); i++)
+  {
+    commands_[i] = handles[i].get();
+  }
+}
+
+void SimulatedActuatorBank::write_positions(std::vector<StateHandle> & handles) const
+{
+  for (size_t i = 0; i < handles.size(); i++)
+  {
+    handles[i].set(positions_[i]);
+  }
+}
+
+}  // namespace ros2_control_demo_utils
@@ -0,0 +1,102 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "hardware_interface/handle.hpp"
+#include "ros2_control_demo_utils/cycle_instrumentation.hpp"
+
+using ros2_control_demo_utils::CycleInstrumentation;
+using ros2_control_demo_utils::HandleResolver;
+using ros2_control_demo_utils::LatencyHistogram;
+
+TEST(TestLatencyHistogram, buckets_are_contiguous_and_precise)
+{
+  for (size_t index = 1; index < LatencyHistogram::NUM_BUCKETS; index++)
+  {
+    const uint64_t lower_bound = LatencyHistogram::bucket_upper_bound(index - 1) + 1;
+    const uint64_t upper_bound = LatencyHistogram::bucket_upper_bound(index);
+    EXPECT_EQ(LatencyHistogram::bucket_index(lower_bound), index);
+    EXPECT_EQ(LatencyHistogram::bucket_index(upper_bound), index);
+    EXPECT_LE(upper_bound - lower_bound, lower_bound / LatencyHistogram::SUB_BUCKETS);
+  }
+  EXPECT_EQ(LatencyHistogram::bucket_index(UINT64_MAX), LatencyHistogram::NUM_BUCKETS - 1);
+}
+
+TEST(TestLatencyHistogram, quantiles)
+{
+  LatencyHistogram histogram;
+  for (uint64_t value = 1; value <= 100000; value++)
+  {
+    histogram.record(value * 1000);
+  }
+  EXPECT_EQ(histogram.count(), 100000u);
+  EXPECT_EQ(histogram.min(), 1000u);
+  EXPECT_EQ(histogram.max(), 100000000u);
+
+  const double quantiles[] = {0.5, 0.99, 0.999, 1.0};
+  uint64_t values[4];
+  histogram.values_at_quantiles(quantiles, values, 4);
+  EXPECT_NEAR(values[0], 50000000.0, 50000000.0 / LatencyHistogram::SUB_BUCKETS);
+  EXPECT_NEAR(values[1], 99000000.0, 99000000.0 / LatencyHistogram::SUB_BUCKETS);
+  EXPECT_NEAR(values[2], 99900000.0, 99900000.0 / LatencyHistogram::SUB_BUCKETS);
+  EXPECT_EQ(values[3], histogram.max());
+
+  histogram.reset();
+  EXPECT_EQ(histogram.count(), 0u);
+  EXPECT_EQ(histogram.min(), 0u);
+}
+
+TEST(TestCycleInstrumentation, exports_statistics_as_state_interfaces)
+{
+  CycleInstrumentation instrumentation;
+  instrumentation.configure("rrbot", 1000.0);
+  EXPECT_DOUBLE_EQ(instrumentation.expected_period(), 0.001);
+
+  std::vector<hardware_interface::StateInterface::SharedPtr> states;
+  for (const auto & description : instrumentation.state_interface_descriptions())
+  {
+    states.push_back(std::make_shared<hardware_interface::StateInterface>(description));
+  }
+  ASSERT_EQ(states.size(), 12u);
+  EXPECT_EQ(states[0]->get_name(), "rrbot/read_duration_min");
+  EXPECT_EQ(states[11]->get_name(), "rrbot/period_jitter_p99_9");
+
+  HandleResolver resolver;
+  resolver.add_states(states);
+  ASSERT_TRUE(instrumentation.resolve_state_interfaces(resolver));
+
+  for (int cycle = 0; cycle < 3; cycle++)
+  {
+    {
+      const auto timer = instrumentation.time_read();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const auto timer = instrumentation.time_write();
+  }
+
+  const auto read = instrumentation.summary(CycleInstrumentation::READ_DURATION);
+  EXPECT_EQ(read.count, 3u);
+  EXPECT_GE(read.min, 0.001);
+  EXPECT_LE(read.min, read.max);
+  EXPECT_EQ(instrumentation.summary(CycleInstrumentation::WRITE_DURATION).count, 3u);
+  EXPECT_EQ(instrumentation.summary(CycleInstrumentation::PERIOD_JITTER).count, 2u);
+
+  // exported after the first write()
+  EXPECT_GE(states[0]->get_optional().value(), 0.001);
+}
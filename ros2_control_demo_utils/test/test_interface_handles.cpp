@@ -0,0 +1,71 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "hardware_interface/hardware_info.hpp"
+#include "ros2_control_demo_utils/interface_handles.hpp"
+
+using hardware_interface::CommandInterface;
+using hardware_interface::StateInterface;
+using ros2_control_demo_utils::CommandHandle;
+using ros2_control_demo_utils::HandleResolver;
+using ros2_control_demo_utils::StateHandle;
+
+namespace
+{
+template <typename InterfaceT>
+std::shared_ptr<InterfaceT> make_interface(const std::string & joint_name, double value)
+{
+  hardware_interface::InterfaceInfo info;
+  info.name = "position";
+  info.initial_value = std::to_string(value);
+  info.data_type = "double";
+  return std::make_shared<InterfaceT>(hardware_interface::InterfaceDescription(joint_name, info));
+}
+}  // namespace
+
+TEST(TestInterfaceHandles, resolves_exported_interfaces)
+{
+  const std::vector<StateInterface::SharedPtr> states = {
+    make_interface<StateInterface>("joint1", 1.0), make_interface<StateInterface>("joint2", 2.0)};
+  const std::vector<CommandInterface::SharedPtr> commands = {
+    make_interface<CommandInterface>("joint1", 3.0)};
+
+  HandleResolver resolver;
+  resolver.add_states(states);
+  resolver.add_commands(commands);
+
+  StateHandle state;
+  ASSERT_TRUE(resolver.resolve_state("joint2/position", state));
+  ASSERT_TRUE(state.valid());
+  EXPECT_EQ(state.name(), "joint2/position");
+  EXPECT_DOUBLE_EQ(state.get(), 2.0);
+
+  CommandHandle command;
+  ASSERT_TRUE(resolver.resolve_command("joint1/position", command));
+  EXPECT_DOUBLE_EQ(command.get(), 3.0);
+
+  // writes go to the exported interfaces
+  EXPECT_TRUE(state.set(command.get()));
+  EXPECT_DOUBLE_EQ(states[1]->get_optional().value(), 3.0);
+
+  // states and commands are separate even if their names are equal
+  EXPECT_FALSE(resolver.resolve_command("joint2/position", command));
+  EXPECT_FALSE(resolver.resolve_state("joint3/position", state));
+}
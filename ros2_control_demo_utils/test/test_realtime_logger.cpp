@@ -0,0 +1,73 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+#include "ros2_control_demo_utils/realtime_logger.hpp"
+
+using ros2_control_demo_utils::LogRecord;
+using ros2_control_demo_utils::LogSeverity;
+using ros2_control_demo_utils::LogThrottle;
+using ros2_control_demo_utils::RealtimeLogger;
+
+TEST(TestRealtimeLogger, formats_like_printf)
+{
+  LogRecord record;
+  const std::string joint = "joint1";
+  record.num_segments = 2;
+  record.segments[0] = {"Reading states:", 0, {}};
+  record.segments[1] = {"\n\t%.2f for joint '%s', %zu%% done", 3, {}};
+  record.segments[1].args[0].type = ros2_control_demo_utils::LogArg::Type::FLOATING;
+  record.segments[1].args[0].floating = 1.23456;
+  record.segments[1].args[1].type = ros2_control_demo_utils::LogArg::Type::STRING;
+  record.segments[1].args[1].string = joint.c_str();
+  record.segments[1].args[2].type = ros2_control_demo_utils::LogArg::Type::INTEGER;
+  record.segments[1].args[2].integer = 42;
+
+  EXPECT_EQ(
+    ros2_control_demo_utils::format_record(record),
+    "Reading states:\n\t1.23 for joint 'joint1', 42% done");
+}
+
+TEST(TestRealtimeLogger, throttle_decides_before_recording)
+{
+  using std::chrono::milliseconds;
+  LogThrottle throttle(milliseconds(500));
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(throttle.ready(start));
+  EXPECT_FALSE(throttle.ready(start + milliseconds(499)));
+  EXPECT_TRUE(throttle.ready(start + milliseconds(500)));
+}
+
+TEST(TestRealtimeLogger, drops_records_when_full)
+{
+  RealtimeLogger logger;
+  logger.configure(rclcpp::get_logger("test_realtime_logger"), 2);
+
+  // the drain thread may run in between, so only the lower bound of accepted records is known
+  size_t accepted = 0;
+  for (int i = 0; i < 100; i++)
+  {
+    if (auto record = logger.record(LogSeverity::DEBUG))
+    {
+      record.append("record %d", i);
+      accepted++;
+    }
+  }
+  EXPECT_GE(accepted, 2u);
+  EXPECT_EQ(accepted + logger.dropped(), 100u);
+}
@@ -0,0 +1,145 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "ros2_control_demo_utils/sensor_noise.hpp"
+
+using ros2_control_demo_utils::NoiseModel;
+using ros2_control_demo_utils::SensorNoise;
+
+namespace
+{
+constexpr double DT = 0.01;
+
+SensorNoise make_noise(uint64_t seed, const NoiseModel & model)
+{
+  SensorNoise noise;
+  noise.configure(SensorNoise::WRENCH_SIZE, seed);
+  for (size_t channel = 0; channel < noise.size(); channel++)
+  {
+    noise.set_model(channel, model);
+  }
+  return noise;
+}
+
+std::vector<double> measure(SensorNoise & noise, size_t batches)
+{
+  std::vector<double> measurements;
+  for (size_t batch = 0; batch < batches; batch++)
+  {
+    double values[SensorNoise::WRENCH_SIZE] = {};
+    noise.apply(values, DT);
+    measurements.insert(measurements.end(), values, values + SensorNoise::WRENCH_SIZE);
+  }
+  return measurements;
+}
+}  // namespace
+
+TEST(TestSensorNoise, perfect_sensor_keeps_values)
+{
+  auto noise = make_noise(1, NoiseModel{});
+  double values[SensorNoise::WRENCH_SIZE] = {1.0, -2.0, 3.0, 0.5, 0.0, -0.25};
+  noise.apply(values, DT);
+  EXPECT_DOUBLE_EQ(values[0], 1.0);
+  EXPECT_DOUBLE_EQ(values[1], -2.0);
+  EXPECT_DOUBLE_EQ(values[5], -0.25);
+}
+
+TEST(TestSensorNoise, same_seed_repeats_measurements)
+{
+  const NoiseModel model{0.1, 0.01, 0.0};
+  auto first = make_noise(42, model);
+  auto second = make_noise(42, model);
+  auto other = make_noise(43, model);
+
+  const auto measurements = measure(first, 100);
+  EXPECT_EQ(measurements, measure(second, 100));
+  EXPECT_NE(measurements, measure(other, 100));
+
+  // configure() restarts the sequence
+  first.configure(SensorNoise::WRENCH_SIZE, 42);
+  for (size_t channel = 0; channel < first.size(); channel++)
+  {
+    first.set_model(channel, model);
+  }
+  EXPECT_EQ(measurements, measure(first, 100));
+}
+
+TEST(TestSensorNoise, white_noise_has_model_statistics)
+{
+  constexpr double STDDEV = 0.5;
+  auto noise = make_noise(7, NoiseModel{STDDEV, 0.0, 0.0});
+  const auto measurements = measure(noise, 20000);
+
+  double sum = 0.0;
+  double sum_of_squares = 0.0;
+  for (const double value : measurements)
+  {
+    sum += value;
+    sum_of_squares += value * value;
+  }
+  const double count = static_cast<double>(measurements.size());
+  const double mean = sum / count;
+  EXPECT_NEAR(mean, 0.0, 0.02);
+  EXPECT_NEAR(std::sqrt(sum_of_squares / count - mean * mean), STDDEV, 0.02);
+
+  // consecutive samples of a channel are uncorrelated
+  double correlation = 0.0;
+  for (size_t i = SensorNoise::WRENCH_SIZE; i < measurements.size(); i++)
+  {
+    correlation += measurements[i] * measurements[i - SensorNoise::WRENCH_SIZE];
+  }
+  EXPECT_NEAR(correlation / count / (STDDEV * STDDEV), 0.0, 0.05);
+}
+
+TEST(TestSensorNoise, bias_drifts_as_random_walk)
+{
+  constexpr double BIAS_DRIFT = 0.2;
+  constexpr size_t BATCHES = 10000;  // 100 s
+  auto noise = make_noise(3, NoiseModel{0.0, BIAS_DRIFT, 0.0});
+  const auto measurements = measure(noise, BATCHES);
+
+  // without white noise the measurement is the bias
+  for (size_t channel = 0; channel < SensorNoise::WRENCH_SIZE; channel++)
+  {
+    EXPECT_DOUBLE_EQ(
+      measurements[(BATCHES - 1) * SensorNoise::WRENCH_SIZE + channel], noise.biases()[channel]);
+  }
+  // after 100 s the stddev of the bias is 2.0, every channel staying below 5 sigma is certain
+  bool drifted = false;
+  for (size_t channel = 0; channel < SensorNoise::WRENCH_SIZE; channel++)
+  {
+    EXPECT_LT(std::abs(noise.biases()[channel]), 5 * BIAS_DRIFT * 10.0);
+    drifted = drifted || std::abs(noise.biases()[channel]) > 0.01;
+  }
+  EXPECT_TRUE(drifted);
+
+  noise.set_model(0, NoiseModel{0.0, BIAS_DRIFT, 0.0});
+  EXPECT_DOUBLE_EQ(noise.biases()[0], 0.0);
+}
+
+TEST(TestSensorNoise, quantizes_to_resolution)
+{
+  constexpr double RESOLUTION = 0.05;
+  auto noise = make_noise(11, NoiseModel{0.3, 0.0, RESOLUTION});
+  for (const double value : measure(noise, 100))
+  {
+    const double steps = value / RESOLUTION;
+    EXPECT_NEAR(steps, std::round(steps), 1e-9);
+  }
+}
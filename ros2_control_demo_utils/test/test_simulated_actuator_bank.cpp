@@ -0,0 +1,75 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "ros2_control_demo_utils/simulated_actuator_bank.hpp"
+
+using ros2_control_demo_utils::ActuatorModel;
+using ros2_control_demo_utils::SimulatedActuatorBank;
+
+namespace
+{
+constexpr double SLOWDOWN = 50.0;
+constexpr double PERIOD = 0.01;
+}  // namespace
+
+// the expected values are the per-joint updates of example_3
+TEST(TestSimulatedActuatorBank, steps_each_model)
+{
+  SimulatedActuatorBank bank;
+  bank.resize(3, SLOWDOWN);
+  bank.set_model(1, ActuatorModel::VELOCITY);
+  bank.set_model(2, ActuatorModel::ACCELERATION);
+  bank.commands()[0] = 1.0;
+  bank.commands()[1] = 2.0;
+  bank.commands()[2] = 3.0;
+
+  double position[3] = {0.0, 0.0, 0.0};
+  double velocity[3] = {0.0, 0.0, 0.0};
+  for (int cycle = 0; cycle < 10; cycle++)
+  {
+    bank.step(PERIOD);
+
+    position[0] += (1.0 - position[0]) / SLOWDOWN;
+    velocity[1] = 2.0;
+    position[1] += velocity[1] * PERIOD / SLOWDOWN;
+    velocity[2] += 3.0 * PERIOD / SLOWDOWN;
+    position[2] += velocity[2] * PERIOD / SLOWDOWN;
+
+    for (size_t i = 0; i < 3; i++)
+    {
+      EXPECT_DOUBLE_EQ(bank.positions()[i], position[i]) << "joint " << i;
+      EXPECT_DOUBLE_EQ(bank.velocities()[i], velocity[i]) << "joint " << i;
+    }
+  }
+  EXPECT_DOUBLE_EQ(bank.accelerations()[0], 0.0);
+  EXPECT_DOUBLE_EQ(bank.accelerations()[1], 0.0);
+  EXPECT_DOUBLE_EQ(bank.accelerations()[2], 3.0);
+}
+
+TEST(TestSimulatedActuatorBank, keeps_state_when_model_changes)
+{
+  SimulatedActuatorBank bank;
+  bank.resize(1, SLOWDOWN, ActuatorModel::VELOCITY);
+  bank.commands()[0] = 5.0;
+  bank.step(PERIOD);
+  const double position = bank.positions()[0];
+
+  bank.set_model(0, ActuatorModel::POSITION);
+  bank.commands()[0] = position;
+  bank.step(PERIOD);
+  EXPECT_DOUBLE_EQ(bank.positions()[0], position);
+  EXPECT_DOUBLE_EQ(bank.velocities()[0], 0.0);
+}
@@ -0,0 +1,121 @@
+// Copyright 2023 ros2_control Development Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+#include "ros2_control_demo_utils/spsc_ring.hpp"
+
+using ros2_control_demo_utils::SpscRing;
+
+TEST(TestSpscRing, pops_in_order)
+{
+  SpscRing<int> ring(3);
+  EXPECT_EQ(ring.capacity(), 3u);
+  EXPECT_TRUE(ring.empty());
+
+  int value = 0;
+  EXPECT_FALSE(ring.pop(value));
+  EXPECT_TRUE(ring.push(1));
+  EXPECT_TRUE(ring.push(2));
+  EXPECT_EQ(ring.size(), 2u);
+  EXPECT_TRUE(ring.pop(value));
+  EXPECT_EQ(value, 1);
+
+  // wraps around the end of the storage
+  EXPECT_TRUE(ring.push(3));
+  EXPECT_TRUE(ring.push(4));
+  for (int expected = 2; expected <= 4; expected++)
+  {
+    EXPECT_TRUE(ring.pop(value));
+    EXPECT_EQ(value, expected);
+  }
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST(TestSpscRing, drops_when_full)
+{
+  SpscRing<int> ring(3);
+  EXPECT_TRUE(ring.push(1));
+  EXPECT_TRUE(ring.push(2));
+  EXPECT_TRUE(ring.push(3));
+  EXPECT_FALSE(ring.push(5));
+  EXPECT_EQ(ring.dropped(), 1u);
+
+  // the elements in the ring are kept
+  int value = 0;
+  EXPECT_TRUE(ring.pop(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_TRUE(ring.push(4));
+  for (int expected = 2; expected <= 4; expected++)
+  {
+    EXPECT_TRUE(ring.pop(value));
+    EXPECT_EQ(value, expected);
+  }
+}
+
+TEST(TestSpscRing, passes_every_element_between_threads)
+{
+  struct Sample
+  {
+    uint64_t sequence;
+    uint64_t check;
+  };
+  constexpr uint64_t COUNT = 200000;
+  SpscRing<Sample> ring(64);
+
+  // set if the consumer gives up, so that the producer never waits for a full ring forever
+  std::atomic<bool> stop{false};
+
+  std::thread producer(
+    [&ring, &stop]()
+    {
+      for (uint64_t i = 0; i < COUNT; i++)
+      {
+        while (!ring.push({i, ~i}))
+        {
+          if (stop)
+          {
+            return;
+          }
+          std::this_thread::yield();
+        }
+      }
+    });
+
+  uint64_t expected = 0;
+  Sample sample;
+  while (expected < COUNT)
+  {
+    if (!ring.pop(sample))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    // neither lost nor reordered nor torn; no ASSERT here, the producer has to be joined
+    EXPECT_EQ(sample.sequence, expected);
+    EXPECT_EQ(sample.check, ~expected);
+    if (sample.sequence != expected || sample.check != ~expected)
+    {
+      break;
+    }
+    expected++;
+  }
+  stop = true;
+  producer.join();
+  EXPECT_EQ(expected, COUNT);
+  EXPECT_TRUE(ring.empty());
+}